@@ -0,0 +1,127 @@
+#pragma once
+
+#include "util/LRUCache.h"
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <string>
+#include <vector>
+
+struct lua_State;
+struct Proto;
+union TString;
+
+namespace RBX { namespace Lua {
+
+	// Process-wide cache of compiled chunks, so identical scripts (every character's Animate script,
+	// every copy of a tool) are parsed once per process instead of once per instance and DataModel.
+	// Prototypes belong to the lua_State that made them, so the cache keeps a state-independent copy
+	// and builds a fresh prototype in the loading state on a hit. Bounded by DFInt::LuaCompileCacheSizeKB.
+	class CompileCache : boost::noncopyable
+	{
+	public:
+		static CompileCache& singleton();
+
+		static bool isEnabled();
+
+		explicit CompileCache(size_t maxBytes);
+
+		// On a hit pushes a closure for source onto L (or an error message) and sets status like lua_load
+		bool load(lua_State* L, const std::string& source, const char* chunkname, int& status);
+
+		// Remembers the function on top of L's stack, just loaded from source
+		void store(lua_State* L, const std::string& source);
+
+		void setCapacity(size_t maxBytes);
+		void clear();
+
+		size_t getHits() const { return hits; }
+		size_t getMisses() const { return misses; }
+		size_t getEntries();
+		size_t getBytes();
+
+	private:
+		struct Constant
+		{
+			int type;
+			double number;
+			int string;		// index into Chunk::strings
+		};
+
+		struct LocalVariable
+		{
+			int startpc;
+			int endpc;
+			int name;
+		};
+
+		struct Function
+		{
+			std::vector<unsigned int> code;
+			std::vector<int> lineInfo;
+			std::vector<Constant> constants;
+			std::vector<LocalVariable> localVariables;
+			std::vector<int> upvalues;
+			std::vector<int> children;	// indices into Chunk::functions
+
+			int lineDefined;
+			int lastLineDefined;
+			unsigned char nups;
+			unsigned char numParams;
+			unsigned char isVararg;
+			unsigned char maxStackSize;
+		};
+
+		struct Chunk
+		{
+			std::string source;			// guards against hash collisions
+			std::vector<std::string> strings;
+			std::vector<Function> functions;	// [0] is the main function
+		};
+
+		struct Key
+		{
+			size_t sourceHash;
+			size_t sourceSize;
+			unsigned int vmKey;
+
+			bool operator==(const Key& other) const
+			{
+				return sourceHash == other.sourceHash && sourceSize == other.sourceSize && vmKey == other.vmKey;
+			}
+
+			friend size_t hash_value(const Key& key)
+			{
+				return key.sourceHash ^ (key.vmKey * 2654435761u);
+			}
+		};
+
+		typedef MemEnforcedLRUCache<Key, boost::shared_ptr<const Chunk> > Cache;
+
+		boost::mutex mutex;
+		Cache cache;
+		size_t capacity;
+		size_t hits;
+		size_t misses;
+
+		static Key makeKey(lua_State* L, const std::string& source);
+
+		typedef boost::unordered_map<const TString*, int> StringIndex;
+
+		static int capture(Chunk& chunk, StringIndex& stringIndex, const Proto* p);
+		static int captureString(Chunk& chunk, StringIndex& stringIndex, const TString* string);
+		static size_t sizeOf(const Chunk& chunk);
+		struct InstantiateData
+		{
+			const Chunk* chunk;
+			const char* chunkname;
+		};
+
+		static Proto* instantiate(lua_State* L, const Chunk& chunk, int index, const std::vector<TString*>& strings, TString* source);
+		static void instantiateMain(lua_State* L, void* ud);
+	};
+
+}}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "reflection/Object.h"
+
+#include <boost/noncopyable.hpp>
+
+namespace RBX { namespace Lua {
+
+	// Remembers what a member name resolves to on a class for the Instance __index and
+	// __newindex metamethods, so a hot "part.Position" costs one probe instead of one
+	// per member container. Names come from lua_tostring, so repeated accesses pass the
+	// same interned string pointer; the slot is picked from that pointer and confirmed
+	// with a string compare, which keeps it correct if Lua reuses the string's memory.
+	// Not thread safe, each ScriptContext owns one.
+	class MemberLookupCache : boost::noncopyable
+	{
+	public:
+		enum Kind
+		{
+			Kind_None = 0,		// Not a property, function or event, might be a child
+			Kind_Property,
+			Kind_YieldFunction,
+			Kind_Function,
+			Kind_Event,
+		};
+
+		struct Entry
+		{
+			const Reflection::ClassDescriptor* classDescriptor;
+			const char* namePointer;
+			char name[32];
+
+			// What __index finds first, in the order Bridge::on_index searches
+			Kind kind;
+			Reflection::MemberDescriptor* member;
+
+			// What __newindex can assign to
+			Reflection::PropertyDescriptor* property;
+			Reflection::CallbackDescriptor* callback;
+		};
+
+		MemberLookupCache();
+
+		// Never returns NULL
+		const Entry& lookup(const Reflection::ClassDescriptor& classDescriptor, const char* name);
+
+		size_t getHits() const { return hits; }
+		size_t getMisses() const { return misses; }
+
+	private:
+		enum { kEntryCount = 1024 };
+
+		Entry entries[kEntryCount];
+		Entry uncached;
+		size_t hits;
+		size_t misses;
+
+		static void resolve(Entry& entry, const Reflection::ClassDescriptor& classDescriptor, const char* name);
+	};
+
+}}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "rbx/rbxTime.h"
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <string>
+
+struct lua_State;
+
+namespace RBX { namespace Lua {
+
+	// Sampling profiler for Lua call stacks. Driven by the instruction count hook every script thread
+	// already has (ScriptContext::hookCount), so an idle profiler costs one clock read per hook and a
+	// sample is only taken once the sampling interval has passed. Samples are aggregated by stack into
+	// the folded format flamegraph tools read: "root;...;leaf count" per line, frames as "name (source:line)".
+	// Time spent inside a single long C call is not visible, as the hook only runs between instructions.
+	class SampleProfiler : boost::noncopyable
+	{
+	public:
+		// frequency is in samples per second
+		explicit SampleProfiler(int frequency);
+
+		void hook(lua_State* L)
+		{
+			const Time now = Time::nowFast();
+			if (now >= nextSample)
+				sample(L, now);
+		}
+
+		void sample(lua_State* L, const Time& now);
+
+		std::string getFoldedStacks() const;
+
+		size_t getSampleCount() const { return sampleCount; }
+		size_t getStackCount() const { return stacks.size(); }
+
+	private:
+		typedef boost::unordered_map<std::string, unsigned int> Stacks;
+
+		Time::Interval interval;
+		Time nextSample;
+		size_t sampleCount;
+		Stacks stacks;
+
+		static void appendFrame(std::string& stack, lua_State* L, int level);
+	};
+
+}}
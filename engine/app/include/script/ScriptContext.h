@@ -37,6 +37,8 @@ namespace RBX
 	{
 		class YieldingThreads;
 		class WeakFunctionRef;
+		class MemberLookupCache;
+		class SampleProfiler;
 	}
 	namespace Network
 	{
@@ -140,6 +142,8 @@ namespace RBX
 		shared_ptr<RunService> runService;
 
 		boost::scoped_ptr<Lua::YieldingThreads> yieldEvent;		// collects all threads that have yielded, and periodically resumes them
+		boost::scoped_ptr<Lua::MemberLookupCache> memberLookupCache;	// NULL unless DFFlag::LuaMemberLookupCache was on at creation
+		boost::scoped_ptr<Lua::SampleProfiler> sampleProfiler;		// NULL unless StartScriptProfiling was called
 
 		struct WaitingThread
 		{
@@ -201,6 +205,8 @@ namespace RBX
 		ScriptContext();
 		virtual ~ScriptContext();
 
+		Lua::MemberLookupCache* getMemberLookupCache() { return memberLookupCache.get(); }
+
 		///////////////////////////////////////////////////
 		// IScriptFilter
 		/*override*/ virtual bool scriptShouldRun(BaseScript* script);
@@ -215,6 +221,8 @@ namespace RBX
 		static Reflection::BoundProp<int> propLuaGcStepSize;
 		void setTimeout(double seconds);
 		void setCollectScriptStats(bool);
+		void startScriptProfiling(int frequency);
+		std::string stopScriptProfiling();	// returns the samples as folded stacks
 		// Core & Starter Scripts
 		void addStarterScript(int assetId);
 		void addCoreScript(int assetId, shared_ptr<Instance> parent, std::string name);
@@ -7,7 +7,10 @@
 #include "boost/shared_ptr.hpp"
 #include "lua/LuaBridge.h"
 #include "script/ThreadRef.h"
+#include "util/TimerWheel.h"
+#include "rbx/RunningAverage.h"
 #include <boost/thread/mutex.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <vector>
 
@@ -48,6 +51,18 @@ namespace RBX {
 		// Lua refs to threads that are waiting on the event
 		WaitThreadRefs waitingThreads;
 
+		// Used instead of waitingThreads when DFFlag::LuaWaitTimerWheel was on at creation.
+		// Threads that came due but were not resumed yet (throttling) wait in readyThreads.
+		typedef TimerWheel<WaitingThread> WaitTimerWheel;
+		boost::scoped_ptr<WaitTimerWheel> timerWheel;
+		WaitTimerWheel::Entries readyThreads;
+		size_t readyThreadsHead;
+
+		// How late threads resume relative to the time they asked for, in seconds
+		RunningAverage<double> resumeLag;
+
+		bool resumeThread(const WaitingThread& w, double wallTime, Time expirationTime, bool& throttling);
+
 	public:
 		YieldingThreads(ScriptContext* context);
 
@@ -58,6 +73,7 @@ namespace RBX {
 		void resume(double wallTime, Time expirationTime, bool& throttling);
 
 		std::size_t waiterCount() const;
+		double averageResumeLag() const { return resumeLag.value(); }
 
 	private:
 		friend class ScriptContext;
@@ -44,6 +44,9 @@ class LuaStatsItem : public Stats::Item
 	Stats::Item* averageGcTime;
 	Stats::Item* resumedThreads;
 	Stats::Item* deferredThreads;
+	Stats::Item* waitingThreads;
+	Stats::Item* waitResumeLag;
+	Stats::Item* profilerSamples;
 
 public:
 	LuaStatsItem(ScriptContext* context) : scriptContext(context)
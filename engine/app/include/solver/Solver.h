@@ -18,6 +18,7 @@ namespace RBX
 
 class ContactConnector;
 class RotateJoint;
+class WorkStealingPool;
 class ContactManifold;
 class Body;
 
@@ -91,10 +92,15 @@ public:
     void dumpLog( bool enable );
     void setUserId( int id ) { userId = id; }
 
+    // Islands are solved on up to threadCount threads of the pool (the calling thread included).
+    // The pool is owned by the caller, NULL solves everything on the calling thread.
+    void setWorkerPool( WorkStealingPool* pool, int threadCount ) { workerPool = pool; workerThreadCount = threadCount; }
+
 private:
     void solveInternal( const std::vector< ContactConnector* >& connectors, float dt, boost::uint64_t debugTime, bool throttled, const SolverConfig& _solverConfig );
     void solveIsland( const ArrayDynamic< Constraint* >& constraints, const ArrayDynamic< SimBody* >& selectedSimBodies,
-        float _dt, const SolverConfig& _solverConfig );
+        float _dt, const SolverConfig& _solverConfig, WorkStealingPool* _batchPool );
+    bool canSolveIslandsInParallel( const SolverConfig& _solverConfig ) const;
     ContactManifold* updateContactManifold( const BodyUIDPair& _pairId, const ArrayBase< OrderedConnector >& _manifold );
     size_t addContactConnectors( ArrayDynamic< ContactManifold* >& _activeManifolds, const std::vector< ContactConnector* >& _connectors, const boost::unordered_set< SimBody* >& _simBodies );
     void initAnchoredObjects( 
@@ -188,6 +194,9 @@ private:
 
     bool dumpLogSwitch;
     int userId;
+
+    WorkStealingPool* workerPool;
+    int workerThreadCount;
 };
 
 }
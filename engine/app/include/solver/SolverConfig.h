@@ -149,6 +149,11 @@ public:
     //
     bool useSimIslands;
 
+    //
+    // Solve independent collisions four at a time, one per SIMD lane (batched kernel only)
+    //
+    bool simdCollisionLanes;
+
     //
     // Conflicting constraints detector
     //
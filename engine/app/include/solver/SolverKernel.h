@@ -15,6 +15,7 @@ class ConstraintVariables;
 class VirtualDisplacementArray;
 class VirtualDisplacementArray;
 class EffectiveMassPair;
+class WorkStealingPool;
 
 void PGSComputeEffectiveMasses( 
     EffectiveMassPair* _effectiveMassesVelStage,
@@ -76,6 +77,31 @@ void PGSSolveKernel(
     const EffectiveMassPair* _effectiveMassesPosStage,
     const SolverConfig& _config );
 
+// Same iteration as PGSSolveKernel, but visits the constraints batch by batch in the order given by _batchedConstraints.
+// The constraints of an independent batch share no body, so they can be updated in any order: the batch is split
+// across the threads of _pool when one is provided, and the result does not depend on the number of threads.
+// _batchEnds holds one past the last entry of each batch in _batchedConstraints.
+void PGSSolveKernelBatched(
+    ConstraintVariables* __restrict _velStage,
+    ConstraintVariables* __restrict _posStage,
+    VirtualDisplacementArray& _virDVel,
+    VirtualDisplacementArray& _virDPos,
+    size_t _pureConstraintCount,
+    const boost::uint8_t* _dimensions, 
+    const boost::uint32_t* _offsets,
+    const BodyPairIndices* _pairs,
+    const boost::uint32_t* _batchedConstraints,
+    const boost::uint32_t* _batchEnds,
+    const boost::uint8_t* _batchIndependent,
+    size_t _batchCount,
+    const ConstraintJacobianPair* _preconditionedJacobiansVelStage, 
+    const ConstraintJacobianPair* _preconditionedJacobiansPosStage, 
+    const EffectiveMassPair* _effectiveMassesVelStage,
+    const EffectiveMassPair* _effectiveMassesPosStage,
+    WorkStealingPool* _pool,
+    int _threadCount,
+    const SolverConfig& _config );
+
 void PGSSolveKernelComputeErrors(
     ArrayBase< float >& _residuals,
     ArrayBase< float >& _deltaResiduals,
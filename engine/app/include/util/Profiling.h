@@ -54,9 +54,17 @@ namespace RBX
 			friend class Mark;
 		public:
 			CodeProfiler(const char* name);
+
+			// Unlike the buckets, these never roll over, so they cover runs of any length
+			double getTotalWallTime() const { return totalWallTime; }
+			int getTotalSamples() const { return totalSamples; }
+			void resetTotals();
 		private:
 			void log(bool frameTick, double wallTimeElapsed);
 			void unlog(double wallTimeElapsed);
+
+			double totalWallTime;
+			int totalSamples;
 		};
 
 		// Mark a section of code as belonging to a CodeProfiler
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "rbx/rbxTime.h"
+#include "rbx/Debug.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace RBX {
+
+// Hierarchical timer wheel (four levels, 256/64/64/64 slots): O(1) insert, and expiry cost
+// proportional to the number of ticks passed plus the number of values that come due.
+// Values further out than the wheel's span sit in the last level and get re-filed as it turns.
+template<class ValueType>
+class TimerWheel
+{
+public:
+	struct Entry
+	{
+		Time due;
+		ValueType value;
+
+		Entry(const Time& due, const ValueType& value) : due(due), value(value) {}
+
+		bool operator<(const Entry& other) const { return due < other.due; }
+	};
+	typedef std::vector<Entry> Entries;
+
+	TimerWheel(const Time& start, Time::Interval resolution)
+		: start(start)
+		, resolution(resolution.seconds())
+		, currentTick(0)
+		, count(0)
+	{
+		RBXASSERT(this->resolution > 0);
+	}
+
+	void insert(const Time& due, const ValueType& value)
+	{
+		++count;
+		file(Entry(due, value));
+	}
+
+	// Appends every value due at or before now to expired, in due order
+	void advance(const Time& now, Entries& expired)
+	{
+		const size_t firstExpired = expired.size();
+		const unsigned long long nowTick = tickOf(now);
+
+		expire(level0[currentTick & kLevel0Mask], now, expired);
+
+		while (currentTick < nowTick)
+		{
+			++currentTick;
+
+			if ((currentTick & kLevel0Mask) == 0 && cascade(1) && cascade(2))
+				cascade(3);
+
+			expire(level0[currentTick & kLevel0Mask], now, expired);
+		}
+
+		count -= expired.size() - firstExpired;
+		std::stable_sort(expired.begin() + firstExpired, expired.end());
+	}
+
+	size_t size() const { return count; }
+
+	void clear()
+	{
+		for (unsigned int i = 0; i < kLevel0Size; ++i)
+			level0[i].clear();
+		for (unsigned int level = 0; level < kUpperLevels; ++level)
+			for (unsigned int i = 0; i < kLevelSize; ++i)
+				upper[level][i].clear();
+		count = 0;
+	}
+
+private:
+	enum
+	{
+		kLevel0Bits = 8,
+		kLevel0Size = 1 << kLevel0Bits,
+		kLevel0Mask = kLevel0Size - 1,
+		kLevelBits = 6,
+		kLevelSize = 1 << kLevelBits,
+		kLevelMask = kLevelSize - 1,
+		kUpperLevels = 3,
+	};
+
+	Time start;
+	double resolution;
+	unsigned long long currentTick;
+	size_t count;
+
+	Entries level0[kLevel0Size];
+	Entries upper[kUpperLevels][kLevelSize];
+
+	unsigned long long tickOf(const Time& time) const
+	{
+		const double ticks = (time - start).seconds() / resolution;
+		return ticks > 0 ? (unsigned long long)ticks : 0;
+	}
+
+	static unsigned int shiftOf(unsigned int level)
+	{
+		return kLevel0Bits + (level - 1) * kLevelBits;
+	}
+
+	void file(const Entry& entry)
+	{
+		const unsigned long long tick = std::max(tickOf(entry.due), currentTick);
+		unsigned long long delta = tick - currentTick;
+
+		if (delta < kLevel0Size)
+		{
+			level0[tick & kLevel0Mask].push_back(entry);
+			return;
+		}
+
+		for (unsigned int level = 1; level <= kUpperLevels; ++level)
+		{
+			const unsigned long long span = 1ULL << (shiftOf(level) + kLevelBits);
+			if (delta < span || level == kUpperLevels)
+			{
+				// Too far out for the wheel: park it in the furthest slot, it is re-filed on the way down
+				const unsigned long long slotTick = delta < span ? tick : currentTick + span - 1;
+				upper[level - 1][(slotTick >> shiftOf(level)) & kLevelMask].push_back(entry);
+				return;
+			}
+		}
+	}
+
+	// Re-files the slot of the given level that is now current. Returns true if the next level is due as well
+	bool cascade(unsigned int level)
+	{
+		const unsigned int index = (unsigned int)((currentTick >> shiftOf(level)) & kLevelMask);
+
+		Entries entries;
+		entries.swap(upper[level - 1][index]);
+		for (size_t i = 0; i < entries.size(); ++i)
+			file(entries[i]);
+
+		return index == 0;
+	}
+
+	void expire(Entries& slot, const Time& now, Entries& expired)
+	{
+		if (slot.empty())
+			return;
+
+		// Values in the current tick may not be due yet; they stay put
+		size_t kept = 0;
+		for (size_t i = 0; i < slot.size(); ++i)
+		{
+			if (slot[i].due <= now)
+				expired.push_back(slot[i]);
+			else
+				slot[kept++] = slot[i];
+		}
+		slot.erase(slot.begin() + kept, slot.end());
+	}
+};
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "rbx/threadsafe.h"
+#include "boost/function.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/scoped_array.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/thread.hpp"
+#include <climits>
+#include <vector>
+
+namespace RBX
+{
+	// A fork-join pool for data parallel loops.
+	// parallelFor splits an index range evenly between the participating threads. A participant
+	// that runs out of work steals the back half of another participant's remaining range, so
+	// unevenly sized tasks still balance. The calling thread always participates, and parallelFor
+	// only returns once every index has been processed.
+	//
+	// Which thread runs which index is not deterministic. Tasks must not depend on each other.
+	class WorkStealingPool : boost::noncopyable
+	{
+	public:
+		// Processes the indices [begin, end)
+		typedef boost::function<void(size_t, size_t)> Task;
+
+		// Creates workerCount threads in addition to the calling thread
+		explicit WorkStealingPool(int workerCount);
+		~WorkStealingPool();
+
+		int getWorkerCount() const
+		{
+			return (int)workers.size();
+		}
+
+		// Runs task over [0, count) in chunks of at most grainSize indices, using at most
+		// maxParticipants threads (the calling thread included).
+		// Not reentrant: must not be called from inside a task or from two threads at once.
+		// Tasks must not throw.
+		void parallelFor(size_t count, size_t grainSize, const Task& task, int maxParticipants = INT_MAX);
+
+	private:
+		struct Range
+		{
+			rbx::spin_mutex mutex;
+			size_t begin;
+			size_t end;
+			char padding[64];	// keep the ranges on separate cache lines
+		};
+
+		void workerLoop(int participant);
+		void runParticipant(int participant);
+		bool popLocal(int participant, size_t& begin, size_t& end);
+		bool steal(int thief, size_t& begin, size_t& end);
+
+		std::vector<boost::shared_ptr<boost::thread> > workers;
+		boost::scoped_array<Range> ranges;
+
+		boost::mutex mutex;
+		boost::condition_variable wakeCondition;
+		boost::condition_variable finishedCondition;
+		unsigned int generation;
+		bool done;
+		int activeWorkers;	// workers that have not finished the current generation
+
+		// Valid for the duration of a parallelFor
+		const Task* task;
+		size_t grainSize;
+		int participants;
+	};
+}
@@ -15,7 +15,7 @@ LOGGROUP(MegaClusterInit)
 LOGGROUP(MegaClusterDirty)
 LOGGROUP(MegaClusterDecodeStream)
 
-namespace RBX { namespace Voxel2 { class MaterialTable; class Grid; } }
+namespace RBX { namespace Voxel2 { class MaterialTable; class Grid; namespace Mesher { class GeometryCache; } } }
 
 namespace RBX {
 
@@ -145,6 +145,9 @@ public:
 
 	Voxel2::MaterialTable* getMaterialTable() const { return materialTable.get(); }
 
+	// Shared by the physics and rendering meshers; replaced along with the material table
+	Voxel2::Mesher::GeometryCache* getGeometryCache() const { return geometryCache.get(); }
+
     void reloadMaterialTable();
 
 #define CLUSTER_CONST_PROP_OVERRIDE(ConstType, ArgType, FieldName, Ancestor, SetMethod) \
@@ -195,6 +198,7 @@ private:
 	scoped_ptr<Voxel2::Grid> smoothGrid;
 
 	scoped_ptr<Voxel2::MaterialTable> materialTable;
+	scoped_ptr<Voxel2::Mesher::GeometryCache> geometryCache;
 
     Color3 waterColor;
     float waterTransparency;
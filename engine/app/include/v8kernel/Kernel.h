@@ -16,6 +16,7 @@ namespace RBX {
 	class Body;
 	class Point;
 	class KernelData;
+	class WorkStealingPool;
 
 	class Kernel : public IStage,
 				   public BodyPvSetter
@@ -48,6 +49,8 @@ namespace RBX {
 
 		bool usingPGSSolver;
 
+		boost::scoped_ptr<WorkStealingPool> workerPool;
+
 	public:
         PGSSolver pgsSolver;
 		Kernel(IStage* upstream);
@@ -61,6 +64,10 @@ namespace RBX {
 
 		void step(bool throttling, int numThreads, boost::uint64_t debugTime);
 
+		// Threads for data parallel work during a step, shared by the solver and the world stages.
+		// numThreads is the concurrency allotted to the step, the calling thread included. Returns NULL if it is 1.
+		WorkStealingPool* getWorkerPool(int numThreads);
+
 		void insertBody(Body* b);
 		void insertPoint(Point* p);
 		void insertConnector(Connector* c);
@@ -120,6 +127,7 @@ namespace RBX {
 		// Profiler
 		boost::scoped_ptr<Profiling::CodeProfiler> profilingKernelBodies;
 		boost::scoped_ptr<Profiling::CodeProfiler> profilingKernelConnectors;
+		boost::scoped_ptr<Profiling::CodeProfiler> profilingKernelSolver;
 
 		void setUsingPGSSolver(bool pgsOn) { usingPGSSolver = pgsOn; }
 		bool getUsingPGSSolver() const { return usingPGSSolver; }
@@ -18,6 +18,8 @@
 #include "boost/enable_shared_from_this.hpp"
 #include <boost/static_assert.hpp>
 #include <boost/flyweight.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
 
 namespace RBX {
 
@@ -142,6 +144,11 @@ public:
 	};
 	std::vector<ThreadWaitingForChild> threadsWaitingForChildren;
 
+	// Name -> first child with that name. Only built for parents with many children,
+	// see Instance::findConstFirstChildByName
+	typedef boost::unordered_map<std::string, Instance*> ChildNameIndex;
+	boost::scoped_ptr<ChildNameIndex> childNameIndex;
+
 	virtual ~OnDemandInstance(){};
 };
 
@@ -773,6 +780,12 @@ private:
 
 	void writeProperties(XmlElement* container) const;
 	bool setParentInternal(Instance* instance, bool ignoreLock);
+
+	OnDemandInstance::ChildNameIndex* getChildNameIndex() const;
+	void buildChildNameIndex();
+	void updateChildNameIndex(const std::string& childName);
+	void onChildNameIndexAdded(Instance* child);
+	void onChildNameIndexRenamed(Instance* child, const std::string& oldName);
 };
 
 } // namespace RBX
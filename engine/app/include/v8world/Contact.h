@@ -121,6 +121,12 @@ namespace RBX {
 
 		virtual void invalidateContactCache();
 
+		// Parallel narrowphase: computes ahead of time the part of the next stepContact that only reads
+		// the geometry, so it can run on a worker thread. The bodies' PVs, the primitives' extents and the
+		// contact params must be up to date beforehand. The result is consumed by the next step().
+		virtual bool hasParallelNarrowphase() const { return false; }
+		virtual void computeNarrowphase() {}
+
         ContactParams* getContactParams(void) { return contactParams; }
 
 		bool isInContact() { return lastUiContactStep > 0; }
@@ -40,6 +40,7 @@ namespace RBX {
 	class World;
 	class ContactManagerSpatialHash;
 	class MegaClusterInstance;
+	class WorkStealingPool;
 
 	namespace Voxel { class Grid; }
 	namespace Voxel2 { class Grid; }
@@ -180,6 +181,7 @@ namespace RBX {
 		void onPrimitiveAssembled(Primitive* p);
 
 		void onAssemblyMovedFromStep(Assembly& a);
+		void onAssembliesMovedFromStep(const std::vector<Assembly*>& assemblies, WorkStealingPool* pool, int threadCount);
 
 		void applyDeferredTerrainChanges();
 
@@ -34,9 +34,13 @@ namespace RBX {
 
 		/*implement*/ virtual void findClosestFeatures(ConnectorArray& newConnectors) = 0;
 
+	protected:
+		bool narrowphaseComputed;		// computeNarrowphase ran since the last stepContact
+
 	public:
 		PolyContact(Primitive* p0, Primitive* p1)
 			: Contact(p0, p1)
+			, narrowphaseComputed(false)
 		{}
 
 		~PolyContact();
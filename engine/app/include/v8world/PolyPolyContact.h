@@ -145,10 +145,16 @@ namespace RBX {
 		void resetBestPair(PolyPair* pairOnStack);
 
 		/*override*/ void findClosestFeatures(ConnectorArray& newConnectors);
+		bool hasPolyGeometry();
 	public:
 		PolyPolyContact(Primitive* p0, Primitive* p1);
 		~PolyPolyContact();
 
+		// The best pair search is done ahead of time. Connectors are still created in stepContact, since
+		// they come from the shared pool allocators and go into the kernel.
+		/*override*/ bool hasParallelNarrowphase() const { return true; }
+		/*override*/ void computeNarrowphase();
+
 		static float epsilonDistance();	// distance to switch 
 
         void generateDataForMovingAssemblyStage(void); /*override*/
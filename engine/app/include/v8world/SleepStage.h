@@ -21,6 +21,7 @@ namespace RBX {
 	class Contact;
 	class Kernel;
 	class SleepStage;
+	class WorkStealingPool;
 
 	namespace Profiling
 	{
@@ -43,6 +44,10 @@ namespace RBX {
 		std::vector<Contact*> toContacting;
 		std::vector<Contact*> toContactingSleeping;
 		std::vector<Joint*> toSleepingJoint;
+		std::vector<Contact*> narrowphaseContacts;
+
+		WorkStealingPool* workerPool;
+		int workerThreadCount;
 
 		int numContactsInStage;
 		int numContactsInKernel;
@@ -78,6 +83,7 @@ namespace RBX {
 		void doContacts(ContactLists& contactLists);
 
 		void stepContacts(ContactList& contactList);
+		void computeNarrowphase(ContactList& contactList);
 
 		void stepJoints();
 
@@ -149,6 +155,12 @@ namespace RBX {
 
 		void stepSleepStage(int worldStepId, int uiStepId, bool _throttling);
 
+		// Runs the narrowphase of the contacts on the pool when set. NULL to step them serially.
+		void setWorkerPool(WorkStealingPool* pool, int threadCount) {
+			workerPool = pool;
+			workerThreadCount = threadCount;
+		}
+
 		/////////////////////////////////////////////
 		// From Upstream Collision Stage, World
 		void onAssemblyAdded(Assembly* a);
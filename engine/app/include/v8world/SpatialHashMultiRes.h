@@ -16,6 +16,7 @@ namespace RBX {
 
 	class World;
 	class Extents;
+	class WorkStealingPool;
 
 	class NodeBase
 	{
@@ -157,6 +158,12 @@ namespace RBX {
 		void onPrimitiveRemoved(Primitive* p);
 		void onPrimitiveExtentsChanged(Primitive* p);
 		void onPrimitiveAssembled(Primitive* p);
+
+		// Same as calling onPrimitiveExtentsChanged on each primitive in order, for all the primitives that
+		// moved in a step. The new cell ranges are computed on the pool, then the nodes and contacts are
+		// updated serially in the order given, so the result doesn't depend on the number of threads.
+		// Primitives must be unique, and getFastFuzzyExtents must be safe to call concurrently on distinct primitives.
+		void onPrimitivesExtentsChanged(const std::vector<Primitive*>& primitives, WorkStealingPool* pool, int threadCount);
 	
 		void getPrimitivesInGrid(const Vector3int32& grid, G3D::Array<Primitive*>& primitives);
 		bool getNextGrid(Vector3int32& grid, const RbxRay& unitRay, float maxDistance);
@@ -383,7 +390,22 @@ namespace RBX {
 							bool addContact = true);
 		void primitiveAdded(Primitive* p, bool addContact);
 		void primitiveRemoved(Primitive* p);
-		void primitiveExtentsChanged(Primitive* p, const Extents& extents);
+		void primitiveExtentsChanged(Primitive* p, const Vector3int32& newMin, const Vector3int32& newMax);
+
+		// Result of the read-only half of onPrimitiveExtentsChanged
+		struct ExtentsUpdate
+		{
+			bool excluded;
+			int level;
+			Vector3int32 min;	// only valid when the primitive keeps its level
+			Vector3int32 max;
+		};
+		std::vector<ExtentsUpdate> extentsUpdates;	// temp buffer
+		static const size_t extentsUpdateGrainSize = 64;
+
+		void computeExtentsUpdate(Primitive* p, ExtentsUpdate& update);
+		void applyExtentsUpdate(Primitive* p, const ExtentsUpdate& update);
+		static bool keepsLevel(int oldLevel, int newLevel);
 
 		// remove these once we can confirm "boost::pool" objects work
 		object_pool<TreeNode, roblox_allocator> treeNodeAllocator;
@@ -4,6 +4,7 @@
 #include "rbx/Debug.h"
 #include "RbxAssert.h"
 #include "g3d/CollisionDetection.h"
+#include "util/WorkStealingPool.h"
 
 #include <vector>
 
@@ -668,7 +669,8 @@ SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::checkAndRe
 	}
 }
 
-SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::primitiveExtentsChanged(Primitive* p, const Extents& extents)
+// newMin/newMax are the cell range at the primitive's current level, see computeExtentsUpdate
+SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::primitiveExtentsChanged(Primitive* p, const Vector3int32& newMin, const Vector3int32& newMax)
 {
 	WriteValidator writeValidator(concurrencyValidator);
 
@@ -676,12 +678,6 @@ SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::primitiveE
 	RBXASSERT_SPATIAL_HASH(p->spatialNodes != NULL);
 	RBXASSERT(p->getSpatialNodeLevel() != -1);
 
-	Vector3int32 newMin, newMax;
-
-	// For now, never change a primitive's level in the hierarchy, once it
-	// has been determined at creation time
-	SpatialHashStatic::computeMinMax(p->getSpatialNodeLevel(), extents, newMin, newMax);
-
 	if (	(newMin == p->getOldSpatialMin())
 		&&	(newMax == p->getOldSpatialMax())) {
 		return;
@@ -735,29 +731,50 @@ SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::primitiveR
 	RBXASSERT_SPATIAL_HASH(validateContacts(p));
 }
 
-// Note -use FastFuzzyExtents when not in the middle of a simulation step
-// Use FastFuzzyExtentsNoCompute when in a step
-SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::onPrimitiveExtentsChanged(Primitive* p)
+SHP bool SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::keepsLevel(int oldLevel, int newLevel)
 {
-    if( contactManager->primitiveIsExcludedFromSpatialHash(p) )
-        return;
+	int delta = newLevel - oldLevel;
+	return (delta <= 0) && (delta >= -1);		// grow always, shrink only if 2 steps down
+}
 
-    contactManager->checkTerrainContact(p);
+// Read-only with respect to the hash, can run concurrently for distinct primitives
+SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::computeExtentsUpdate(Primitive* p, ExtentsUpdate& update)
+{
+	update.excluded = contactManager->primitiveIsExcludedFromSpatialHash(p);
+	if (update.excluded)
+		return;
 
 	Extents newExtentsFloat = calcNewExtents(p);
-	int newLevel = computeLevel(p, newExtentsFloat);
 	int oldLevel = p->getSpatialNodeLevel();
-	int delta = newLevel - oldLevel;
+	update.level = computeLevel(p, newExtentsFloat);
+
+	// For now, never change a primitive's level in the hierarchy, once it
+	// has been determined at creation time
+	if (keepsLevel(oldLevel, update.level))
+		SpatialHashStatic::computeMinMax(oldLevel, newExtentsFloat, update.min, update.max);
+}
+
+SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::applyExtentsUpdate(Primitive* p, const ExtentsUpdate& update)
+{
+	if (update.excluded)
+		return;
+
+	// The extents were computed before this ran; checkTerrainContact only adds and removes
+	// terrain contacts and never moves p, so the order does not change the result
+	contactManager->checkTerrainContact(p);
+
+	int newLevel = update.level;
+	int oldLevel = p->getSpatialNodeLevel();
 	ExtentsInt32 preUpdateSpatialExtents = p->getOldSpatialExtents();
 
-	if ((delta > 0) || (delta < -1))		// grow always, shrink only if 2 steps down
+	if (keepsLevel(oldLevel, newLevel))
 	{
-		primitiveRemoved(p);
-		primitiveAdded(p, true);
+		primitiveExtentsChanged(p, update.min, update.max);
 	}
 	else
 	{
-		primitiveExtentsChanged(p, newExtentsFloat);
+		primitiveRemoved(p);
+		primitiveAdded(p, true);
 	}
 
 	ExtentsInt32 postUpdateSpatialExtents = p->getOldSpatialExtents();
@@ -776,6 +793,42 @@ SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::onPrimitiv
 	}
 }
 
+// Note -use FastFuzzyExtents when not in the middle of a simulation step
+// Use FastFuzzyExtentsNoCompute when in a step
+SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::onPrimitiveExtentsChanged(Primitive* p)
+{
+	ExtentsUpdate update;
+	computeExtentsUpdate(p, update);
+	applyExtentsUpdate(p, update);
+}
+
+SHP void SpatialHash<Primitive, Contact, ContactManager, MAX_LEVELS>::onPrimitivesExtentsChanged(const std::vector<Primitive*>& primitives, WorkStealingPool* pool, int threadCount)
+{
+	if (primitives.empty())
+		return;
+
+	extentsUpdates.resize(primitives.size());
+
+	// Computing the extents and cell ranges is most of the cost and only touches the primitive itself
+	if (pool && threadCount > 1 && primitives.size() >= 2 * extentsUpdateGrainSize)
+	{
+		pool->parallelFor(primitives.size(), extentsUpdateGrainSize, [this, &primitives](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				computeExtentsUpdate(primitives[i], extentsUpdates[i]);
+		}, threadCount);
+	}
+	else
+	{
+		for (size_t i = 0; i < primitives.size(); ++i)
+			computeExtentsUpdate(primitives[i], extentsUpdates[i]);
+	}
+
+	// Nodes, tree nodes and contacts are shared between primitives: merge serially, in order
+	for (size_t i = 0; i < primitives.size(); ++i)
+		applyExtentsUpdate(primitives[i], extentsUpdates[i]);
+}
+
 // Now that primitives are assembled into mechanisms we know the full topology to filter
 // internal contacts.  So let's query the spatial hash to create the contacts and rely on
 // onNewPair() to do the filtering
@@ -108,6 +108,7 @@ namespace RBX {
 		EThrottle					eThrottle;
 
 		G3D::Array<TouchInfo>		touchReporting;
+		std::vector<Assembly*>		movedAssemblies;	// temp buffer for the broadphase update
 
 		bool						inStepCode;	// debugging
 		Joint*						inJointNotification;
@@ -2,6 +2,8 @@
 
 #include <istream>
 #include <ostream>
+#include <string>
+#include <vector>
 
 #include <v8tree/Instance.h>
 
@@ -13,7 +15,8 @@ namespace RBX
 		{
 			sfHighCompression = 1 << 0,
 			sfNoCompression = 1 << 1,
-			sfInexactCFrame = 1 << 2
+			sfInexactCFrame = 1 << 2,
+			sfAdaptiveCompression = 1 << 3	// sfHighCompression for small chunks only, where it is cheap
 		};
 
 		static const char kMagicHeader[] = "<roblox!";
@@ -23,5 +26,23 @@ namespace RBX
 
 		void deserialize(std::istream& in, Instance* root);
 		void deserialize(std::istream& in, Instances& result);
+
+		// Reads directly from a buffer holding the whole file; the buffer is not copied
+		void deserialize(const char* data, size_t size, Instance* root);
+		void deserialize(const char* data, size_t size, Instances& result);
+
+		// Memory-maps the file instead of reading it
+		void deserializeFile(const std::string& fileName, Instance* root);
+
+#ifdef RBX_TEST_BUILD
+		// Decode and compression helper threads started so far in this process
+		int getHelperThreadsStarted();
+
+		// Int and float columns as the byte planes stored in the file
+		std::string encodeIntPlanes(const std::vector<int>& values);
+		std::vector<int> decodeIntPlanes(const std::string& planes);
+		std::string encodeFloatPlanes(const std::vector<float>& values);
+		std::vector<float> decodeFloatPlanes(const std::string& planes);
+#endif
 	};
 }
@@ -38,6 +38,7 @@ public:
 	// Until DataModel becomes an Instance and it can handle "globals" like Workspace, we need to treat
 	// it specially during reads:
 	void load(std::istream& stream, RBX::DataModel* dataModel);
+	void loadFile(const std::string& fileName, RBX::DataModel* dataModel);	// memory-maps binary files
 	void loadInstances(std::istream& stream, RBX::Instances& result);
 
 private:
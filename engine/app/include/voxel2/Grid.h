@@ -1,6 +1,11 @@
 #pragma once
 
 #include "util/Vector3int32.h"
+
+#include "boost/shared_ptr.hpp"
+#include "boost/static_assert.hpp"
+#include "boost/unordered_map.hpp"
+
 #include <vector>
 
 namespace RBX { namespace Voxel2 {
@@ -5,6 +5,13 @@
 
 #include "voxel2/Grid.h"
 
+#include "rbx/Boost.hpp"
+
+#include "boost/thread/mutex.hpp"
+#include "boost/unordered_map.hpp"
+
+#include <list>
+
 namespace RBX { namespace Voxel2 {
 
     class MaterialTable;
@@ -93,6 +100,98 @@ namespace RBX { namespace Voxel2 {
 
 		const TextureBasis& getTextureBasisU();
 		const TextureBasis& getTextureBasisV();
+
+        // Keeps recently generated geometry keyed by the contents of the box it was generated from.
+        // Terrain writes invalidate every chunk that touches the written region, and most of them come
+        // back with the same cells; those are returned from the cache instead of being meshed again.
+        // Safe to use from multiple threads.
+        class GeometryCache: boost::noncopyable
+        {
+        public:
+            // memoryLimit is in bytes; 0 disables caching
+            explicit GeometryCache(size_t memoryLimit);
+
+            // Same result as Mesher::generateGeometry. Calls with identical arguments return the same
+            // mesh object for as long as it stays in the cache, so callers can compare pointers to see
+            // if anything changed. Geometry depends on the material table, so a cache must not outlive it.
+            shared_ptr<const BasicMesh> generateGeometry(const Box& box, const Vector3int32& offset, int lod, const Options& options);
+
+            void clear();
+
+            size_t getMemorySize() const;
+            unsigned int getHitCount() const;
+            unsigned int getMissCount() const;
+
+        private:
+            struct Entry
+            {
+                size_t hash;
+                Box box;
+                Vector3int32 offset;
+                int lod;
+                bool generateWater;
+
+                shared_ptr<const BasicMesh> mesh;
+                size_t memorySize;
+            };
+
+            typedef std::list<Entry> EntryList;
+            typedef boost::unordered_multimap<size_t, EntryList::iterator> EntryMap;
+
+            shared_ptr<const BasicMesh> find(size_t hash, const Box& box, const Vector3int32& offset, int lod, const Options& options);
+            void trim();
+
+            size_t memoryLimit;
+            size_t memorySize;
+
+            unsigned int hitCount;
+            unsigned int missCount;
+
+            // Most recently used first
+            EntryList entries;
+            EntryMap entryMap;
+
+            mutable boost::mutex mutex;
+        };
+
+        // Meshes a batch of boxes on the terrain meshing threads, with the calling thread helping out.
+        // Boxes have to be read from the grid up front since the grid is not thread safe; meshing only
+        // reads the boxes and the material table.
+        class Batch: boost::noncopyable
+        {
+        public:
+            // cache may be NULL
+            Batch(GeometryCache* cache, const Options& options);
+
+            // Returns the index of the result
+            size_t add(const Box& box, const Vector3int32& offset, int lod);
+
+            // Meshes everything added so far and waits for it to finish
+            void run();
+
+            size_t size() const { return items.size(); }
+
+            const shared_ptr<const BasicMesh>& getResult(size_t index) const { return items[index].result; }
+
+        private:
+            struct Item
+            {
+                Box box;
+                Vector3int32 offset;
+                int lod;
+
+                shared_ptr<const BasicMesh> result;
+            };
+
+            struct State;
+
+            static void work(const shared_ptr<State>& state);
+
+            GeometryCache* cache;
+            Options options;
+
+            std::vector<Item> items;
+        };
     };
 
 } }
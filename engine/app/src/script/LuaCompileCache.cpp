@@ -0,0 +1,341 @@
+#include "stdafx.h"
+
+#include "script/LuaCompileCache.h"
+
+#include "lobject.h"
+#include "lstate.h"
+#include "lstring.h"
+#include "lfunc.h"
+#include "lgc.h"
+#include "lmem.h"
+#include "ldo.h"
+
+#include <boost/functional/hash.hpp>
+
+DYNAMIC_FASTINTVARIABLE(LuaCompileCacheSizeKB, 0)
+
+namespace RBX { namespace Lua {
+
+CompileCache& CompileCache::singleton()
+{
+	static CompileCache compileCache(DFInt::LuaCompileCacheSizeKB * 1024);
+
+	// The process-wide cache follows the flag so it can be resized or emptied on a live server
+	compileCache.setCapacity(DFInt::LuaCompileCacheSizeKB * 1024);
+	return compileCache;
+}
+
+bool CompileCache::isEnabled()
+{
+	return DFInt::LuaCompileCacheSizeKB > 0;
+}
+
+CompileCache::CompileCache(size_t maxBytes)
+	: cache(maxBytes)
+	, capacity(maxBytes)
+	, hits(0)
+	, misses(0)
+{
+}
+
+bool CompileCache::load(lua_State* L, const std::string& source, const char* chunkname, int& status)
+{
+	const Key key = makeKey(L, source);
+	boost::shared_ptr<const Chunk> chunk;
+
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		if (!cache.fetch(key, &chunk) || chunk->source != source)
+		{
+			++misses;
+			return false;
+		}
+
+		++hits;
+	}
+
+	// Chunks are immutable once cached, so the prototype is built outside the lock
+	InstantiateData data = { chunk.get(), chunkname ? chunkname : "?" };
+	status = luaD_pcall(L, instantiateMain, &data, savestack(L, L->top), L->errfunc);
+	return true;
+}
+
+void CompileCache::store(lua_State* L, const std::string& source)
+{
+	const TValue* o = L->top - 1;
+	if (!isLfunction(o))
+		return;
+
+	boost::shared_ptr<Chunk> chunk(new Chunk());
+	chunk->source = source;
+
+	StringIndex stringIndex;
+	capture(*chunk, stringIndex, clvalue(o)->l.p);
+
+	const Key key = makeKey(L, source);
+	const size_t bytes = sizeOf(*chunk);
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (bytes <= capacity)
+		cache.insert(key, chunk, bytes);
+}
+
+void CompileCache::setCapacity(size_t maxBytes)
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (maxBytes != capacity)
+	{
+		capacity = maxBytes;
+		cache.resize(capacity);
+	}
+}
+
+void CompileCache::clear()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	cache.clear();
+	hits = 0;
+	misses = 0;
+}
+
+size_t CompileCache::getEntries()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return cache.size();
+}
+
+size_t CompileCache::getBytes()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return cache.memSize();
+}
+
+CompileCache::Key CompileCache::makeKey(lua_State* L, const std::string& source)
+{
+	// Compiled code does not depend on the identity a script runs at (that comes from the thread it
+	// is loaded into), but it must only be handed to a VM that decodes instructions the same way
+	Key key;
+	key.sourceHash = boost::hash_range(source.begin(), source.end());
+	key.sourceSize = source.size();
+	key.vmKey = L->l_G->ckey;
+	return key;
+}
+
+int CompileCache::capture(Chunk& chunk, StringIndex& stringIndex, const Proto* p)
+{
+	const int index = chunk.functions.size();
+	chunk.functions.push_back(Function());
+
+	// Children are appended as they are captured, so fill a local copy rather than a reference into functions
+	Function function;
+
+	function.code.resize(p->sizecode);
+	for (int i = 0; i < p->sizecode; ++i)
+		function.code[i] = p->code[i].v;
+
+	function.lineInfo.assign(static_cast<const int*>(p->lineinfo), static_cast<const int*>(p->lineinfo) + p->sizelineinfo);
+
+	function.constants.resize(p->sizek);
+	for (int i = 0; i < p->sizek; ++i)
+	{
+		const TValue* o = &p->k[i];
+		Constant& constant = function.constants[i];
+
+		constant.type = ttype(o);
+		constant.number = 0;
+		constant.string = 0;
+
+		switch (ttype(o))
+		{
+		case LUA_TBOOLEAN:
+			constant.number = bvalue(o);
+			break;
+
+		case LUA_TNUMBER:
+			constant.number = nvalue(o);
+			break;
+
+		case LUA_TSTRING:
+			constant.string = captureString(chunk, stringIndex, rawtsvalue(o));
+			break;
+
+		default:
+			lua_assert(ttisnil(o));
+			break;
+		}
+	}
+
+	function.localVariables.resize(p->sizelocvars);
+	for (int i = 0; i < p->sizelocvars; ++i)
+	{
+		function.localVariables[i].startpc = p->locvars[i].startpc;
+		function.localVariables[i].endpc = p->locvars[i].endpc;
+		function.localVariables[i].name = captureString(chunk, stringIndex, p->locvars[i].varname);
+	}
+
+	function.upvalues.resize(p->sizeupvalues);
+	for (int i = 0; i < p->sizeupvalues; ++i)
+		function.upvalues[i] = captureString(chunk, stringIndex, p->upvalues[i]);
+
+	function.lineDefined = p->linedefined;
+	function.lastLineDefined = p->lastlinedefined;
+	function.nups = p->nups;
+	function.numParams = p->numparams;
+	function.isVararg = p->is_vararg;
+	function.maxStackSize = p->maxstacksize;
+
+	function.children.resize(p->sizep);
+	for (int i = 0; i < p->sizep; ++i)
+		function.children[i] = capture(chunk, stringIndex, p->p[i]);
+
+	chunk.functions[index] = function;
+	return index;
+}
+
+// Returns a 1-based index into chunk.strings, 0 for NULL
+int CompileCache::captureString(Chunk& chunk, StringIndex& stringIndex, const TString* string)
+{
+	if (!string)
+		return 0;
+
+	int& index = stringIndex[string];
+	if (index == 0)
+	{
+		chunk.strings.push_back(std::string(getstr(string), string->tsv.len));
+		index = chunk.strings.size();
+	}
+
+	return index;
+}
+
+size_t CompileCache::sizeOf(const Chunk& chunk)
+{
+	size_t bytes = sizeof(Chunk) + chunk.source.size();
+
+	for (size_t i = 0; i < chunk.strings.size(); ++i)
+		bytes += sizeof(std::string) + chunk.strings[i].size();
+
+	for (size_t i = 0; i < chunk.functions.size(); ++i)
+	{
+		const Function& function = chunk.functions[i];
+
+		bytes += sizeof(Function);
+		bytes += function.code.size() * sizeof(unsigned int);
+		bytes += function.lineInfo.size() * sizeof(int);
+		bytes += function.constants.size() * sizeof(Constant);
+		bytes += function.localVariables.size() * sizeof(LocalVariable);
+		bytes += function.upvalues.size() * sizeof(int);
+		bytes += function.children.size() * sizeof(int);
+	}
+
+	return bytes;
+}
+
+Proto* CompileCache::instantiate(lua_State* L, const Chunk& chunk, int index, const std::vector<TString*>& strings, TString* source)
+{
+	const Function& function = chunk.functions[index];
+
+	Proto* p = luaF_newproto(L);
+
+	p->source = source;
+
+	p->sizecode = function.code.size();
+	p->code = luaM_newvector(L, p->sizecode, InstructionV);
+	for (int i = 0; i < p->sizecode; ++i)
+		p->code[i].v = function.code[i];
+
+	p->sizelineinfo = function.lineInfo.size();
+	p->lineinfo = luaM_newvector(L, p->sizelineinfo, int);
+	for (int i = 0; i < p->sizelineinfo; ++i)
+		p->lineinfo[i] = function.lineInfo[i];
+
+	p->sizek = function.constants.size();
+	p->k = luaM_newvector(L, p->sizek, TValue);
+	for (int i = 0; i < p->sizek; ++i)
+	{
+		const Constant& constant = function.constants[i];
+		TValue* o = &p->k[i];
+
+		switch (constant.type)
+		{
+		case LUA_TBOOLEAN:
+			setbvalue(o, constant.number != 0);
+			break;
+
+		case LUA_TNUMBER:
+			setnvalue(o, constant.number);
+			break;
+
+		case LUA_TSTRING:
+			setsvalue2n(L, o, strings[constant.string - 1]);
+			break;
+
+		default:
+			setnilvalue(o);
+			break;
+		}
+	}
+
+	p->sizelocvars = function.localVariables.size();
+	p->locvars = luaM_newvector(L, p->sizelocvars, LocVar);
+	for (int i = 0; i < p->sizelocvars; ++i)
+	{
+		const LocalVariable& local = function.localVariables[i];
+
+		p->locvars[i].startpc = local.startpc;
+		p->locvars[i].endpc = local.endpc;
+		p->locvars[i].varname = local.name ? strings[local.name - 1] : NULL;
+	}
+
+	p->sizeupvalues = function.upvalues.size();
+	p->upvalues = luaM_newvector(L, p->sizeupvalues, TString*);
+	for (int i = 0; i < p->sizeupvalues; ++i)
+		p->upvalues[i] = function.upvalues[i] ? strings[function.upvalues[i] - 1] : NULL;
+
+	p->linedefined = function.lineDefined;
+	p->lastlinedefined = function.lastLineDefined;
+	p->nups = function.nups;
+	p->numparams = function.numParams;
+	p->is_vararg = function.isVararg;
+	p->maxstacksize = function.maxStackSize;
+
+	p->sizep = function.children.size();
+	p->p = luaM_newvector(L, p->sizep, Proto*);
+	for (int i = 0; i < p->sizep; ++i)
+		p->p[i] = NULL;
+	for (int i = 0; i < p->sizep; ++i)
+		p->p[i] = instantiate(L, chunk, function.children[i], strings, source);
+
+	return p;
+}
+
+// Mirrors f_parser in ldo.c, run under luaD_pcall so allocation failures come back as a status
+void CompileCache::instantiateMain(lua_State* L, void* ud)
+{
+	const InstantiateData* data = static_cast<const InstantiateData*>(ud);
+	const Chunk& chunk = *data->chunk;
+
+	luaC_checkGC(L);
+
+	// Nothing below can run a GC step, so the new strings and prototypes are safe until the closure anchors them
+	TString* source = luaS_new(L, data->chunkname);
+
+	std::vector<TString*> strings(chunk.strings.size());
+	for (size_t i = 0; i < chunk.strings.size(); ++i)
+		strings[i] = luaS_newlstr(L, chunk.strings[i].c_str(), chunk.strings[i].size());
+
+	Proto* tf = instantiate(L, chunk, 0, strings, source);
+
+	Closure* cl = luaF_newLclosure(L, tf->nups, hvalue(gt(L)));
+	cl->l.p = tf;
+	for (int i = 0; i < tf->nups; i++)
+		cl->l.upvals[i] = luaF_newupval(L);
+
+	setclvalue(L, L->top, cl);
+	incr_top(L);
+}
+
+}}
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 
 #include "script/LuaInstanceBridge.h"
+#include "script/LuaMemberLookupCache.h"
 #include "script/ScriptContext.h"
 #include "util/BrickColor.h"
 #include "v8datamodel/Decal.h"
@@ -341,6 +342,24 @@ static const char* PropertyNameCorrection(const shared_ptr<Instance>& object, co
 	return name;
 }
 
+static const Lua::MemberLookupCache::Entry* lookupCachedMember(const shared_ptr<Instance>& object, const char* name, lua_State *L)
+{
+	if (ScriptContext* context = RobloxExtraSpace::get(L)->context())
+		if (Lua::MemberLookupCache* cache = context->getMemberLookupCache())
+			return &cache->lookup(object->getDescriptor(), name);
+
+	return NULL;
+}
+
+template<class Descriptor>
+static Descriptor* findMember(const shared_ptr<Instance>& object, const char* name, const Lua::MemberLookupCache::Entry* cached, Lua::MemberLookupCache::Kind kind)
+{
+	if (cached)
+		return cached->kind == kind ? static_cast<Descriptor*>(cached->member) : NULL;
+
+	return object->getDescriptor().MemberDescriptorContainer<Descriptor>::findDescriptor(name);
+}
+
 namespace RBX { namespace Lua {
 
 	template<>
@@ -356,9 +375,10 @@ namespace RBX { namespace Lua {
 
 		RBX::Security::Context& securityContext = RBX::Security::Context::current();
 
+		const MemberLookupCache::Entry* cached = lookupCachedMember(object, name, L);
 
 		// Look for a property:
-		if (PropertyDescriptor* prop = object->findPropertyDescriptor(name))
+		if (PropertyDescriptor* prop = findMember<PropertyDescriptor>(object, name, cached, MemberLookupCache::Kind_Property))
 		{
 			object->securityCheck(securityContext);
 			pushLuaValue(Property(*prop, object.get()), L, securityContext);
@@ -366,7 +386,7 @@ namespace RBX { namespace Lua {
 		}
 
 		//Look for a yield function
-		if (Reflection::YieldFunctionDescriptor* func = object->findYieldFunctionDescriptor(name))
+		if (Reflection::YieldFunctionDescriptor* func = findMember<Reflection::YieldFunctionDescriptor>(object, name, cached, MemberLookupCache::Kind_YieldFunction))
 		{
 			void* desc = reinterpret_cast<void*>(func);
 
@@ -394,7 +414,7 @@ namespace RBX { namespace Lua {
 		}
 
 		// Look for a function:
-		if (Reflection::FunctionDescriptor* func = object->findFunctionDescriptor(name))
+		if (Reflection::FunctionDescriptor* func = findMember<Reflection::FunctionDescriptor>(object, name, cached, MemberLookupCache::Kind_Function))
 		{
 			void* desc = reinterpret_cast<void*>(func);
 
@@ -422,7 +442,7 @@ namespace RBX { namespace Lua {
 		}
 
 		// Look for a Signal:
-		if (EventDescriptor* signal = object->findSignalDescriptor(name))
+		if (EventDescriptor* signal = findMember<EventDescriptor>(object, name, cached, MemberLookupCache::Kind_Event))
 		{
 			object->securityCheck(securityContext);
 			if (object->getRobloxLocked())
@@ -460,7 +480,7 @@ namespace RBX { namespace Lua {
             }
         }
 
-        if (object->findCallbackDescriptor(name))
+        if (cached ? cached->callback : object->findCallbackDescriptor(name))
         {
             throw RBX::runtime_error("%s is a callback member of %s; you can only set the callback value, get is not available", name, object->getDescriptor().name.c_str());
         }
@@ -962,7 +982,9 @@ void Bridge< shared_ptr<Instance>, false >::on_newindex(shared_ptr<Instance>& ob
 
 	name = PropertyNameCorrection(object, name, L);
 
-	if (PropertyDescriptor* prop = object->findPropertyDescriptor(name))
+	const Lua::MemberLookupCache::Entry* cached = lookupCachedMember(object, name, L);
+
+	if (PropertyDescriptor* prop = cached ? cached->property : object->findPropertyDescriptor(name))
 	{
 		// Special-case the Parent property
 		const PropertyDescriptor& desc = *prop;
@@ -998,7 +1020,7 @@ void Bridge< shared_ptr<Instance>, false >::on_newindex(shared_ptr<Instance>& ob
 		return;
 	}
 
-	if (CallbackDescriptor* callback = object->findCallbackDescriptor(name))
+	if (CallbackDescriptor* callback = cached ? cached->callback : object->findCallbackDescriptor(name))
 	{
 		if(instance->getRobloxLocked())
 			securityContext.requirePermission(RBX::Security::Plugin, callback->name.c_str());
@@ -0,0 +1,75 @@
+#include "stdafx.h"
+
+#include "script/LuaMemberLookupCache.h"
+
+#include <string.h>
+
+namespace RBX { namespace Lua {
+
+MemberLookupCache::MemberLookupCache()
+	: hits(0)
+	, misses(0)
+{
+	memset(entries, 0, sizeof(entries));
+	memset(&uncached, 0, sizeof(uncached));
+}
+
+const MemberLookupCache::Entry& MemberLookupCache::lookup(const Reflection::ClassDescriptor& classDescriptor, const char* name)
+{
+	const size_t slot = ((reinterpret_cast<size_t>(name) >> 3) ^ (reinterpret_cast<size_t>(&classDescriptor) >> 4)) & (kEntryCount - 1);
+	Entry& entry = entries[slot];
+
+	if (entry.classDescriptor == &classDescriptor && entry.namePointer == name && strcmp(entry.name, name) == 0)
+	{
+		++hits;
+		return entry;
+	}
+
+	++misses;
+
+	if (strlen(name) >= sizeof(entry.name))
+	{
+		resolve(uncached, classDescriptor, name);
+		return uncached;
+	}
+
+	resolve(entry, classDescriptor, name);
+	entry.classDescriptor = &classDescriptor;
+	entry.namePointer = name;
+	strcpy(entry.name, name);
+	return entry;
+}
+
+void MemberLookupCache::resolve(Entry& entry, const Reflection::ClassDescriptor& classDescriptor, const char* name)
+{
+	entry.property = classDescriptor.findPropertyDescriptor(name);
+	entry.callback = classDescriptor.findCallbackDescriptor(name);
+
+	if (entry.property)
+	{
+		entry.kind = Kind_Property;
+		entry.member = entry.property;
+	}
+	else if (Reflection::YieldFunctionDescriptor* yieldFunction = classDescriptor.findYieldFunctionDescriptor(name))
+	{
+		entry.kind = Kind_YieldFunction;
+		entry.member = yieldFunction;
+	}
+	else if (Reflection::FunctionDescriptor* function = classDescriptor.findFunctionDescriptor(name))
+	{
+		entry.kind = Kind_Function;
+		entry.member = function;
+	}
+	else if (Reflection::EventDescriptor* event = classDescriptor.findEventDescriptor(name))
+	{
+		entry.kind = Kind_Event;
+		entry.member = event;
+	}
+	else
+	{
+		entry.kind = Kind_None;
+		entry.member = NULL;
+	}
+}
+
+}}
@@ -0,0 +1,106 @@
+#include "stdafx.h"
+
+#include "script/LuaSampleProfiler.h"
+
+#include "lua.h"
+
+#include <algorithm>
+#include <vector>
+
+DYNAMIC_FASTINTVARIABLE(LuaSampleProfilerMaxDepth, 64)
+DYNAMIC_FASTINTVARIABLE(LuaSampleProfilerMaxStacks, 10000)
+
+namespace RBX { namespace Lua {
+
+static const char* const kOtherStacks = "[other]";
+
+SampleProfiler::SampleProfiler(int frequency)
+	: interval(1.0 / std::min(std::max(frequency, 1), 10000))
+	, nextSample(Time::nowFast())
+	, sampleCount(0)
+{
+}
+
+void SampleProfiler::sample(lua_State* L, const Time& now)
+{
+	// Schedule from now rather than from the missed sample, a thread that ran no Lua for a while should not get a burst
+	nextSample = now + interval;
+
+	const int maxDepth = std::max(1, DFInt::LuaSampleProfilerMaxDepth);
+
+	lua_Debug ar;
+	int depth = 0;
+	while (depth < maxDepth && lua_getstack(L, depth, &ar))
+		++depth;
+
+	if (depth == 0)
+		return;
+
+	++sampleCount;
+
+	// Folded stacks list the root first
+	std::string stack;
+	if (lua_getstack(L, depth, &ar))
+		stack = "...";
+
+	for (int level = depth - 1; level >= 0; --level)
+	{
+		if (!stack.empty())
+			stack += ';';
+		appendFrame(stack, L, level);
+	}
+
+	Stacks::iterator it = stacks.find(stack);
+	if (it != stacks.end())
+		++it->second;
+	else if (stacks.size() < (size_t)DFInt::LuaSampleProfilerMaxStacks)
+		stacks[stack] = 1;
+	else
+		++stacks[kOtherStacks];
+}
+
+std::string SampleProfiler::getFoldedStacks() const
+{
+	std::vector<Stacks::const_iterator> sorted;
+	sorted.reserve(stacks.size());
+	for (Stacks::const_iterator it = stacks.begin(); it != stacks.end(); ++it)
+		sorted.push_back(it);
+
+	struct ByStack
+	{
+		bool operator()(const Stacks::const_iterator& a, const Stacks::const_iterator& b) const { return a->first < b->first; }
+	};
+	std::sort(sorted.begin(), sorted.end(), ByStack());
+
+	std::string result;
+	for (size_t i = 0; i < sorted.size(); ++i)
+		result += format("%s %u\n", sorted[i]->first.c_str(), sorted[i]->second);
+
+	return result;
+}
+
+void SampleProfiler::appendFrame(std::string& stack, lua_State* L, int level)
+{
+	lua_Debug ar;
+	if (!lua_getstack(L, level, &ar) || !lua_getinfo(L, "Sln", &ar))
+	{
+		stack += "?";
+		return;
+	}
+
+	const char* name = ar.name ? ar.name : (*ar.what == 'm') ? "<main>" : "<anonymous>";
+
+	const size_t start = stack.size();
+
+	if (ar.currentline > 0)
+		stack += format("%s (%s:%d)", name, ar.short_src, ar.currentline);
+	else
+		stack += format("%s (%s)", name, ar.short_src);
+
+	// Keep the frame from breaking the folded format
+	for (size_t i = start; i < stack.size(); ++i)
+		if (stack[i] == ';' || stack[i] == '\n' || stack[i] == '\r')
+			stack[i] = '_';
+}
+
+}}
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "script/LuaVM.h"
+#include "script/LuaCompileCache.h"
 
 #include "util/Guid.h"
 #include "util/ProtectedString.h"
@@ -123,6 +124,23 @@ namespace LuaVM
         const std::string& code = source.getSource();
             
         LoadS ls = { code.c_str(), code.size() };
+
+        if (RBX::Lua::CompileCache::isEnabled())
+        {
+            RBX::Lua::CompileCache& cache = RBX::Lua::CompileCache::singleton();
+
+            int status = 0;
+            if (cache.load(L, code, chunkname, status))
+                return status;
+
+            status = lua_load(L, getS, &ls, chunkname);
+
+            // Syntax errors are not cached, they are rare and the message names the chunk
+            if (status == 0)
+                cache.store(L, code);
+
+            return status;
+        }
             
         return lua_load(L, getS, &ls, chunkname);
     }
@@ -8,6 +8,8 @@
 #include "script/LuaEnum.h"
 #include "script/LuaInstanceBridge.h"
 #include "script/LuaLibrary.h"
+#include "script/LuaMemberLookupCache.h"
+#include "script/LuaSampleProfiler.h"
 #include "script/LuaMemory.h"
 #include "script/LuaSettings.h"
 #include "script/LuaSignalBridge.h"
@@ -77,6 +79,7 @@ DYNAMIC_FASTINTVARIABLE(LuaGcBoost, 1)
 DYNAMIC_FASTINTVARIABLE(LuaGcMaxKb, 100)
 
 DYNAMIC_FASTFLAGVARIABLE(LockViolationScriptCrash, false)
+DYNAMIC_FASTFLAGVARIABLE(LuaMemberLookupCache, false)
 
 namespace RBX
 {
@@ -366,6 +369,8 @@ Reflection::BoundFuncDesc<ScriptContext, void(double)> func_SetTimeout(&ScriptCo
 Reflection::BoundFuncDesc<ScriptContext, shared_ptr<const Reflection::Tuple>(bool)> func_GetHeapStats(&ScriptContext::getHeapStats, "GetHeapStats", "clearHighwaterMark", true, Security::RobloxScript);
 Reflection::BoundFuncDesc<ScriptContext, shared_ptr<const Reflection::ValueArray>()> func_GetScriptStats(&ScriptContext::getScriptStatsNew, "GetScriptStats", Security::RobloxScript);
 Reflection::BoundFuncDesc<ScriptContext, void(bool)> func_CollectScriptStats(&ScriptContext::setCollectScriptStats, "SetCollectScriptStats", "enable", false, Security::RobloxScript);
+Reflection::BoundFuncDesc<ScriptContext, void(int)> func_StartScriptProfiling(&ScriptContext::startScriptProfiling, "StartScriptProfiling", "frequency", 1000, Security::RobloxScript);
+Reflection::BoundFuncDesc<ScriptContext, std::string()> func_StopScriptProfiling(&ScriptContext::stopScriptProfiling, "StopScriptProfiling", Security::RobloxScript);
 
 // Experimental event for error-reporting
 Reflection::EventDesc<ScriptContext, void(std::string, std::string, shared_ptr<Instance>)> event_Error(&ScriptContext::errorSignal, "Error", "message", "stackTrace", "script", Security::None);
@@ -496,6 +501,9 @@ void ScriptContext::hook(lua_State *L, lua_Debug *ar)
         {
             ScriptContext& context(getContext(L));
 
+            if (context.sampleProfiler)
+                context.sampleProfiler->hook(L);
+
             FASTLOG1(FLog::ScriptContext, "ScriptContext::hook, timeout count %d", static_cast<int>(context.timedoutCount));
 
             if (context.timedoutCount>0)
@@ -1065,6 +1073,9 @@ ScriptContext::ScriptContext()
 {
 	setName("Script Context");
 
+	if (DFFlag::LuaMemberLookupCache)
+		memberLookupCache.reset(new Lua::MemberLookupCache());
+
 	camelCaseViolationConnection = camelCaseViolation.connect(boost::bind(&ScriptContext::onCamelCaseViolation, this, _1, _2, _3));
 }
 
@@ -2667,6 +2678,22 @@ void ScriptContext::setCollectScriptStats(bool enabled)
 		scriptStats.reset();
 }
 
+void ScriptContext::startScriptProfiling(int frequency)
+{
+	// Restarting throws away what was collected so far
+	sampleProfiler.reset(new Lua::SampleProfiler(frequency));
+}
+
+std::string ScriptContext::stopScriptProfiling()
+{
+	if (!sampleProfiler)
+		return "";
+
+	std::string result = sampleProfiler->getFoldedStacks();
+	sampleProfiler.reset();
+	return result;
+}
+
 void ScriptContext::onServiceProvider(ServiceProvider* oldProvider, ServiceProvider* newProvider)
 {
 	heartbeatConnection.disconnect();
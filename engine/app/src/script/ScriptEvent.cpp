@@ -10,13 +10,20 @@
 #include "FastLog.h"
 
 DYNAMIC_FASTFLAGVARIABLE(FixYieldThrottling, false)
+DYNAMIC_FASTFLAGVARIABLE(LuaWaitTimerWheel, false)
+DYNAMIC_FASTINTVARIABLE(LuaWaitTimerWheelResolutionMs, 10)
 
 using namespace RBX;
 using namespace RBX::Lua;
 
 YieldingThreads::YieldingThreads(ScriptContext* context)
 	:context(context)
+	,readyThreadsHead(0)
+	,resumeLag(0.05)
 {
+	if (DFFlag::LuaWaitTimerWheel)
+		timerWheel.reset(new WaitTimerWheel(RBX::Time::now<RBX::Time::Precise>(),
+			RBX::Time::Interval(std::max(1, DFInt::LuaWaitTimerWheelResolutionMs) / 1000.0)));
 }
 
 
@@ -31,56 +38,90 @@ void YieldingThreads::queueWaiter(lua_State *L, LUA_NUMBER delay)
 	RBXASSERT(!RobloxExtraSpace::get(L)->yieldCaptured);
 	RobloxExtraSpace::get(L)->yieldCaptured = true;
 
-	waitingThreads.push(WaitingThread(L, RBX::Time::Interval(delay)));
+	WaitingThread w(L, RBX::Time::Interval(delay));
+	if (timerWheel)
+		timerWheel->insert(w.resumeTime, w);
+	else
+		waitingThreads.push(w);
 }
 
 std::size_t YieldingThreads::waiterCount() const
 {
+	if (timerWheel)
+		return timerWheel->size() + readyThreads.size() - readyThreadsHead;
+
 	return waitingThreads.size();
 }
 
-
-void YieldingThreads::resume(double wallTime, Time expirationTime, bool& throttling)
+bool YieldingThreads::resumeThread(const WaitingThread& w, double wallTime, Time expirationTime, bool& throttling)
 {
-	FASTLOG(FLog::ScriptContext, "Resuming waiting threads");
+	RBX::Time now = RBX::Time::now<RBX::Time::Precise>();
 
-	int count = waitingThreads.size();
+	RBX::Time::Interval elapsedTime = now - w.waitTime;
+	resumeLag.sample((now - w.resumeTime).seconds());
 
-	while ((!DFFlag::FixYieldThrottling || count-- > 0) && !waitingThreads.empty())
+	if (ThreadRef thread = w.thread->lock())
 	{
-		RBX::Time now = RBX::Time::now<RBX::Time::Precise>();
+		lua_pushnumber(thread, elapsedTime.seconds());
+		lua_pushnumber(thread, wallTime);
 
-		const WaitingThread& w = waitingThreads.top();
+		// resume the waiting thread
+		if (context->resume(thread, 2) != ScriptContext::Yield)
+		{
+			// success or error means thread is finished, clear the stack
+			lua_resetstack(thread, 0);
+		}
 
-		if (now < w.resumeTime)
-			break;	// we're done
+		context->scriptResumedFromEvent();
+	}
 
-		RBX::Time::Interval elapsedTime = now - w.waitTime;
-		ThreadRef thread = w.thread->lock();
+	// We always do at least one thread, so as to make forward progress
+	if (now > expirationTime)
+	{
+		throttling = true;
+		return false;
+	}
 
-		waitingThreads.pop();
+	return true;
+}
 
-		if (thread)
-		{
-			lua_pushnumber(thread, elapsedTime.seconds());
-			lua_pushnumber(thread, wallTime);
 
-			// resume the waiting thread
-			if (context->resume(thread, 2) != ScriptContext::Yield)
-			{
-				// success or error means thread is finished, clear the stack
-				lua_resetstack(thread, 0);
-			}
+void YieldingThreads::resume(double wallTime, Time expirationTime, bool& throttling)
+{
+	FASTLOG(FLog::ScriptContext, "Resuming waiting threads");
+
+	if (timerWheel)
+	{
+		// Threads that wait again while we resume go back into the wheel, so each thread resumes at most once per call
+		timerWheel->advance(RBX::Time::now<RBX::Time::Precise>(), readyThreads);
 
-			context->scriptResumedFromEvent();
+		while (readyThreadsHead < readyThreads.size())
+		{
+			WaitingThread w = readyThreads[readyThreadsHead++].value;
+			if (!resumeThread(w, wallTime, expirationTime, throttling))
+				break;
 		}
 
-		// We always do at least one thread, so as to make forward progress
-		if (now > expirationTime)
+		if (readyThreadsHead == readyThreads.size())
 		{
-			throttling = true;
-			break;
+			readyThreads.clear();
+			readyThreadsHead = 0;
 		}
+		return;
+	}
+
+	int count = waitingThreads.size();
+
+	while ((!DFFlag::FixYieldThrottling || count-- > 0) && !waitingThreads.empty())
+	{
+		if (RBX::Time::now<RBX::Time::Precise>() < waitingThreads.top().resumeTime)
+			break;	// we're done
+
+		WaitingThread w = waitingThreads.top();
+		waitingThreads.pop();
+
+		if (!resumeThread(w, wallTime, expirationTime, throttling))
+			break;
 	}
 }
 
@@ -88,6 +129,11 @@ void YieldingThreads::clearAllSinks()
 {
 	while (!waitingThreads.empty())
 		waitingThreads.pop();
+
+	if (timerWheel)
+		timerWheel->clear();
+	readyThreads.clear();
+	readyThreadsHead = 0;
 }
 
 namespace RBX
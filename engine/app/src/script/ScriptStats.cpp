@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "script/ScriptStats.h"
 #include "script/ScriptEvent.h"
+#include "script/LuaSampleProfiler.h"
 
 namespace RBX
 {
@@ -65,6 +66,9 @@ namespace RBX
 
 		resumedThreads = createChildItem("ThreadsResumed");
 		deferredThreads = createBoundChildItem("ThreadsThrottled", scriptContext->throttlingThreads);
+		waitingThreads = createChildItem("ThreadsWaiting");
+		waitResumeLag = createChildItem("WaitResumeLag");
+		profilerSamples = createChildItem("ProfilerSamples");
 
 		averageGcInterval = createChildItem("AverageGcInterval");
 		averageGcTime = createChildItem("AverageGcTime");
@@ -75,6 +79,17 @@ namespace RBX
 		averageGcInterval->formatValue(scriptContext->getAvgLuaGcInterval(), "%.2f msec", scriptContext->getAvgLuaGcInterval());
 		averageGcTime->formatValue(scriptContext->getAvgLuaGcTime(), "%.4f msec", scriptContext->getAvgLuaGcTime());
 		resumedThreads->formatRate(scriptContext->resumedThreads);
+
+		if (Lua::YieldingThreads* yieldEvent = scriptContext->yieldEvent.get())
+		{
+			waitingThreads->formatValue(yieldEvent->waiterCount());
+			waitResumeLag->formatValue(yieldEvent->averageResumeLag(), "%.2f msec", 1000.0 * yieldEvent->averageResumeLag());
+		}
+
+		if (Lua::SampleProfiler* profiler = scriptContext->sampleProfiler.get())
+			profilerSamples->formatValue(profiler->getSampleCount(), "%d samples, %d stacks", (int)profiler->getSampleCount(), (int)profiler->getStackCount());
+		else
+			profilerSamples->formatValue(0, "off");
 	}
 
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "FastLog.h"
 #include "g3d/g3dmath.h"
 #include "rbx/ArrayDynamic.h"
+#include "util/WorkStealingPool.h"
 
 #include "boost/functional/hash.hpp"
 
@@ -25,6 +26,10 @@ FASTFLAGVARIABLE(PGSSolverFileDump, false)
 DYNAMIC_FASTFLAGVARIABLE(PGSSolverSimIslandsEnabled, false)
 DYNAMIC_FASTFLAGVARIABLE(PGSSolverUsesIslandizableCode, false)
 DYNAMIC_FASTFLAGVARIABLE(PGSSolverIntegrateOnlyPositionsEnabled, false)
+DYNAMIC_FASTFLAGVARIABLE(PGSSolverParallelIslandsEnabled, false)
+DYNAMIC_FASTINTVARIABLE(PGSSolverBatchedIslandMinConstraints, 512)
+DYNAMIC_FASTFLAGVARIABLE(PGSSolverSIMDCollisionLanesEnabled, false)
+DYNAMIC_FASTINTVARIABLE(PGSSolverSIMDLanesMinConstraints, 64)
 FASTFLAG(PhysicsAnalyzerEnabled)
 
 namespace RBX
@@ -429,7 +434,9 @@ PGSSolver::PGSSolver(): constraintUIDGenerator( 0 ),
     writeCacheProfiler( sampleCount, "  PGS Write constraint cache: %.3fms" ),
     solverProfiler( sampleCount, "PGS Solver total: %.2fms" ),
     dumpLogSwitch( false ),
-    userId( 0 )
+    userId( 0 ),
+    workerPool( NULL ),
+    workerThreadCount( 1 )
 {
 }
 
@@ -818,6 +825,138 @@ static void breakIntoIslands( ArrayDynamic< SimBody* >& _islandSimBodies,
     }
 }
 
+//
+// Constraint batches for the batched kernel of large islands.
+// Constraints are greedily colored so that no two constraints of the same color share a simulated body.
+// Each color becomes a batch that can be solved in parallel. Pure constraints and collisions are colored separately
+// so that, like in the serial kernel, all pure constraints are solved before the collisions in each iteration.
+// Anchored bodies can be shared within a batch: the kernel writes back to them, but their effective masses are zero so
+// the value never changes. Each reference to an anchored body is redirected to a private copy to avoid concurrent writes.
+//
+class ConstraintBatches
+{
+public:
+    ArrayDynamic< boost::uint32_t > constraints;   // constraint indices grouped by batch
+    ArrayDynamic< boost::uint32_t > batchEnds;     // one past the last entry of each batch in 'constraints'
+    ArrayDynamic< boost::uint8_t > independent;    // 0 for the overflow batch of a stage, which has to be solved serially
+    ArrayDynamic< BodyPairIndices > pairs;         // body pairs with anchored bodies redirected to their private copies
+    ArrayDynamic< boost::int32_t > copySources;    // for each private copy, the anchored body it copies
+};
+
+// Colors are tracked as a bit mask per body
+static const boost::uint32_t maxBatchColors = 64;
+
+static void colorConstraintRange( ConstraintBatches& _batches, 
+                                 ArrayDynamic< boost::uint64_t >& _usedColors, 
+                                 ArrayBase< boost::uint8_t >& _colors,
+                                 size_t _begin, size_t _end, size_t _simBodyCount )
+{
+    _usedColors.assign( _usedColors.size(), 0 );
+
+    boost::uint32_t colorSizes[ maxBatchColors + 1 ] = { 0 };
+    for( size_t c = _begin; c < _end; c++ )
+    {
+        const BodyPairIndices& pair = _batches.pairs[ c ];
+        boost::uint64_t used = 0;
+        if( pair.first < (int)_simBodyCount )
+        {
+            used |= _usedColors[ pair.first ];
+        }
+        if( pair.second < (int)_simBodyCount )
+        {
+            used |= _usedColors[ pair.second ];
+        }
+
+        // Lowest free color, or the overflow batch if all colors are taken
+        boost::uint32_t color = 0;
+        while( color < maxBatchColors && ( used & ( boost::uint64_t( 1 ) << color ) ) )
+        {
+            color++;
+        }
+
+        if( color < maxBatchColors )
+        {
+            boost::uint64_t bit = boost::uint64_t( 1 ) << color;
+            if( pair.first < (int)_simBodyCount )
+            {
+                _usedColors[ pair.first ] |= bit;
+            }
+            if( pair.second < (int)_simBodyCount )
+            {
+                _usedColors[ pair.second ] |= bit;
+            }
+        }
+
+        _colors[ c ] = (boost::uint8_t)color;
+        colorSizes[ color ]++;
+    }
+
+    // Lay out the batches in color order, keeping the original order within a batch
+    boost::uint32_t batchStart[ maxBatchColors + 1 ];
+    boost::uint32_t start = (boost::uint32_t)_batches.constraints.size();
+    for( boost::uint32_t color = 0; color <= maxBatchColors; color++ )
+    {
+        batchStart[ color ] = start;
+        start += colorSizes[ color ];
+        if( colorSizes[ color ] > 0 )
+        {
+            _batches.batchEnds.push_back( start );
+            _batches.independent.push_back( color < maxBatchColors ? 1 : 0 );
+        }
+    }
+
+    _batches.constraints.resize( start );
+    for( size_t c = _begin; c < _end; c++ )
+    {
+        _batches.constraints[ batchStart[ _colors[ c ] ]++ ] = (boost::uint32_t)c;
+    }
+}
+
+static void buildConstraintBatches( ConstraintBatches& _batches, 
+                                   const ArrayBase< BodyPairIndices >& _pairs, 
+                                   size_t _pureConstraintCount, 
+                                   size_t _simBodyCount, 
+                                   size_t _bodyCount )
+{
+    RBXPROFILER_SCOPE("Physics", "buildConstraintBatches");
+
+    // Redirect the anchored bodies to private copies, stored after all the bodies
+    _batches.pairs.reserve( _pairs.size() );
+    for( size_t c = 0; c < _pairs.size(); c++ )
+    {
+        BodyPairIndices pair = _pairs[ c ];
+        if( pair.first >= (int)_simBodyCount )
+        {
+            _batches.copySources.push_back( pair.first );
+            pair.first = (int)( _bodyCount + _batches.copySources.size() - 1 );
+        }
+        if( pair.second >= (int)_simBodyCount )
+        {
+            _batches.copySources.push_back( pair.second );
+            pair.second = (int)( _bodyCount + _batches.copySources.size() - 1 );
+        }
+        _batches.pairs.push_back( pair );
+    }
+
+    ArrayDynamic< boost::uint64_t > usedColors( _simBodyCount, ArrayNoInit() );
+    ArrayDynamic< boost::uint8_t > colors( _pairs.size(), ArrayNoInit() );
+    _batches.constraints.reserve( _pairs.size() );
+    colorConstraintRange( _batches, usedColors, colors, 0, _pureConstraintCount, _simBodyCount );
+    colorConstraintRange( _batches, usedColors, colors, _pureConstraintCount, _pairs.size(), _simBodyCount );
+}
+
+bool PGSSolver::canSolveIslandsInParallel( const SolverConfig& _solverConfig ) const
+{
+#ifdef ENABLE_SOLVER_PROFILER
+    // The stage profilers accumulate into members shared by all the islands
+    return false;
+#else
+    // The inconsistency detector and the debug serializer append to shared state in island order
+    return DFFlag::PGSSolverParallelIslandsEnabled && workerPool != NULL && workerThreadCount > 1 &&
+        !_solverConfig.inconsistentConstraintDetectorEnabled && !serializer.enabled;
+#endif
+}
+
 void PGSSolver::solve( const std::vector< ContactConnector* >& _contactConnectors, float _dt, boost::uint64_t debugTime, bool _throttled )
 {
     inconsistentBodyPairs.clear();
@@ -840,6 +979,7 @@ void PGSSolver::solve( const std::vector< ContactConnector* >& _contactConnector
         {
             static SolverConfig solverConfigDefault( SolverConfig::Type_Default );
             solverConfigDefault.useSimIslands = DFFlag::PGSSolverSimIslandsEnabled;
+            solverConfigDefault.simdCollisionLanes = DFFlag::PGSSolverSIMDCollisionLanesEnabled;
             PGSSolver::solveInternal(_contactConnectors, _dt, debugTime, _throttled, solverConfigDefault);
         }
     }
@@ -936,16 +1076,70 @@ void PGSSolver::solveInternal( const std::vector< ContactConnector* >& _contactC
             inconsistentBodies.reserve( islandSizes.size() );
         }
 
-        // Dispatch the solve tasks
+        // Islands share no simulated body, so they can be solved in any order.
+        // Large islands use the pool for their own batches and are solved one after the other, 
+        // the rest are spread across the pool.
+        bool parallel = canSolveIslandsInParallel( solverConfig );
+        if( parallel )
+        {
+            // Solving an island writes into the body cache: create the entries up front so that no insertion happens concurrently
+            for( auto b : islandBodies )
+            {
+                bodyCache[ b->getUID() ];
+            }
+
+            // Anchored bodies are shared between islands: bring them up to date before the islands read them concurrently
+            for( auto c : islandConstraints )
+            {
+                SimBody* simBodyA = c->getBodyA()->getRootSimBody();
+                if( simBodyA != NULL )
+                {
+                    simBodyA->updateIfDirty();
+                }
+                SimBody* simBodyB = c->getBodyB() != NULL ? c->getBodyB()->getRootSimBody() : NULL;
+                if( simBodyB != NULL )
+                {
+                    simBodyB->updateIfDirty();
+                }
+            }
+        }
+
+        ArrayDynamic< boost::uint32_t > islandBodyOffsets( islandSizes.size(), ArrayNoInit() );
+        ArrayDynamic< boost::uint32_t > islandConstraintOffsets( islandSizes.size(), ArrayNoInit() );
+        ArrayDynamic< boost::uint32_t > deferredIslands;
         size_t constraintIndex = 0;
         size_t simBodyIndex = 0;
         for( size_t i = 0; i < islandSizes.size(); i++ )
         {
-            ArrayRef< SimBody* > simBodiesRef( islandBodies.begin() + simBodyIndex, islandSizes[ i ].first );
+            islandBodyOffsets[ i ] = (boost::uint32_t)simBodyIndex;
+            islandConstraintOffsets[ i ] = (boost::uint32_t)constraintIndex;
             simBodyIndex += islandSizes[ i ].first;
-            ArrayRef< Constraint* > constraintsRef( islandConstraints.begin() + constraintIndex, islandSizes[ i ].second );
             constraintIndex += islandSizes[ i ].second;
-            solveIsland( constraintsRef, simBodiesRef,  _dt, solverConfig );
+
+            if( parallel && islandSizes[ i ].second < (boost::uint32_t)DFInt::PGSSolverBatchedIslandMinConstraints )
+            {
+                deferredIslands.push_back( (boost::uint32_t)i );
+                continue;
+            }
+
+            ArrayRef< SimBody* > simBodiesRef( islandBodies.begin() + islandBodyOffsets[ i ], islandSizes[ i ].first );
+            ArrayRef< Constraint* > constraintsRef( islandConstraints.begin() + islandConstraintOffsets[ i ], islandSizes[ i ].second );
+            solveIsland( constraintsRef, simBodiesRef, _dt, solverConfig, parallel ? workerPool : NULL );
+        }
+
+        if( deferredIslands.size() > 0 )
+        {
+            RBXPROFILER_SCOPE("Physics", "solveIslandsParallel");
+            workerPool->parallelFor( deferredIslands.size(), 1, [&]( size_t _begin, size_t _end )
+            {
+                for( size_t k = _begin; k < _end; k++ )
+                {
+                    boost::uint32_t i = deferredIslands[ k ];
+                    ArrayRef< SimBody* > simBodiesRef( islandBodies.begin() + islandBodyOffsets[ i ], islandSizes[ i ].first );
+                    ArrayRef< Constraint* > constraintsRef( islandConstraints.begin() + islandConstraintOffsets[ i ], islandSizes[ i ].second );
+                    solveIsland( constraintsRef, simBodiesRef, _dt, solverConfig, NULL );
+                }
+            }, workerThreadCount );
         }
     }
     else
@@ -956,7 +1150,7 @@ void PGSSolver::solveInternal( const std::vector< ContactConnector* >& _contactC
         {
             simBodyArray.push_back( b );
         }
-        solveIsland( constraints, simBodyArray, _dt, solverConfig );
+        solveIsland( constraints, simBodyArray, _dt, solverConfig, canSolveIslandsInParallel( solverConfig ) ? workerPool : NULL );
     }
 
     solverProfiler.end();
@@ -980,7 +1174,8 @@ void PGSSolver::solveInternal( const std::vector< ContactConnector* >& _contactC
 void PGSSolver::solveIsland( const ArrayDynamic< Constraint* >& _constraints, 
                             const ArrayDynamic< SimBody* >& _simBodies, 
                             float _dt, 
-                            const SolverConfig& solverConfig )
+                            const SolverConfig& solverConfig,
+                            WorkStealingPool* _batchPool )
 {
     // Align to cache lines
     int defaultAlignment = 64;
@@ -1011,6 +1206,17 @@ void PGSSolver::solveIsland( const ArrayDynamic< Constraint* >& _constraints,
     boost::uint32_t collisionCount = 0;
     auto totalDimension = gatherConstraintPairData(simBodyPairs, dimensions, offsets, anchoredBodyList, bodyIndexation, totalBlockSize, collisionCount, _constraints );
 
+    // Large islands are solved in batches of independent constraints, which can be split across threads or SIMD lanes.
+    // This only depends on the island, not on the thread count, so the results are the same however many threads are used.
+    bool batched = !solverConfig.inconsistentConstraintDetectorEnabled && 
+        ( ( DFFlag::PGSSolverParallelIslandsEnabled && _constraints.size() >= (size_t)DFInt::PGSSolverBatchedIslandMinConstraints ) ||
+          ( solverConfig.simdCollisionLanes && _constraints.size() >= (size_t)DFInt::PGSSolverSIMDLanesMinConstraints ) );
+    ConstraintBatches batches;
+    if( batched )
+    {
+        buildConstraintBatches( batches, simBodyPairs, _constraints.size() - collisionCount, simBodyList.size(), bodyIndexation.size() );
+    }
+
     //
     // Init sim bodies, integrate velocities
     //
@@ -1027,8 +1233,8 @@ void PGSSolver::solveIsland( const ArrayDynamic< Constraint* >& _constraints,
     integrateVelocitiesProfiler.end();
 
     initAnchoredBodiesProfiler.start();
-    VirtualDisplacementArray velocityDeltasSIMD( bodyIndexation.size(), defaultAlignment );
-    VirtualDisplacementArray positionDeltasSIMD( bodyIndexation.size(), defaultAlignment );
+    VirtualDisplacementArray velocityDeltasSIMD( bodyIndexation.size() + batches.copySources.size(), defaultAlignment );
+    VirtualDisplacementArray positionDeltasSIMD( bodyIndexation.size() + batches.copySources.size(), defaultAlignment );
     velocityDeltasSIMD.reset();
     positionDeltasSIMD.reset();
     initAnchoredObjects(bodyVariableData, bodyStaticData, massAndInertia, effectiveMassMultipliers, velocityDeltasSIMD, positionDeltasSIMD, (int)simBodyList.size(), anchoredBodyList, solverConfig);
@@ -1127,6 +1333,26 @@ void PGSSolver::solveIsland( const ArrayDynamic< Constraint* >& _constraints,
     {
         detectInconsistentConstraints(positionDeltasSIMD, positionStage, jacobians, preconditionedJacobiansPosStage, effectiveMassesPos, sorPos, dimensions, offsets, simBodyPairs, _constraints, collisionCount, solverConfig );
     }
+    else if( batched )
+    {
+        // Fill the private copies of the anchored bodies
+        size_t firstCopy = bodyIndexation.size();
+        for( size_t i = 0; i < batches.copySources.size(); i++ )
+        {
+            velocityDeltasSIMD[ (int)( firstCopy + i ) ] = velocityDeltasSIMD[ batches.copySources[ i ] ];
+            positionDeltasSIMD[ (int)( firstCopy + i ) ] = positionDeltasSIMD[ batches.copySources[ i ] ];
+        }
+
+        PGSSolveKernelBatched(
+            velocityStage.data(), positionStage.data(),
+            velocityDeltasSIMD, positionDeltasSIMD,
+            _constraints.size() - collisionCount,
+            dimensions.data(), offsets.data(), batches.pairs.data(),
+            batches.constraints.data(), batches.batchEnds.data(), batches.independent.data(), batches.batchEnds.size(),
+            preconditionedJacobiansVelStage.data(), preconditionedJacobiansPosStage.data(),
+            effectiveMassesVel.data(), effectiveMassesPos.data(), 
+            _batchPool, workerThreadCount, solverConfig );
+    }
     else
     {
         PGSSolveKernel( 
@@ -101,6 +101,9 @@ SolverConfig::SolverConfig( Type type )
     // Sim islands
     useSimIslands = false;
 
+    // SIMD collision lanes
+    simdCollisionLanes = false;
+
     // Inconsistency detector
     inconsistentConstraintDetectorEnabled = false;
     inconsistentConstraintMaxIterations = 0;
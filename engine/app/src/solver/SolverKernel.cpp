@@ -9,6 +9,7 @@
 #include "g3d/Matrix3.h"
 
 #include "simd/simd.h"
+#include "util/WorkStealingPool.h"
 
 #include "boost/limits.hpp"
 
@@ -885,6 +886,378 @@ void PGSSolveKernel(
     }
 }
 
+//
+// Batched kernel
+//
+
+// Everything a worker needs to update a range of a batch
+class BatchedKernelData
+{
+public:
+    ConstraintVariables* velStage;
+    ConstraintVariables* posStage;
+    VirtualDisplacementPOD* virDVel;
+    VirtualDisplacementPOD* virDPos;
+    size_t pureConstraintCount;
+    const boost::uint8_t* dimensions;
+    const boost::uint32_t* offsets;
+    const BodyPairIndices* pairs;
+    const boost::uint32_t* constraints;
+    const ConstraintJacobianPair* preconditionedJacobiansVel;
+    const ConstraintJacobianPair* preconditionedJacobiansPos;
+    const EffectiveMassPair* effectiveMassesVel;
+    const EffectiveMassPair* effectiveMassesPos;
+};
+
+static void updateBatchedConstraints( const BatchedKernelData& _data, size_t _begin, size_t _end )
+{
+    for( size_t i = _begin; i < _end; i++ )
+    {
+        boost::uint32_t c = _data.constraints[ i ];
+        boost::uint32_t offset = _data.offsets[ c ];
+        const ConstraintJacobianPair* precondJacobianVel = _data.preconditionedJacobiansVel + offset;
+        const ConstraintJacobianPair* precondJacobianPos = _data.preconditionedJacobiansPos + offset;
+        const EffectiveMassPair* effMassesVel = _data.effectiveMassesVel + offset;
+        const EffectiveMassPair* effMassesPos = _data.effectiveMassesPos + offset;
+        ConstraintVariables* velStage = _data.velStage + offset;
+        ConstraintVariables* posStage = _data.posStage + offset;
+
+        if( c >= _data.pureConstraintCount )
+        {
+            updateConstraintDim3OrCollision< CollisionType >( velStage, posStage, _data.virDVel, _data.virDPos, precondJacobianVel, precondJacobianPos, effMassesVel, effMassesPos, _data.pairs[c] );
+            continue;
+        }
+
+        switch ( _data.dimensions[ c ] )
+        {
+        case 1:
+            updateConstraintDim1( velStage, posStage, _data.virDVel, _data.virDPos, precondJacobianVel, precondJacobianPos, effMassesVel, effMassesPos, _data.pairs[c] );
+            break;
+        case 2:
+            updateConstraintDim2( velStage, posStage, _data.virDVel, _data.virDPos, precondJacobianVel, precondJacobianPos, effMassesVel, effMassesPos, _data.pairs[c] );
+            break;
+        case 3:
+            updateConstraintDim3OrCollision< ConstraintType >( velStage, posStage, _data.virDVel, _data.virDPos, precondJacobianVel, precondJacobianPos, effMassesVel, effMassesPos, _data.pairs[c] );
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+//
+// SIMD collision lanes
+// Four independent collisions are solved side by side: lane i of every vector belongs to the i-th collision of a group.
+// Instead of vectorizing the xyz components of one row, each vector holds the same component of four rows,
+// so the projections and the impulse updates of four collisions take the instructions of one.
+// The arithmetic is done in the same order as updateConstraintDim3OrCollision< CollisionType > so both give the same results.
+//
+static const size_t collisionLaneCount = 4;
+
+class CollisionLanesStage
+{
+public:
+    // Preconditioned Jacobians and effective masses per row, component by component:
+    // linA.xyz, angA.xyz, linB.xyz, angB.xyz
+    v4f_pod jacobians[ 3 ][ 12 ];
+    v4f_pod effectiveMasses[ 3 ][ 12 ];
+    v4f_pod reactions[ 3 ];
+    v4f_pod minImpulses[ 3 ];
+    v4f_pod maxImpulses[ 3 ];
+    v4f_pod impulses[ 3 ];
+};
+
+class CollisionLanes
+{
+public:
+    CollisionLanesStage velStage;
+    CollisionLanesStage posStage;
+    boost::int32_t bodiesA[ collisionLaneCount ];
+    boost::int32_t bodiesB[ collisionLaneCount ];
+    boost::uint32_t offsets[ collisionLaneCount ];
+};
+
+static void packCollisionLanesStage( CollisionLanesStage& _lanes, 
+                                    const ConstraintVariables* _vars,
+                                    const ConstraintJacobianPair* _jacobians,
+                                    const EffectiveMassPair* _effectiveMasses,
+                                    const boost::uint32_t* _offsets )
+{
+    for( int r = 0; r < 3; r++ )
+    {
+        const ConstraintJacobianPair* j[ collisionLaneCount ];
+        const EffectiveMassPair* m[ collisionLaneCount ];
+        for( size_t i = 0; i < collisionLaneCount; i++ )
+        {
+            j[ i ] = _jacobians + _offsets[ i ] + r;
+            m[ i ] = _effectiveMasses + _offsets[ i ] + r;
+        }
+
+        v4f x, y, z;
+        transpose4x3( x, y, z, j[0]->getLinA(), j[1]->getLinA(), j[2]->getLinA(), j[3]->getLinA() );
+        _lanes.jacobians[ r ][ 0 ] = x; _lanes.jacobians[ r ][ 1 ] = y; _lanes.jacobians[ r ][ 2 ] = z;
+        transpose4x3( x, y, z, j[0]->getAngA(), j[1]->getAngA(), j[2]->getAngA(), j[3]->getAngA() );
+        _lanes.jacobians[ r ][ 3 ] = x; _lanes.jacobians[ r ][ 4 ] = y; _lanes.jacobians[ r ][ 5 ] = z;
+        transpose4x3( x, y, z, j[0]->getLinB(), j[1]->getLinB(), j[2]->getLinB(), j[3]->getLinB() );
+        _lanes.jacobians[ r ][ 6 ] = x; _lanes.jacobians[ r ][ 7 ] = y; _lanes.jacobians[ r ][ 8 ] = z;
+        transpose4x3( x, y, z, j[0]->getAngB(), j[1]->getAngB(), j[2]->getAngB(), j[3]->getAngB() );
+        _lanes.jacobians[ r ][ 9 ] = x; _lanes.jacobians[ r ][ 10 ] = y; _lanes.jacobians[ r ][ 11 ] = z;
+
+        transpose4x3( x, y, z, m[0]->getLinA(), m[1]->getLinA(), m[2]->getLinA(), m[3]->getLinA() );
+        _lanes.effectiveMasses[ r ][ 0 ] = x; _lanes.effectiveMasses[ r ][ 1 ] = y; _lanes.effectiveMasses[ r ][ 2 ] = z;
+        transpose4x3( x, y, z, m[0]->getAngA(), m[1]->getAngA(), m[2]->getAngA(), m[3]->getAngA() );
+        _lanes.effectiveMasses[ r ][ 3 ] = x; _lanes.effectiveMasses[ r ][ 4 ] = y; _lanes.effectiveMasses[ r ][ 5 ] = z;
+        transpose4x3( x, y, z, m[0]->getLinB(), m[1]->getLinB(), m[2]->getLinB(), m[3]->getLinB() );
+        _lanes.effectiveMasses[ r ][ 6 ] = x; _lanes.effectiveMasses[ r ][ 7 ] = y; _lanes.effectiveMasses[ r ][ 8 ] = z;
+        transpose4x3( x, y, z, m[0]->getAngB(), m[1]->getAngB(), m[2]->getAngB(), m[3]->getAngB() );
+        _lanes.effectiveMasses[ r ][ 9 ] = x; _lanes.effectiveMasses[ r ][ 10 ] = y; _lanes.effectiveMasses[ r ][ 11 ] = z;
+
+        v4f minImpulses, maxImpulses, reactions, impulses;
+        transpose( minImpulses, maxImpulses, reactions, impulses, 
+            v4f( _vars[ _offsets[0] + r ].v ), v4f( _vars[ _offsets[1] + r ].v ), v4f( _vars[ _offsets[2] + r ].v ), v4f( _vars[ _offsets[3] + r ].v ) );
+        _lanes.minImpulses[ r ] = minImpulses;
+        _lanes.maxImpulses[ r ] = maxImpulses;
+        _lanes.reactions[ r ] = reactions;
+        _lanes.impulses[ r ] = impulses;
+    }
+}
+
+static void unpackCollisionLanesImpulses( ConstraintVariables* _vars, const CollisionLanesStage& _lanes, const boost::uint32_t* _offsets )
+{
+    for( int r = 0; r < 3; r++ )
+    {
+        float impulses[ collisionLaneCount ];
+        storeUnaligned( impulses, v4f( _lanes.impulses[ r ] ) );
+        for( size_t i = 0; i < collisionLaneCount; i++ )
+        {
+            _vars[ _offsets[ i ] + r ].impulse = impulses[ i ];
+        }
+    }
+}
+
+static RBX_SIMD_INLINE void updateCollisionLanesStage( CollisionLanesStage& _lanes, 
+                                                      VirtualDisplacementPOD* __restrict _virD, 
+                                                      const boost::int32_t* _bodiesA, 
+                                                      const boost::int32_t* _bodiesB )
+{
+    // Gather the virtual displacements of the bodies, one component per vector. The w components are carried along untouched.
+    v4f linA[ 3 ], angA[ 3 ], linB[ 3 ], angB[ 3 ], linAW, angAW, linBW, angBW;
+    transpose( linA[0], linA[1], linA[2], linAW, v4f( _virD[ _bodiesA[0] ].linV4 ), v4f( _virD[ _bodiesA[1] ].linV4 ), v4f( _virD[ _bodiesA[2] ].linV4 ), v4f( _virD[ _bodiesA[3] ].linV4 ) );
+    transpose( angA[0], angA[1], angA[2], angAW, v4f( _virD[ _bodiesA[0] ].angV4 ), v4f( _virD[ _bodiesA[1] ].angV4 ), v4f( _virD[ _bodiesA[2] ].angV4 ), v4f( _virD[ _bodiesA[3] ].angV4 ) );
+    transpose( linB[0], linB[1], linB[2], linBW, v4f( _virD[ _bodiesB[0] ].linV4 ), v4f( _virD[ _bodiesB[1] ].linV4 ), v4f( _virD[ _bodiesB[2] ].linV4 ), v4f( _virD[ _bodiesB[3] ].linV4 ) );
+    transpose( angB[0], angB[1], angB[2], angBW, v4f( _virD[ _bodiesB[0] ].angV4 ), v4f( _virD[ _bodiesB[1] ].angV4 ), v4f( _virD[ _bodiesB[2] ].angV4 ), v4f( _virD[ _bodiesB[3] ].angV4 ) );
+
+    // Project the virtual displacements onto the preconditioned Jacobians of the three rows
+    // Same order of operations as partiallyProjectOntoJacobian followed by sumAcross3
+    v4f projectedVirD[ 3 ];
+    for( int r = 0; r < 3; r++ )
+    {
+        const v4f_pod* j = _lanes.jacobians[ r ];
+        v4f components[ 3 ];
+        for( int k = 0; k < 3; k++ )
+        {
+            v4f partA = v4f( j[ k ] ) * linA[ k ] + v4f( j[ 3 + k ] ) * angA[ k ];
+            v4f partB = v4f( j[ 6 + k ] ) * linB[ k ] + v4f( j[ 9 + k ] ) * angB[ k ];
+            components[ k ] = partA + partB;
+        }
+        projectedVirD[ r ] = ( components[ 0 ] + components[ 1 ] ) + components[ 2 ];
+    }
+
+    // Compute and clamp the new impulses. The friction bounds scale with the old normal impulse.
+    v4f normalImpulse = _lanes.impulses[ 0 ];
+    v4f dImpulses[ 3 ];
+    for( int r = 0; r < 3; r++ )
+    {
+        v4f oldImpulse = _lanes.impulses[ r ];
+        v4f minImpulse = _lanes.minImpulses[ r ];
+        v4f maxImpulse = _lanes.maxImpulses[ r ];
+        if( r > 0 )
+        {
+            minImpulse = minImpulse * normalImpulse;
+            maxImpulse = maxImpulse * normalImpulse;
+        }
+
+        v4f newImpulse = oldImpulse + ( v4f( _lanes.reactions[ r ] ) - projectedVirD[ r ] );
+        newImpulse = max( newImpulse, minImpulse );
+        newImpulse = min( newImpulse, maxImpulse );
+
+        dImpulses[ r ] = newImpulse - oldImpulse;
+        _lanes.impulses[ r ] = newImpulse;
+    }
+
+    // Modify the virtual displacements by the change in impulses
+    for( int r = 0; r < 3; r++ )
+    {
+        const v4f_pod* m = _lanes.effectiveMasses[ r ];
+        for( int k = 0; k < 3; k++ )
+        {
+            linA[ k ] = mulAdd( linA[ k ], dImpulses[ r ], m[ k ] );
+            angA[ k ] = mulAdd( angA[ k ], dImpulses[ r ], m[ 3 + k ] );
+            linB[ k ] = mulAdd( linB[ k ], dImpulses[ r ], m[ 6 + k ] );
+            angB[ k ] = mulAdd( angB[ k ], dImpulses[ r ], m[ 9 + k ] );
+        }
+    }
+
+    // Scatter back. The bodies of a group are all distinct.
+    v4f r0, r1, r2, r3;
+    transpose( r0, r1, r2, r3, linA[0], linA[1], linA[2], linAW );
+    _virD[ _bodiesA[0] ].linV4 = r0; _virD[ _bodiesA[1] ].linV4 = r1; _virD[ _bodiesA[2] ].linV4 = r2; _virD[ _bodiesA[3] ].linV4 = r3;
+    transpose( r0, r1, r2, r3, angA[0], angA[1], angA[2], angAW );
+    _virD[ _bodiesA[0] ].angV4 = r0; _virD[ _bodiesA[1] ].angV4 = r1; _virD[ _bodiesA[2] ].angV4 = r2; _virD[ _bodiesA[3] ].angV4 = r3;
+    transpose( r0, r1, r2, r3, linB[0], linB[1], linB[2], linBW );
+    _virD[ _bodiesB[0] ].linV4 = r0; _virD[ _bodiesB[1] ].linV4 = r1; _virD[ _bodiesB[2] ].linV4 = r2; _virD[ _bodiesB[3] ].linV4 = r3;
+    transpose( r0, r1, r2, r3, angB[0], angB[1], angB[2], angBW );
+    _virD[ _bodiesB[0] ].angV4 = r0; _virD[ _bodiesB[1] ].angV4 = r1; _virD[ _bodiesB[2] ].angV4 = r2; _virD[ _bodiesB[3] ].angV4 = r3;
+}
+
+static void updateCollisionLanes( CollisionLanes* _lanes, const BatchedKernelData& _data, size_t _begin, size_t _end )
+{
+    for( size_t i = _begin; i < _end; i++ )
+    {
+        updateCollisionLanesStage( _lanes[ i ].velStage, _data.virDVel, _lanes[ i ].bodiesA, _lanes[ i ].bodiesB );
+        updateCollisionLanesStage( _lanes[ i ].posStage, _data.virDPos, _lanes[ i ].bodiesA, _lanes[ i ].bodiesB );
+    }
+}
+
+// Splitting a batch into chunks smaller than this costs more in synchronization than it saves
+static const size_t batchGrainSize = 64;
+
+void PGSSolveKernelBatched(
+    ConstraintVariables* __restrict _velStage,
+    ConstraintVariables* __restrict _posStage,
+    VirtualDisplacementArray& _virDVel,
+    VirtualDisplacementArray& _virDPos,
+    size_t _pureConstraintCount,
+    const boost::uint8_t* _dimensions, 
+    const boost::uint32_t* _offsets,
+    const BodyPairIndices* _pairs,
+    const boost::uint32_t* _batchedConstraints,
+    const boost::uint32_t* _batchEnds,
+    const boost::uint8_t* _batchIndependent,
+    size_t _batchCount,
+    const ConstraintJacobianPair* _preconditionedJacobiansVelStage, 
+    const ConstraintJacobianPair* _preconditionedJacobiansPosStage, 
+    const EffectiveMassPair* _effectiveMassesVelStage,
+    const EffectiveMassPair* _effectiveMassesPosStage,
+    WorkStealingPool* _pool,
+    int _threadCount,
+    const SolverConfig& _config )
+{
+    RBXPROFILER_SCOPE("Physics", "PGSSolveKernelBatched");
+
+    BatchedKernelData data;
+    data.velStage = _velStage;
+    data.posStage = _posStage;
+    data.virDVel = _virDVel.getData();
+    data.virDPos = _virDPos.getData();
+    data.pureConstraintCount = _pureConstraintCount;
+    data.dimensions = _dimensions;
+    data.offsets = _offsets;
+    data.pairs = _pairs;
+    data.constraints = _batchedConstraints;
+    data.preconditionedJacobiansVel = _preconditionedJacobiansVelStage;
+    data.preconditionedJacobiansPos = _preconditionedJacobiansPosStage;
+    data.effectiveMassesVel = _effectiveMassesVelStage;
+    data.effectiveMassesPos = _effectiveMassesPosStage;
+
+    // Pack the collisions of independent batches into SIMD lanes, four by four.
+    // Leftovers that don't fill a group are solved with the scalar code, after the groups of their batch.
+    ArrayDynamic< CollisionLanes > lanes;
+    ArrayDynamic< boost::uint32_t > laneGroupEnds( _batchCount, ArrayNoInit() );
+    {
+        size_t groupCount = 0;
+        boost::uint32_t batchBegin = 0;
+        for( size_t b = 0; b < _batchCount; b++ )
+        {
+            if( _config.simdCollisionLanes && _batchIndependent[ b ] && _batchedConstraints[ batchBegin ] >= _pureConstraintCount )
+            {
+                groupCount += ( _batchEnds[ b ] - batchBegin ) / collisionLaneCount;
+            }
+            laneGroupEnds[ b ] = (boost::uint32_t)groupCount;
+            batchBegin = _batchEnds[ b ];
+        }
+
+        if( groupCount > 0 )
+        {
+            RBXPROFILER_SCOPE("Physics", "packCollisionLanes");
+
+            lanes = ArrayDynamic< CollisionLanes >( groupCount, ArrayNoInit(), 64 );
+            size_t group = 0;
+            batchBegin = 0;
+            for( size_t b = 0; b < _batchCount; b++ )
+            {
+                for( boost::uint32_t i = batchBegin; group < laneGroupEnds[ b ]; i += collisionLaneCount, group++ )
+                {
+                    CollisionLanes& l = lanes[ group ];
+                    for( size_t lane = 0; lane < collisionLaneCount; lane++ )
+                    {
+                        boost::uint32_t c = _batchedConstraints[ i + lane ];
+                        l.bodiesA[ lane ] = _pairs[ c ].first;
+                        l.bodiesB[ lane ] = _pairs[ c ].second;
+                        l.offsets[ lane ] = _offsets[ c ];
+                    }
+                    packCollisionLanesStage( l.velStage, _velStage, _preconditionedJacobiansVelStage, _effectiveMassesVelStage, l.offsets );
+                    packCollisionLanesStage( l.posStage, _posStage, _preconditionedJacobiansPosStage, _effectiveMassesPosStage, l.offsets );
+                }
+                batchBegin = _batchEnds[ b ];
+            }
+        }
+    }
+
+    for( boost::uint32_t k = 0; k < _config.pgsIterations; k++ )
+    {
+        boost::uint32_t batchBegin = 0;
+        boost::uint32_t groupBegin = 0;
+        for( size_t b = 0; b < _batchCount; b++ )
+        {
+            // Constraints of the batch not covered by the lane groups
+            boost::uint32_t scalarBegin = batchBegin + ( laneGroupEnds[ b ] - groupBegin ) * collisionLaneCount;
+            boost::uint32_t batchEnd = _batchEnds[ b ];
+            size_t groupCount = laneGroupEnds[ b ] - groupBegin;
+            size_t scalarCount = batchEnd - scalarBegin;
+
+            if( groupCount > 0 )
+            {
+                CollisionLanes* groups = lanes.data() + groupBegin;
+                if( _pool != NULL && groupCount >= 2 * batchGrainSize / collisionLaneCount )
+                {
+                    _pool->parallelFor( groupCount, batchGrainSize / collisionLaneCount, [&data, groups]( size_t _first, size_t _last )
+                    {
+                        updateCollisionLanes( groups, data, _first, _last );
+                    }, _threadCount );
+                }
+                else
+                {
+                    updateCollisionLanes( groups, data, 0, groupCount );
+                }
+            }
+
+            if( _pool != NULL && _batchIndependent[ b ] && scalarCount >= 2 * batchGrainSize )
+            {
+                const boost::uint32_t begin = scalarBegin;
+                _pool->parallelFor( scalarCount, batchGrainSize, [&data, begin]( size_t _first, size_t _last )
+                {
+                    updateBatchedConstraints( data, begin + _first, begin + _last );
+                }, _threadCount );
+            }
+            else
+            {
+                updateBatchedConstraints( data, scalarBegin, batchEnd );
+            }
+
+            batchBegin = batchEnd;
+            groupBegin = laneGroupEnds[ b ];
+        }
+    }
+
+    // The lanes kept their own copy of the impulses
+    for( size_t i = 0; i < lanes.size(); i++ )
+    {
+        unpackCollisionLanesImpulses( _velStage, lanes[ i ].velStage, lanes[ i ].offsets );
+        unpackCollisionLanesImpulses( _posStage, lanes[ i ].posStage, lanes[ i ].offsets );
+    }
+}
+
 //
 // Single stage inconsistency detector
 //
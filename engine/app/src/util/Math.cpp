@@ -645,10 +645,8 @@ int Math::getOrientId(const Matrix3& matrix)
 	return answer;
 }
 
-void Math::idToMatrix3(int orientId, Matrix3& matrix)
+static void computeOrientIdMatrix3(int orientId, Matrix3& matrix)
 {
-	RBXASSERT_VERY_FAST(legalOrientId(orientId));
-	// TODO: Optimization: Do a table lookup
 	NormalId xNormal = intToNormalId(orientId / 6);
 	NormalId yNormal = intToNormalId(orientId % 6);
 	Vector3 vX = normalIdToVector3(xNormal);
@@ -657,6 +655,32 @@ void Math::idToMatrix3(int orientId, Matrix3& matrix)
 	matrix.setColumn(0, vX);
 	matrix.setColumn(1, vY);
 	matrix.setColumn(2, vZ);
+}
+
+namespace {
+	// All 36 ids, the illegal ones included, so the lookup matches the computed result for any id in range
+	struct OrientIdTable
+	{
+		Matrix3 matrices[36];
+
+		OrientIdTable()
+		{
+			for (int i = 0; i < 36; ++i)
+				computeOrientIdMatrix3(i, matrices[i]);
+		}
+	};
+}
+
+void Math::idToMatrix3(int orientId, Matrix3& matrix)
+{
+	RBXASSERT_VERY_FAST(legalOrientId(orientId));
+
+	static const OrientIdTable table;
+
+	if (orientId >= 0 && orientId < 36)
+		matrix = table.matrices[orientId];
+	else
+		computeOrientIdMatrix3(orientId, matrix);
 
 	RBXASSERT_VERY_FAST(isAxisAligned(matrix));
 }
@@ -70,13 +70,21 @@ Profiler::Profiler(const char* name)
 
 CodeProfiler::CodeProfiler(const char* name)
 	:Profiler(name)
+	,totalWallTime(0)
+	,totalSamples(0)
 {
 }
 
+void CodeProfiler::resetTotals()
+{
+	totalWallTime = 0;
+	totalSamples = 0;
+}
 
 void CodeProfiler::unlog(double wallTimeElapsed)
 {
 	buckets[currentBucket].wallTimeSpan -= wallTimeElapsed;
+	totalWallTime -= wallTimeElapsed;
 }
 
 void CodeProfiler::log(bool frameTick, double wallTimeElapsed)
@@ -103,6 +111,8 @@ void CodeProfiler::log(bool frameTick, double wallTimeElapsed)
 		buckets[currentBucket].wallTimeSpan += wallTimeElapsed;
 	}
 	lastSampleTime = time;
+	totalWallTime += wallTimeElapsed;
+	totalSamples++;
 }
 
 
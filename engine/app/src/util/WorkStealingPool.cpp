@@ -0,0 +1,168 @@
+#include "stdafx.h"
+
+#include "util/WorkStealingPool.h"
+#include "rbx/Debug.h"
+#include "boost/bind.hpp"
+
+namespace RBX
+{
+	WorkStealingPool::WorkStealingPool(int workerCount)
+		:ranges(new Range[std::max(workerCount, 0) + 1])
+		,generation(0)
+		,done(false)
+		,activeWorkers(0)
+		,task(NULL)
+		,grainSize(1)
+		,participants(1)
+	{
+		for (int i = 0; i <= workerCount; ++i)
+		{
+			ranges[i].begin = 0;
+			ranges[i].end = 0;
+		}
+
+		// Participant 0 is always the thread calling parallelFor
+		workers.resize(std::max(workerCount, 0));
+		for (int i = 0; i < workerCount; ++i)
+			workers[i].reset(new boost::thread(boost::bind(&WorkStealingPool::workerLoop, this, i + 1)));
+	}
+
+	WorkStealingPool::~WorkStealingPool()
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			done = true;
+			wakeCondition.notify_all();
+		}
+
+		for (size_t i = 0; i < workers.size(); ++i)
+			workers[i]->join();
+	}
+
+	void WorkStealingPool::parallelFor(size_t count, size_t grain, const Task& t, int maxParticipants)
+	{
+		if (count == 0)
+			return;
+
+		grain = std::max<size_t>(grain, 1);
+		int used = std::min(std::max(maxParticipants, 1), getWorkerCount() + 1);
+		used = (int)std::min<size_t>(used, (count + grain - 1) / grain);
+
+		if (used <= 1)
+		{
+			for (size_t begin = 0; begin < count; begin += grain)
+				t(begin, std::min(count, begin + grain));
+			return;
+		}
+
+		// Hand every participant an equal share up front, stealing evens out the rest
+		for (int i = 0; i < used; ++i)
+		{
+			rbx::spin_mutex::scoped_lock lock(ranges[i].mutex);
+			ranges[i].begin = count * i / used;
+			ranges[i].end = count * (i + 1) / used;
+		}
+
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			RBXASSERT(activeWorkers == 0);
+			task = &t;
+			grainSize = grain;
+			participants = used;
+			activeWorkers = used - 1;
+			++generation;
+			wakeCondition.notify_all();
+		}
+
+		runParticipant(0);
+
+		// Workers may still be running the last chunks they claimed
+		boost::unique_lock<boost::mutex> lock(mutex);
+		while (activeWorkers > 0)
+			finishedCondition.wait(lock);
+
+		task = NULL;
+	}
+
+	void WorkStealingPool::workerLoop(int participant)
+	{
+		RBX::set_thread_name("rbx_WorkStealingPool");
+
+		unsigned int seenGeneration = 0;
+		while (true)
+		{
+			{
+				boost::unique_lock<boost::mutex> lock(mutex);
+				while (!done && generation == seenGeneration)
+					wakeCondition.wait(lock);
+
+				if (done)
+					return;
+
+				seenGeneration = generation;
+				if (participant >= participants)
+					continue;
+			}
+
+			runParticipant(participant);
+
+			boost::unique_lock<boost::mutex> lock(mutex);
+			if (--activeWorkers == 0)
+				finishedCondition.notify_all();
+		}
+	}
+
+	void WorkStealingPool::runParticipant(int participant)
+	{
+		size_t begin, end;
+		while (popLocal(participant, begin, end) || steal(participant, begin, end))
+			(*task)(begin, end);
+	}
+
+	bool WorkStealingPool::popLocal(int participant, size_t& begin, size_t& end)
+	{
+		Range& range = ranges[participant];
+		rbx::spin_mutex::scoped_lock lock(range.mutex);
+		if (range.begin >= range.end)
+			return false;
+
+		begin = range.begin;
+		end = std::min(range.end, range.begin + grainSize);
+		range.begin = end;
+		return true;
+	}
+
+	bool WorkStealingPool::steal(int thief, size_t& begin, size_t& end)
+	{
+		for (int i = 1; i < participants; ++i)
+		{
+			Range& victim = ranges[(thief + i) % participants];
+
+			size_t stolenBegin, stolenEnd;
+			{
+				rbx::spin_mutex::scoped_lock lock(victim.mutex);
+				if (victim.begin >= victim.end)
+					continue;
+
+				size_t remaining = victim.end - victim.begin;
+				size_t take = remaining > grainSize ? remaining / 2 : remaining;
+				stolenEnd = victim.end;
+				stolenBegin = victim.end - take;
+				victim.end = stolenBegin;
+			}
+
+			// Our own range is empty at this point, so the stolen work becomes the new range
+			{
+				rbx::spin_mutex::scoped_lock lock(ranges[thief].mutex);
+				ranges[thief].begin = stolenBegin;
+				ranges[thief].end = stolenEnd;
+			}
+
+			// Another thief may have emptied it already, in which case keep looking
+			if (popLocal(thief, begin, end))
+				return true;
+		}
+
+		return false;
+	}
+}
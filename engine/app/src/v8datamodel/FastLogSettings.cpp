@@ -146,6 +146,8 @@ LOGVARIABLE(MachineIdUploader, 1)
 // RakNet
 LOGVARIABLE(RakNetDisconnect, 0)
 DYNAMIC_FASTINTVARIABLE(RakNetMaxSplitPacketCount, 1400) // about 2MB if packet size is around 1492 bytes (max mtu)
+DYNAMIC_FASTINTVARIABLE(RakNetRecvBatchSize, 1) // datagrams per recvmmsg on Linux, 1 reads them with recvfrom
+DYNAMIC_FASTINTVARIABLE(RakNetSendBatchSize, 1) // datagrams per sendmmsg on Linux, 1 sends them with sendto
 
 LOGVARIABLE(Http, 0)
 
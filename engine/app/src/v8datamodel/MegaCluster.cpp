@@ -31,6 +31,7 @@ LOGVARIABLE(TerrainCellListener, 0)
 
 FASTINTVARIABLE(SmoothTerrainMaxLuaRegion, 4*1024*1024)
 FASTINTVARIABLE(SmoothTerrainMaxCppRegion, 64*1024*1024)
+FASTINTVARIABLE(SmoothTerrainGeometryCacheSize, 8*1024*1024)
 
 namespace RBX
 {
@@ -309,6 +310,7 @@ MegaClusterInstance::MegaClusterInstance()
 
 	// Initialize tables for smooth terrain
 	materialTable.reset(new Voxel2::MaterialTable(ContentProvider::findAsset(kSmoothTerrainMaterials), Voxel2::Cell::Material_Max + 1));
+	geometryCache.reset(new Voxel2::Mesher::GeometryCache(FInt::SmoothTerrainGeometryCacheSize));
 
 	Voxel2::Mesher::prepareTables();
 }
@@ -1579,6 +1581,7 @@ void MegaClusterInstance::reloadMaterialTable()
         return;
 
 	materialTable.reset(new Voxel2::MaterialTable(ContentProvider::findAsset(kSmoothTerrainMaterials), Voxel2::Cell::Material_Max + 1));
+	geometryCache.reset(new Voxel2::Mesher::GeometryCache(FInt::SmoothTerrainGeometryCacheSize));
 
 	Primitive* myPrim = getPartPrimitive();
 
@@ -426,6 +426,7 @@ RBX_REGISTER_CLASS(TouchInputService);
 // network
 RBX_REGISTER_CLASS(Network::PhysicsPacketCache);
 RBX_REGISTER_CLASS(Network::InstancePacketCache);
+RBX_REGISTER_CLASS(Network::PropertyPacketCache);
 RBX_REGISTER_CLASS(Network::ClusterPacketCache);
 RBX_REGISTER_CLASS(Network::OneQuarterClusterPacketCache);
 RBX_REGISTER_CLASS(Network::ChatFilter);
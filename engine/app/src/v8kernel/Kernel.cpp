@@ -9,6 +9,7 @@
 #include "rbx/Debug.h"
 #include "util/Profiling.h"
 #include "util/Units.h"
+#include "util/WorkStealingPool.h"
 #include "rbx/rbxTime.h"
 
 #include "rbx/Profiler.h"
@@ -24,6 +25,7 @@ Kernel::Kernel(IStage* upstream)
 	, inStepCode(false)
 	, profilingKernelBodies(new Profiling::CodeProfiler("Kernel Bodies"))
 	, profilingKernelConnectors(new Profiling::CodeProfiler("Kernel Connectors"))
+	, profilingKernelSolver(new Profiling::CodeProfiler("Kernel Solver"))
 	, kernelData(new KernelData())
 	, maxBodies(0)
 	, error(0.0f)
@@ -195,6 +197,8 @@ void Kernel::step(bool throttling, int numThreads, boost::uint64_t debugTime)
 	RBXASSERT(!inStepCode);
 	inStepCode = true;
 
+	pgsSolver.setWorkerPool(getWorkerPool(numThreads), numThreads);
+
 	if (throttling)
 	{
 		preStepThrottled();
@@ -207,6 +211,20 @@ void Kernel::step(bool throttling, int numThreads, boost::uint64_t debugTime)
 	inStepCode = false;
 }
 
+WorkStealingPool* Kernel::getWorkerPool(int numThreads)
+{
+	// The calling thread is one of the participants
+	int workerCount = std::min(numThreads, (int)boost::thread::hardware_concurrency()) - 1;
+	if (workerCount <= 0)
+		return NULL;
+
+	// Only ever grow the pool, the concurrency allotted by the scheduler can change from step to step
+	if (!workerPool || workerPool->getWorkerCount() < workerCount)
+		workerPool.reset(new WorkStealingPool(workerCount));
+
+	return workerPool.get();
+}
+
 void Kernel::preStep() 
 {
 
@@ -327,7 +345,10 @@ void Kernel::stepWorld( boost::uint64_t debugTime )
             }
         }
 
-        pgsSolver.solve( allContactConnectors, Constants::worldDt(), debugTime, false );
+        {
+            RBX::Profiling::Mark mark( *profilingKernelSolver, false );
+            pgsSolver.solve( allContactConnectors, Constants::worldDt(), debugTime, false );
+        }
     }
 	else // legacy solver
 	{
@@ -462,7 +483,10 @@ void Kernel::stepWorldThrottled( boost::uint64_t debugTime )
             allContactConnectors.push_back( contact );
         }
 
-        pgsSolver.solve( allContactConnectors, Constants::worldDt(), debugTime, true );
+        {
+            RBX::Profiling::Mark mark( *profilingKernelSolver, false );
+            pgsSolver.solve( allContactConnectors, Constants::worldDt(), debugTime, true );
+        }
 	}
 	else
 	{
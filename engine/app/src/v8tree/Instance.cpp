@@ -14,6 +14,7 @@
 LOGVARIABLE(InstanceTreeManipulation, 0)
 
 DYNAMIC_FASTFLAGVARIABLE(LockViolationInstanceCrash, false)
+DYNAMIC_FASTINTVARIABLE(InstanceChildNameIndexThreshold, 0)
 
 namespace RBX {
 
@@ -304,9 +305,9 @@ void Instance::waitForChild(std::string childName, boost::function<void(shared_p
 		errorFunction("WaitForChild called with an empty child name.");
 		return;
 	}
-	if (findFirstChildByName(childName) != NULL)
+	if (Instance* child = findFirstChildByName(childName))
 	{
-		resumeFunction(shared_from(findFirstChildByName(childName)));
+		resumeFunction(shared_from(child));
 		return;
 	}
 
@@ -365,7 +366,22 @@ const Instance* Instance::findConstFirstChildByName(const std::string& findName)
 {
 	if (!children)
 		return NULL;
+
+	if (const OnDemandInstance::ChildNameIndex* index = getChildNameIndex())
+	{
+		OnDemandInstance::ChildNameIndex::const_iterator iter = index->find(findName);
+		return iter != index->end() ? iter->second : NULL;
+	}
+
 	const Instances& c(*children);
+
+	if (DFInt::InstanceChildNameIndexThreshold > 0 && c.size() >= (size_t)DFInt::InstanceChildNameIndexThreshold)
+	{
+		// The index only caches what a scan of the children would find
+		const_cast<Instance*>(this)->buildChildNameIndex();
+		return findConstFirstChildByName(findName);
+	}
+
 	for (size_t i = 0; i < c.size(); ++i) {
 		if (c[i]->getName() == findName) {
 			return c[i].get();
@@ -374,6 +390,64 @@ const Instance* Instance::findConstFirstChildByName(const std::string& findName)
 	return NULL;
 }
 
+OnDemandInstance::ChildNameIndex* Instance::getChildNameIndex() const
+{
+	const OnDemandInstance* onDemand = onDemandRead();
+	return onDemand ? onDemand->childNameIndex.get() : NULL;
+}
+
+void Instance::buildChildNameIndex()
+{
+	RBXASSERT(children);
+
+	OnDemandInstance::ChildNameIndex* index = new OnDemandInstance::ChildNameIndex();
+	const Instances& c(*children);
+	for (size_t i = 0; i < c.size(); ++i)
+		index->insert(std::make_pair(c[i]->getName(), c[i].get()));	// keeps the first child of each name
+
+	onDemandWrite()->childNameIndex.reset(index);
+}
+
+void Instance::updateChildNameIndex(const std::string& childName)
+{
+	OnDemandInstance::ChildNameIndex* index = getChildNameIndex();
+	RBXASSERT(index);
+
+	index->erase(childName);
+
+	if (!children)
+		return;
+
+	const Instances& c(*children);
+	for (size_t i = 0; i < c.size(); ++i) {
+		if (c[i]->getName() == childName) {
+			(*index)[childName] = c[i].get();
+			return;
+		}
+	}
+}
+
+void Instance::onChildNameIndexAdded(Instance* child)
+{
+	// New children go to the back, so an existing entry is still the first one
+	getChildNameIndex()->insert(std::make_pair(child->getName(), child));
+}
+
+void Instance::onChildNameIndexRenamed(Instance* child, const std::string& oldName)
+{
+	OnDemandInstance::ChildNameIndex* index = getChildNameIndex();
+
+	OnDemandInstance::ChildNameIndex::iterator iter = index->find(oldName);
+	if (iter != index->end() && iter->second == child)
+		updateChildNameIndex(oldName);
+
+	iter = index->find(child->getName());
+	if (iter == index->end())
+		(*index)[child->getName()] = child;
+	else if (iter->second != child)
+		updateChildNameIndex(child->getName());		// may now come before the indexed one
+}
+
 shared_ptr<Instance> Instance::findFirstAncestorOf(const Instance* descendant) const
 {
 	if (!children)
@@ -523,6 +597,7 @@ bool Instance::setParentInternal(Instance* newParent, bool ignoreLock)
 
 		{
 			boost::shared_ptr<Instances>& c = oldParent->children.write();
+			Instance* moved = NULL;
 
 			if (c->size() == 1)
 			{
@@ -541,6 +616,8 @@ bool Instance::setParentInternal(Instance* newParent, bool ignoreLock)
 						// Fast-remove. This can make a huge speed improvement over regular remove
 						*iter = c->back();
 						c->pop_back();
+						if (iter != c->end())
+							moved = iter->get();
 					}
 					else
 					{
@@ -549,6 +626,28 @@ bool Instance::setParentInternal(Instance* newParent, bool ignoreLock)
 					}
 				}
 			}
+
+			if (OnDemandInstance::ChildNameIndex* index = oldParent->getChildNameIndex())
+			{
+				if (!oldParent->children)
+				{
+					oldParent->onDemandWrite()->childNameIndex.reset();
+				}
+				else
+				{
+					OnDemandInstance::ChildNameIndex::iterator entry = index->find(getName());
+					if (entry != index->end() && entry->second == this)
+						oldParent->updateChildNameIndex(getName());
+
+					// A fast-remove moves the last child forward, possibly ahead of a same-named sibling
+					if (moved)
+					{
+						entry = index->find(moved->getName());
+						if (entry == index->end() || entry->second != moved)
+							oldParent->updateChildNameIndex(moved->getName());
+					}
+				}
+			}
 		}
 		this->parent = NULL;
 
@@ -558,6 +657,8 @@ bool Instance::setParentInternal(Instance* newParent, bool ignoreLock)
 	if (newParent!=NULL)
 	{
 		newParent->children.write()->push_back(self);
+		if (newParent->getChildNameIndex())
+			newParent->onChildNameIndexAdded(this);
 	}
 
 	this->parent = newParent;
@@ -910,10 +1011,19 @@ void Instance::setName(const std::string& value)
 {
 	if (name.get() != value)
 	{
+		const bool indexed = parent && parent->getChildNameIndex();
+		std::string oldName;
+		if (indexed)
+			oldName = name.get();
+
 		if (value.size() > 100)
 			name = value.substr(0, 100);
 		else
 			name = value;
+
+		if (indexed)
+			parent->onChildNameIndexRenamed(this, oldName);
+
 		this->raisePropertyChanged(desc_Name);
 
 		checkParentWaitingForChildren();
@@ -979,6 +1089,9 @@ void Instance::predelete()
 {
 	RBXASSERT(parent==NULL);
 
+	if (OnDemandInstance* onDemand = onDemandPtr.get())
+		onDemand->childNameIndex.reset();
+
 	while (children)
 	{
 		shared_ptr<Instance> child;
@@ -1000,6 +1113,21 @@ void Instance::predelete()
 				children.reset();
 		}
 
+		// Removal handlers can look children up by name, which builds the index again
+		if (OnDemandInstance::ChildNameIndex* index = getChildNameIndex())
+		{
+			if (!children)
+			{
+				onDemandWrite()->childNameIndex.reset();
+			}
+			else
+			{
+				OnDemandInstance::ChildNameIndex::iterator entry = index->find(child->getName());
+				if (entry != index->end() && entry->second == child.get())
+					updateChildNameIndex(child->getName());
+			}
+		}
+
 		{
 			// TODO: Can we nuke this:
 			ChildRemovedSignalData data(child);
@@ -821,6 +821,29 @@ void ContactManager::onAssemblyMovedFromStep(Assembly& a)
 		spatialHash->onPrimitiveExtentsChanged(p);
 }
 
+void ContactManager::onAssembliesMovedFromStep(const std::vector<Assembly*>& assemblies, WorkStealingPool* pool, int threadCount)
+{
+	WriteValidator writeValidator(concurrencyValidator);
+
+	// Gather
+	tempPrimitives.clear();
+
+	AppendPrimitivePredicate pred = { &tempPrimitives };
+	for (Assembly* a: assemblies)
+		a->visitPrimitives(pred);
+
+	// The extents are computed concurrently. Bodies of different assemblies can share a parent,
+	// so bring all the cached PVs up to date first rather than from several threads at once.
+	if (pool && threadCount > 1)
+	{
+		for (Primitive* p: tempPrimitives)
+			p->getBody()->getPvUnsafe();
+	}
+
+	// Notify
+	spatialHash->onPrimitivesExtentsChanged(tempPrimitives, pool, threadCount);
+}
+
 Primitive* ContactManager::getHitLegacy(const RbxRay& originDirection, 
 										const Primitive* ignorePrim,		// set to NULL to not use	
 										const HitTestFilter* filter,				// set to NULL to not use
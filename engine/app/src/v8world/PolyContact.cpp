@@ -64,7 +64,10 @@ void PolyContact::putAllConnectorsInKernel()
 
 bool PolyContact::stepContact() 
 {
-	if (computeIsColliding(0.0f)) {
+	bool colliding = computeIsColliding(0.0f);
+	narrowphaseComputed = false;
+
+	if (colliding) {
 		if (inKernel()) {
 			updateContactPoints();
 			putAllConnectorsInKernel();
@@ -38,12 +38,29 @@ PolyPolyContact::~PolyPolyContact()
 
 
 
+bool PolyPolyContact::hasPolyGeometry()
+{
+	return	dynamic_cast<const Poly*>(getPrimitive(0)->getConstGeometry()) &&
+			dynamic_cast<const Poly*>(getPrimitive(1)->getConstGeometry());
+}
+
+void PolyPolyContact::computeNarrowphase()
+{
+	RBXASSERT(contactParams);
+
+	// Same conditions under which stepContact would search
+	if (Primitive::aaBoxCollide(*getPrimitive(0), *getPrimitive(1)) && hasPolyGeometry()) {
+		findBestPair();
+		narrowphaseComputed = true;
+	}
+}
+
 void PolyPolyContact::findClosestFeatures(ConnectorArray& newConnectors)
 {
-	if (!dynamic_cast<const Poly*>(getPrimitive(0)->getConstGeometry())) return;
-	if (!dynamic_cast<const Poly*>(getPrimitive(1)->getConstGeometry())) return;
+	if (!hasPolyGeometry()) return;
 
-	findBestPair();
+	if (!narrowphaseComputed)
+		findBestPair();
 
 	int numConnectorsCheck = newConnectors.size();
     if(bestPair)
@@ -14,6 +14,7 @@
 #include "rbx/Debug.h"
 #include "rbx/Profiler.h"
 #include "v8kernel/Kernel.h"
+#include "util/WorkStealingPool.h"
 
 DYNAMIC_FASTFLAGVARIABLE(PGSWakeOtherAssemblyForJoints, false)
 
@@ -58,6 +59,8 @@ SleepStage::SleepStage(IStage* upstream, World* world)
 	, recursivePassId(0)
 	, externalRecursiveWake(false)
 	, debugReentrant(false)
+	, workerPool(NULL)
+	, workerThreadCount(1)
 {}
 #pragma warning(pop)
 
@@ -291,10 +294,53 @@ bool SleepStage::atLeastOneAssemblyMoving(Assembly* a0, Assembly* a1)
 	return (a0->getAssemblyIsMovingState() || a1->getAssemblyIsMovingState());
 }
 
+void SleepStage::computeNarrowphase(ContactList& contacts)
+{
+	RBXPROFILER_SCOPE("Physics", "computeNarrowphase");
+
+	narrowphaseContacts.clear();
+
+	// Anything computed lazily and shared between contacts is brought up to date here, on this thread:
+	// primitives have several contacts and bodies cache their PV from their parent's.
+	for (int i = 0; i < contacts.size(); ++i)
+	{
+		Contact* c = contacts[i];
+		if (!c->hasParallelNarrowphase())
+			continue;
+
+		c->getPrimitive(0)->getFastFuzzyExtents();
+		c->getPrimitive(1)->getFastFuzzyExtents();
+		if (!c->getContactParams())
+			c->generateDataForMovingAssemblyStage();
+
+		narrowphaseContacts.push_back(c);
+	}
+
+	static const size_t grainSize = 32;
+	if (narrowphaseContacts.size() < 2 * grainSize)
+	{
+		// Not worth the synchronization, stepContact will do it
+		narrowphaseContacts.clear();
+		return;
+	}
+
+	std::vector<Contact*>& work = narrowphaseContacts;
+	workerPool->parallelFor(work.size(), grainSize, [&work](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			work[i]->computeNarrowphase();
+	}, workerThreadCount);
+
+	narrowphaseContacts.clear();
+}
+
 void SleepStage::stepContacts(ContactList& contacts)
 {
 	RBXPROFILER_SCOPE("Physics", "stepContacts");
 
+	if (workerPool && workerThreadCount > 1)
+		computeNarrowphase(contacts);
+
 	RBXASSERT(toSleeping.empty());
 	RBXASSERT(toStepping.empty());
 	RBXASSERT(toContacting.empty());
@@ -226,6 +226,13 @@ struct SmoothClusterGeometry::ChunkMesh
 
 	shared_ptr<ChunkMeshShape> shape;
 
+	// Cached mesh the shape was built from; it's not worth keeping alive once the cache drops it
+	weak_ptr<const Voxel2::Mesher::BasicMesh> geometry;
+
+	// Shape of the chunk this one replaced; reused if the chunk contents turn out to be the same
+	shared_ptr<ChunkMeshShape> previousShape;
+	weak_ptr<const Voxel2::Mesher::BasicMesh> previousGeometry;
+
 	ChunkMesh(const Vector3int32& id)
 		: id(id)
         , state(State_Dummy)
@@ -265,12 +272,19 @@ struct SmoothClusterGeometry::ChunkMesh
         using namespace Voxel2::Mesher;
 
         Options options = { mci->getMaterialTable(), /* generateWater= */ true };
-        BasicMesh geometry = generateGeometry(box, region.begin(), 0, options);
+        shared_ptr<const BasicMesh> mesh = mci->getGeometryCache()->generateGeometry(box, region.begin(), 0, options);
+
+		shared_ptr<ChunkMeshShape> reusableShape;
+		reusableShape.swap(previousShape);
+
+		bool unchanged = reusableShape && previousGeometry.lock() == mesh;
+		previousGeometry.reset();
 
-        if (geometry.indices.empty())
+        if (mesh->indices.empty())
             return;
 
-		shape.reset(new ChunkMeshShape(geometry));
+		geometry = mesh;
+		shape = unchanged ? reusableShape : shared_ptr<ChunkMeshShape>(new ChunkMeshShape(*mesh));
     }
 
     void updateTree()
@@ -611,6 +625,12 @@ void SmoothClusterGeometry::updateChunk(const Vector3int32& id)
 
     ChunkMesh*& slot = bulletChunks[id];
 
+	if (slot && slot->state == ChunkMesh::State_Ready)
+	{
+		chunk->previousShape = slot->shape;
+		chunk->previousGeometry = slot->geometry;
+	}
+
     delete slot;
     slot = chunk;
 }
@@ -655,6 +675,10 @@ void SmoothClusterGeometry::garbageCollectIncremental()
 	{
 		ChunkMesh* mesh = it->second;
 
+		// Chunks that were invalidated but haven't been needed since don't get to keep the old shape around
+		mesh->previousShape.reset();
+		mesh->previousGeometry.reset();
+
 		if (mesh->shape && mesh->shape.unique())
 		{
 			size_t memorySize = mesh->shape->getMemorySize();
@@ -667,6 +691,7 @@ void SmoothClusterGeometry::garbageCollectIncremental()
 				RBXASSERT(mesh->state == ChunkMesh::State_Ready);
 				mesh->state = ChunkMesh::State_Dummy;
 				mesh->shape.reset();
+				mesh->geometry.reset();
 			}
 			else
 			{
@@ -55,6 +55,8 @@ DYNAMIC_FASTINTVARIABLE(smoothnessReportThreshold,10000)
 
 DYNAMIC_FASTINTVARIABLE(MaxMissedWorldStepsRemembered, 12)
 DYNAMIC_FASTFLAGVARIABLE(CyclicExecutiveThrottlingCancelWorldStepAccum, false)
+DYNAMIC_FASTFLAGVARIABLE(PhysicsParallelBroadphaseEnabled, false)
+DYNAMIC_FASTFLAGVARIABLE(PhysicsParallelNarrowphaseEnabled, false)
 DYNAMIC_FASTFLAG(MaterialPropertiesEnabled)
 
 FASTINTVARIABLE(PhysicsBulletManifoldPoolSize, 1024)
@@ -289,6 +291,7 @@ void World::loadProfilers(std::vector<RBX::Profiling::CodeProfiler*>& worldProfi
 	worldProfilers.push_back(getStepJointsStage()->profilingJointUpdate.get());
 	worldProfilers.push_back(getKernel()->profilingKernelBodies.get());
 	worldProfilers.push_back(getKernel()->profilingKernelConnectors.get());
+	worldProfilers.push_back(getKernel()->profilingKernelSolver.get());
 }
 
 
@@ -642,6 +645,7 @@ void World::doWorldStep(bool throttling, int uiStepId, int numThreads, boost::ui
         }
     }
 
+	getSleepStage()->setWorkerPool(DFFlag::PhysicsParallelNarrowphaseEnabled ? getKernel()->getWorkerPool(numThreads) : NULL, numThreads);
 	getSleepStage()->stepSleepStage(worldStepId, uiStepId, throttling);	// update contacts, sleeping, awake
 
 	getStepJointsStage()->jointsStepWorld();												// update joints
@@ -654,17 +658,35 @@ void World::doWorldStep(bool throttling, int uiStepId, int numThreads, boost::ui
         RBXPROFILER_SCOPE("Physics", "updateBroadphase");
 
 		RBX::Profiling::Mark mark(*contactManager->profilingBroadphase, false);
-		std::for_each(
-			getSimulateStage()->getRealTimeAssembliesBegin(),
-			getSimulateStage()->getRealtimeAssembliesEnd(),
-			boost::bind(&ContactManager::onAssemblyMovedFromStep, contactManager, _1) );
+		if (DFFlag::PhysicsParallelBroadphaseEnabled)
+		{
+			// Same order as below, so the contacts come out the same
+			movedAssemblies.clear();
+			for (SimulateStage::Assemblies::iterator it = getSimulateStage()->getRealTimeAssembliesBegin(); it != getSimulateStage()->getRealtimeAssembliesEnd(); ++it)
+				movedAssemblies.push_back(&*it);
 
-		if (!throttling)
+			if (!throttling)
+			{
+				for (SimulateStage::Assemblies::iterator it = getSimulateStage()->getMovingDynamicAssembliesBegin(); it != getSimulateStage()->getMovingDynamicAssembliesEnd(); ++it)
+					movedAssemblies.push_back(&*it);
+			}
+
+			contactManager->onAssembliesMovedFromStep(movedAssemblies, getKernel()->getWorkerPool(numThreads), numThreads);
+		}
+		else
 		{
 			std::for_each(
-				getSimulateStage()->getMovingDynamicAssembliesBegin(),
-				getSimulateStage()->getMovingDynamicAssembliesEnd(),
-				boost::bind(&ContactManager::onAssemblyMovedFromStep, contactManager, _1) );		// old Pre_step is here - updates Extents
+				getSimulateStage()->getRealTimeAssembliesBegin(),
+				getSimulateStage()->getRealtimeAssembliesEnd(),
+				boost::bind(&ContactManager::onAssemblyMovedFromStep, contactManager, _1) );
+
+			if (!throttling)
+			{
+				std::for_each(
+					getSimulateStage()->getMovingDynamicAssembliesBegin(),
+					getSimulateStage()->getMovingDynamicAssembliesEnd(),
+					boost::bind(&ContactManager::onAssemblyMovedFromStep, contactManager, _1) );		// old Pre_step is here - updates Extents
+			}
 		}
 	}
 
@@ -3,6 +3,7 @@
 #include "v8xml/SerializerBinary.h"
 #include "v8xml/Serializer.h"
 
+#include <deque>
 #include <vector>
 #include <string>
 
@@ -23,11 +24,24 @@
 #include "v8datamodel/NumberRange.h"
 #include "util/PhysicalProperties.h"
 
+#include "rbx/Thread.hpp"
+#include "rbx/atomic.h"
+#include "simd/simd.h"
+#include "boost/iostreams/device/mapped_file.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/thread.hpp"
+
 #include <lz4.h>
 #include <lz4hc.h>
 
 LOGVARIABLE(Serializer, 0)
 
+DYNAMIC_FASTFLAGVARIABLE(SerializerBinaryParallelDecode, false)
+DYNAMIC_FASTFLAGVARIABLE(SerializerBinaryParallelCompress, false)
+DYNAMIC_FASTINTVARIABLE(SerializerBinaryDecodeThreads, 3) // also sizes the compression helpers
+DYNAMIC_FASTINTVARIABLE(SerializerBinaryParallelMinKB, 256)
+DYNAMIC_FASTFLAGVARIABLE(SerializerBinarySIMDPlanes, false)
+
 namespace RBX
 {
 	static const char kHeaderSignature[] = "\x89\xff\x0d\x0a\x1a\x0a";
@@ -99,11 +113,12 @@ namespace RBX
 
     struct MemoryInputStream
     {
-		boost::scoped_array<char> data;
+		const char* data;	// either storage or uncompressed chunk data in the file buffer
+		boost::scoped_array<char> storage;
         size_t offset;
         size_t datasize;
 
-        MemoryInputStream(): offset(0), datasize(0)
+        MemoryInputStream(): data(NULL), offset(0), datasize(0)
         {
         }
 
@@ -161,6 +176,17 @@ namespace RBX
 			memcpy(data.get() + datasize, value, size);
 			datasize += size;
         }
+
+		// Reserves size bytes at the end of the stream for the caller to fill in
+		char* append(size_t size)
+		{
+			if (datasize + size > capacity) grow(datasize + size);
+
+			char* result = data.get() + datasize;
+			datasize += size;
+
+			return result;
+		}
     };
 
 	static void readData(std::istream& in, void* data, int size)
@@ -171,65 +197,468 @@ namespace RBX
 			throw RBX::runtime_error("Unexpected end of file while reading %d bytes", size);
 	}
 
-	static ChunkHeader readChunk(std::istream& in, MemoryInputStream& result)
+	// A chunk in the file buffer. The payload is decoded when the chunk is taken from ChunkDecoder
+	struct ChunkSource
 	{
 		ChunkHeader header;
-		readData(in, &header, sizeof(header));
+		const char* payload;
+	};
+
+	// Finds all chunks up to and including the END chunk without decoding them
+	static void scanChunks(const char* data, size_t size, size_t offset, std::vector<ChunkSource>& chunks)
+	{
+		while (offset < size)
+		{
+			ChunkSource chunk;
+
+			if (size - offset < sizeof(chunk.header))
+				throw RBX::runtime_error("Unexpected end of file while reading %d bytes", (int)sizeof(chunk.header));
+
+			memcpy(&chunk.header, data + offset, sizeof(chunk.header));
+			offset += sizeof(chunk.header);
+
+			size_t payloadSize = chunk.header.size == 0 ? 0 : chunk.header.compressedSize == 0 ? chunk.header.size : chunk.header.compressedSize;
+
+			if (size - offset < payloadSize)
+				throw RBX::runtime_error("Unexpected end of file while reading %d bytes", (int)payloadSize);
 
-		result.data.reset(new char[header.size]);
-		result.datasize = header.size;
+			chunk.payload = data + offset;
+			offset += payloadSize;
+
+			chunks.push_back(chunk);
+
+			if (memcmp(chunk.header.name, kChunkEnd, sizeof(chunk.header.name)) == 0)
+				return;
+		}
+
+		// We should only finish reading the file when we see an END chunk
+		throw RBX::runtime_error("Unexpected end of file");
+	}
+
+	static void decodeChunk(const ChunkSource& chunk, MemoryInputStream& result)
+	{
 		result.offset = 0;
+		result.datasize = chunk.header.size;
 
-		if (header.size)
+		if (chunk.header.compressedSize == 0 || chunk.header.size == 0)
+		{
+			result.data = chunk.payload;
+			return;
+		}
+
+		result.storage.reset(new char[chunk.header.size]);
+		result.data = result.storage.get();
+
+		int count = LZ4_decompress_safe(chunk.payload, result.storage.get(), chunk.header.compressedSize, result.datasize);
+
+		if (count != result.datasize)
+			throw RBX::runtime_error("Malformed data (%d != %d)", count, (int)result.datasize);
+	}
+
+#ifdef RBX_TEST_BUILD
+	static rbx::atomic<int> helperThreadsStarted;
+
+	int SerializerBinary::getHelperThreadsStarted()
+	{
+		return helperThreadsStarted;
+	}
+#endif
+
+	// Decompresses chunks ahead of the thread that builds instances from them.
+	// Helper threads claim chunks in file order, at most kDecodeAhead chunks past the one being
+	// built. The building thread takes chunks in the same order and decodes a chunk itself if no
+	// helper has claimed it yet, so with no helpers this is the plain serial loader.
+	class ChunkDecoder : boost::noncopyable
+	{
+	public:
+		ChunkDecoder(const std::vector<ChunkSource>& chunks, int threadCount)
+			:chunks(chunks)
+			,slots(new Slot[chunks.size()])
+			,nextChunk(0)
+			,takenChunks(0)
+			,stopped(false)
+		{
+			for (int i = 0; i < threadCount; ++i)
+				threads.push_back(shared_ptr<boost::thread>(new boost::thread(boost::bind(&ChunkDecoder::workerLoop, this))));
+		}
+
+		~ChunkDecoder()
 		{
-			if (header.compressedSize == 0)
 			{
-				readData(in, result.data.get(), header.size);
+				boost::unique_lock<boost::mutex> lock(mutex);
+				stopped = true;
+				spaceCondition.notify_all();
 			}
-			else
+
+			for (size_t i = 0; i < threads.size(); ++i)
+				threads[i]->join();
+		}
+
+		// Chunks have to be taken in order
+		void take(size_t index, MemoryInputStream& result)
+		{
+			Slot& slot = slots[index];
+			bool decodeHere = false;
+
 			{
-				std::vector<char> compressed(header.compressedSize);
-				readData(in, &compressed[0], compressed.size());
+				boost::unique_lock<boost::mutex> lock(mutex);
+				RBXASSERT(index == takenChunks && index <= nextChunk);
+
+				takenChunks = index + 1;
+				spaceCondition.notify_all();
 
-				int count = LZ4_decompress_safe(&compressed[0], result.data.get(), compressed.size(), result.datasize);
+				if (index == nextChunk)
+				{
+					nextChunk++;
+					decodeHere = true;
+				}
+				else
+				{
+					while (slot.state == Decoding)
+						readyCondition.wait(lock);
+				}
+			}
 
-				if (count != result.datasize)
-					throw RBX::runtime_error("Malformed data (%d != %d)", count, (int)result.datasize);
+			if (decodeHere)
+			{
+				decodeChunk(chunks[index], result);
+				return;
 			}
+
+			if (slot.state == Failed)
+				throw std::runtime_error(slot.error);
+
+			result.data = slot.stream.data;
+			result.storage.swap(slot.stream.storage);
+			result.offset = 0;
+			result.datasize = slot.stream.datasize;
 		}
 
-		return header;
+	private:
+		static const size_t kDecodeAhead = 32;
+
+		enum State
+		{
+			Decoding,
+			Ready,
+			Failed
+		};
+
+		struct Slot
+		{
+			State state;
+			MemoryInputStream stream;
+			std::string error;
+
+			Slot(): state(Decoding)
+			{
+			}
+		};
+
+		void workerLoop()
+		{
+			RBX::set_thread_name("rbx_SerializerBinaryDecode");
+
+#ifdef RBX_TEST_BUILD
+			++helperThreadsStarted;
+#endif
+
+			while (true)
+			{
+				size_t index;
+
+				{
+					boost::unique_lock<boost::mutex> lock(mutex);
+					while (!stopped && nextChunk < chunks.size() && nextChunk >= takenChunks + kDecodeAhead)
+						spaceCondition.wait(lock);
+
+					if (stopped || nextChunk >= chunks.size())
+						return;
+
+					index = nextChunk++;
+					slots[index].state = Decoding;
+				}
+
+				State state = Ready;
+
+				try
+				{
+					decodeChunk(chunks[index], slots[index].stream);
+				}
+				catch (std::exception& e)
+				{
+					slots[index].error = e.what();
+					state = Failed;
+				}
+
+				boost::unique_lock<boost::mutex> lock(mutex);
+				slots[index].state = state;
+				readyCondition.notify_all();
+			}
+		}
+
+		const std::vector<ChunkSource>& chunks;
+		boost::scoped_array<Slot> slots;
+
+		boost::mutex mutex;
+		boost::condition_variable spaceCondition;
+		boost::condition_variable readyCondition;
+		size_t nextChunk;		// the first chunk nobody has claimed
+		size_t takenChunks;		// chunks handed to the building thread
+		bool stopped;
+
+		std::vector<shared_ptr<boost::thread> > threads;
+	};
+
+	// Small files are common (models, CSG data) and don't pay for starting threads
+	static size_t getParallelMinBytes()
+	{
+		return std::max(0, DFInt::SerializerBinaryParallelMinKB) * 1024;
 	}
 
-	static void writeChunk(std::ostream& out, const MemoryOutputStream& stream, const char* name, unsigned int flags)
+	// One helper even on a single core, the calling thread is busy with other work while it runs
+	static int getHelperThreadCount()
+	{
+		int hardwareThreads = std::max(1, (int)boost::thread::hardware_concurrency());
+		return std::max(0, std::min(DFInt::SerializerBinaryDecodeThreads, std::max(1, hardwareThreads - 1)));
+	}
+
+	static int getDecodeThreadCount(const std::vector<ChunkSource>& chunks)
+	{
+		if (!DFFlag::SerializerBinaryParallelDecode)
+			return 0;
+
+		size_t compressedBytes = 0;
+		for (size_t i = 0; i < chunks.size(); ++i)
+			compressedBytes += chunks[i].header.compressedSize;
+
+		return compressedBytes < getParallelMinBytes() ? 0 : getHelperThreadCount();
+	}
+
+	// Chunks up to this size use LZ4HC with sfAdaptiveCompression
+	static const size_t kAdaptiveHighCompressionMaxSize = 64 * 1024;
+
+	static void compressChunk(const MemoryOutputStream& stream, const char* name, unsigned int flags, ChunkHeader& header, std::vector<char>& compressed)
 	{
-		ChunkHeader header;
 		strncpy(header.name, name, sizeof(header.name));
 		header.compressedSize = 0;
 		header.size = stream.datasize;
 		header.reserved = 0;
 
 		if (flags & SerializerBinary::sfNoCompression)
-		{
-			out.write(reinterpret_cast<char*>(&header), sizeof(header));
+			return;
+
+		bool highCompression = (flags & SerializerBinary::sfHighCompression) ||
+			((flags & SerializerBinary::sfAdaptiveCompression) && stream.datasize <= kAdaptiveHighCompressionMaxSize);
+
+		compressed.resize(LZ4_compressBound(stream.datasize));
+		header.compressedSize = (highCompression ? LZ4_compressHC : LZ4_compress)(stream.data.get(), &compressed[0], stream.datasize);
+	}
+
+	static void writeCompressedChunk(std::ostream& out, const MemoryOutputStream& stream, const ChunkHeader& header, const std::vector<char>& compressed)
+	{
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		if (header.compressedSize == 0)
 			out.write(stream.data.get(), stream.datasize);
-		}
 		else
+			out.write(&compressed[0], header.compressedSize);
+
+		FASTLOGS(FLog::Serializer, "Stream: %s", stream.name);
+		FASTLOG2(FLog::Serializer, "%d -> %d", header.size, header.compressedSize);
+	}
+
+	// Compresses chunks on helper threads while the calling thread keeps producing them.
+	// Chunks are written in the order they were added, so the output is the same as a serial
+	// save. Helpers start once SerializerBinaryParallelMinKB have been queued; until then, and whenever more
+	// than kMaxQueuedChunks are waiting, the calling thread compresses the oldest chunk itself.
+	class ChunkEncoder : boost::noncopyable
+	{
+	public:
+		ChunkEncoder(std::ostream& out, int threadCount)
+			:out(out)
+			,threadCount(threadCount)
+			,queuedBytes(0)
+			,stopped(false)
 		{
-			int maxSize = LZ4_compressBound(stream.datasize);
+		}
 
-			std::vector<char> compressed(maxSize);
-			int compressedSize = (flags & SerializerBinary::sfHighCompression ? LZ4_compressHC : LZ4_compress)(stream.data.get(), &compressed[0], stream.datasize);
+		~ChunkEncoder()
+		{
+			{
+				boost::unique_lock<boost::mutex> lock(mutex);
+				stopped = true;
+				workCondition.notify_all();
+			}
+
+			for (size_t i = 0; i < threads.size(); ++i)
+				threads[i]->join();
+		}
+
+		void add(const shared_ptr<MemoryOutputStream>& stream, const char* name, unsigned int flags)
+		{
+			shared_ptr<Chunk> chunk(new Chunk(stream, name, flags));
 
-			header.compressedSize = compressedSize;
+			if (threadCount == 0)
+			{
+				compress(*chunk);
+				write(*chunk);
+				return;
+			}
 
-			out.write(reinterpret_cast<char*>(&header), sizeof(header));
-			out.write(&compressed[0], compressedSize);
+			{
+				boost::unique_lock<boost::mutex> lock(mutex);
+				queue.push_back(chunk);
+				queuedBytes += stream->datasize;
+				workCondition.notify_one();
+			}
+
+			if (threads.empty() && queuedBytes >= getParallelMinBytes())
+			{
+				for (int i = 0; i < threadCount; ++i)
+					threads.push_back(shared_ptr<boost::thread>(new boost::thread(boost::bind(&ChunkEncoder::workerLoop, this))));
+			}
+
+			while (shared_ptr<Chunk> front = popFront(queueSize() > kMaxQueuedChunks))
+				write(*front);
 		}
 
-		FASTLOGS(FLog::Serializer, "Stream: %s", stream.name);
-		FASTLOG2(FLog::Serializer, "%d -> %d", header.size, header.compressedSize);
-	}
+		// Writes all queued chunks
+		void finish()
+		{
+			while (shared_ptr<Chunk> front = popFront(true))
+				write(*front);
+		}
+
+	private:
+		static const size_t kMaxQueuedChunks = 64;
+
+		enum State
+		{
+			Queued,
+			Compressing,
+			Compressed
+		};
+
+		struct Chunk
+		{
+			shared_ptr<MemoryOutputStream> stream;
+			const char* name;
+			unsigned int flags;
+			State state;
+
+			ChunkHeader header;
+			std::vector<char> compressed;
+
+			Chunk(const shared_ptr<MemoryOutputStream>& stream, const char* name, unsigned int flags)
+				: stream(stream), name(name), flags(flags), state(Queued)
+			{
+			}
+		};
+
+		static void compress(Chunk& chunk)
+		{
+			compressChunk(*chunk.stream, chunk.name, chunk.flags, chunk.header, chunk.compressed);
+		}
+
+		void write(const Chunk& chunk)
+		{
+			writeCompressedChunk(out, *chunk.stream, chunk.header, chunk.compressed);
+		}
+
+		size_t queueSize()
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			return queue.size();
+		}
+
+		// Removes the oldest chunk once it is compressed. If wait is false, only returns a chunk
+		// that is already compressed.
+		shared_ptr<Chunk> popFront(bool wait)
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+
+			if (queue.empty())
+				return shared_ptr<Chunk>();
+
+			shared_ptr<Chunk> front = queue.front();
+
+			if (front->state == Queued)
+			{
+				if (!wait)
+					return shared_ptr<Chunk>();
+
+				front->state = Compressing;
+				lock.unlock();
+				compress(*front);
+				lock.lock();
+				front->state = Compressed;
+			}
+
+			if (front->state == Compressing && !wait)
+				return shared_ptr<Chunk>();
+
+			while (front->state == Compressing)
+				readyCondition.wait(lock);
+
+			queue.pop_front();
+			return front;
+		}
+
+		void workerLoop()
+		{
+			RBX::set_thread_name("rbx_SerializerBinaryCompress");
+
+#ifdef RBX_TEST_BUILD
+			++helperThreadsStarted;
+#endif
+
+			while (true)
+			{
+				shared_ptr<Chunk> chunk;
+
+				{
+					boost::unique_lock<boost::mutex> lock(mutex);
+
+					while (!stopped && !(chunk = findQueued()))
+						workCondition.wait(lock);
+
+					if (stopped)
+						return;
+
+					chunk->state = Compressing;
+				}
+
+				compress(*chunk);
+
+				boost::unique_lock<boost::mutex> lock(mutex);
+				chunk->state = Compressed;
+				readyCondition.notify_all();
+			}
+		}
+
+		// The queue is short, so a scan for the oldest unclaimed chunk is cheap
+		shared_ptr<Chunk> findQueued() const
+		{
+			for (size_t i = 0; i < queue.size(); ++i)
+				if (queue[i]->state == Queued)
+					return queue[i];
+
+			return shared_ptr<Chunk>();
+		}
+
+		std::ostream& out;
+		const int threadCount;
+		size_t queuedBytes;		// only touched by the calling thread
+
+		boost::mutex mutex;
+		boost::condition_variable workCondition;
+		boost::condition_variable readyCondition;
+		std::deque<shared_ptr<Chunk> > queue;
+		bool stopped;
+
+		std::vector<shared_ptr<boost::thread> > threads;
+	};
 
     template <typename T> static void readRaw(MemoryInputStream& stream, T& value)
     {
@@ -278,92 +707,170 @@ namespace RBX
         return it == idMap.end() ? -1 : it->second;
     }
 
-    static void readIntVector(MemoryInputStream& stream, std::vector<int>& values, size_t count)
-    {
-		values.clear();
-		values.reserve(count);
+	union FloatBitcast
+	{
+		float f;
+		unsigned int i;
+	};
 
-		if (stream.offset + count * 4 > stream.datasize)
-			throw RBX::runtime_error("Read offset is out of bounds while reading %d bytes", (int)count * 4);
+    static unsigned int encodeFloat(float value)
+    {
+		FloatBitcast bitcast;
+		bitcast.f = value;
 
-		for (size_t i = 0; i < count; ++i)
-		{
-			unsigned char v0 = stream.data[stream.offset + i];
-			unsigned char v1 = stream.data[stream.offset + count + i];
-			unsigned char v2 = stream.data[stream.offset + count * 2 + i];
-			unsigned char v3 = stream.data[stream.offset + count * 3 + i];
+		// move sign bit to the end; that way exponent is in the first byte
+        return (bitcast.i << 1) | (bitcast.i >> 31);
+    }
 
-			values.push_back(decodeInt((v0 << 24) | (v1 << 16) | (v2 << 8) | v3));
-		}
+    static float decodeFloat(unsigned int value)
+    {
+		FloatBitcast bitcast;
+		bitcast.i = (value >> 1) | (value << 31);
 
-		stream.offset += count * 4;
+        return bitcast.f;
     }
 
-    static void writeIntVector(MemoryOutputStream& stream, const std::vector<int>& values)
-    {
-        for (size_t i = 0; i < values.size(); ++i)
+	// Integer, unsigned and float vectors are stored as 4 byte planes, most significant byte first, after
+	// a transform that makes the high bytes compress well. The codecs below implement each transform
+	// for one value and for 4 values at a time; readPlanes/writePlanes do the interleaving. The 4-wide path
+	// is off by default until it has been checked on every platform, the scalar loop handles any count.
+	struct IntPlaneCodec
+	{
+		typedef int Value;
+
+		static unsigned int encode(int value) { return encodeInt(value); }
+		static int decode(unsigned int value) { return decodeInt(value); }
+
+		static simd::v4u encode(const simd::v4u& value)
 		{
-			writeRaw(stream, (unsigned char)(encodeInt(values[i]) >> 24));
-        }
+			return simd::shiftLeft<1>(value) ^ (simd::splat(0u) - simd::shiftRight<31>(value));
+		}
 
-        for (size_t i = 0; i < values.size(); ++i)
+		static simd::v4u decode(const simd::v4u& value)
 		{
-			writeRaw(stream, (unsigned char)(encodeInt(values[i]) >> 16));
-        }
+			return simd::shiftRight<1>(value) ^ (simd::splat(0u) - (value & simd::splat(1u)));
+		}
+	};
 
-        for (size_t i = 0; i < values.size(); ++i)
+	struct UIntPlaneCodec
+	{
+		typedef unsigned int Value;
+
+		static unsigned int encode(unsigned int value) { return value; }
+		static unsigned int decode(unsigned int value) { return value; }
+
+		static const simd::v4u& encode(const simd::v4u& value) { return value; }
+		static const simd::v4u& decode(const simd::v4u& value) { return value; }
+	};
+
+	struct FloatPlaneCodec
+	{
+		typedef float Value;
+
+		static unsigned int encode(float value) { return encodeFloat(value); }
+		static float decode(unsigned int value) { return decodeFloat(value); }
+
+		static simd::v4u encode(const simd::v4u& value)
 		{
-			writeRaw(stream, (unsigned char)(encodeInt(values[i]) >> 8));
-        }
+			return simd::shiftLeft<1>(value) | simd::shiftRight<31>(value);
+		}
 
-        for (size_t i = 0; i < values.size(); ++i)
+		static simd::v4u decode(const simd::v4u& value)
 		{
-			writeRaw(stream, (unsigned char)encodeInt(values[i]));
-        }
-    }
+			return simd::shiftRight<1>(value) | simd::shiftLeft<31>(value);
+		}
+	};
 
-    static void readUIntVector(MemoryInputStream& stream, std::vector<unsigned int>& values, size_t count)
-    {
-		values.clear();
-		values.reserve(count);
+	template <typename Codec>
+	static void readPlanes(MemoryInputStream& stream, std::vector<typename Codec::Value>& values, size_t count)
+	{
+		BOOST_STATIC_ASSERT(sizeof(typename Codec::Value) == 4);
 
 		if (stream.offset + count * 4 > stream.datasize)
 			throw RBX::runtime_error("Read offset is out of bounds while reading %d bytes", (int)count * 4);
 
-		for (size_t i = 0; i < count; ++i)
+		values.resize(count);
+
+		const unsigned char* p0 = reinterpret_cast<const unsigned char*>(stream.data + stream.offset);
+		const unsigned char* p1 = p0 + count;
+		const unsigned char* p2 = p1 + count;
+		const unsigned char* p3 = p2 + count;
+
+		size_t i = 0;
+
+		for (; DFFlag::SerializerBinarySIMDPlanes && i + 16 <= count; i += 16)
 		{
-			unsigned char v0 = stream.data[stream.offset + i];
-			unsigned char v1 = stream.data[stream.offset + count + i];
-			unsigned char v2 = stream.data[stream.offset + count * 2 + i];
-			unsigned char v3 = stream.data[stream.offset + count * 3 + i];
+			simd::v4u r0, r1, r2, r3;
+			simd::loadBytePlanes(r0, r1, r2, r3, p0 + i, p1 + i, p2 + i, p3 + i);
+
+			uint32_t* target = reinterpret_cast<uint32_t*>(&values[i]);
 
-			values.push_back((v0 << 24) | (v1 << 16) | (v2 << 8) | v3);
+			simd::storeUnaligned(target, Codec::decode(r0));
+			simd::storeUnaligned(target + 4, Codec::decode(r1));
+			simd::storeUnaligned(target + 8, Codec::decode(r2));
+			simd::storeUnaligned(target + 12, Codec::decode(r3));
 		}
 
+		for (; i < count; ++i)
+			values[i] = Codec::decode((p0[i] << 24) | (p1[i] << 16) | (p2[i] << 8) | p3[i]);
+
 		stream.offset += count * 4;
-    }
+	}
 
-    static void writeUIntVector(MemoryOutputStream& stream, const std::vector<unsigned int>& values)
-    {
-        for (size_t i = 0; i < values.size(); ++i)
-		{
-			writeRaw(stream, (unsigned char)(values[i] >> 24));
-        }
+	template <typename Codec>
+	static void writePlanes(MemoryOutputStream& stream, const std::vector<typename Codec::Value>& values)
+	{
+		BOOST_STATIC_ASSERT(sizeof(typename Codec::Value) == 4);
 
-        for (size_t i = 0; i < values.size(); ++i)
-		{
-			writeRaw(stream, (unsigned char)(values[i] >> 16));
-        }
+		size_t count = values.size();
 
-        for (size_t i = 0; i < values.size(); ++i)
+		unsigned char* p0 = reinterpret_cast<unsigned char*>(stream.append(count * 4));
+		unsigned char* p1 = p0 + count;
+		unsigned char* p2 = p1 + count;
+		unsigned char* p3 = p2 + count;
+
+		size_t i = 0;
+
+		for (; DFFlag::SerializerBinarySIMDPlanes && i + 16 <= count; i += 16)
 		{
-			writeRaw(stream, (unsigned char)(values[i] >> 8));
-        }
+			const uint32_t* source = reinterpret_cast<const uint32_t*>(&values[i]);
 
-        for (size_t i = 0; i < values.size(); ++i)
+			simd::storeBytePlanes(p0 + i, p1 + i, p2 + i, p3 + i,
+				Codec::encode(simd::loadUnaligned(source)),
+				Codec::encode(simd::loadUnaligned(source + 4)),
+				Codec::encode(simd::loadUnaligned(source + 8)),
+				Codec::encode(simd::loadUnaligned(source + 12)));
+		}
+
+		for (; i < count; ++i)
 		{
-			writeRaw(stream, (unsigned char)values[i]);
-        }
+			unsigned int value = Codec::encode(values[i]);
+
+			p0[i] = (unsigned char)(value >> 24);
+			p1[i] = (unsigned char)(value >> 16);
+			p2[i] = (unsigned char)(value >> 8);
+			p3[i] = (unsigned char)value;
+		}
+	}
+
+    static void readIntVector(MemoryInputStream& stream, std::vector<int>& values, size_t count)
+    {
+		readPlanes<IntPlaneCodec>(stream, values, count);
+    }
+
+    static void writeIntVector(MemoryOutputStream& stream, const std::vector<int>& values)
+    {
+		writePlanes<IntPlaneCodec>(stream, values);
+    }
+
+    static void readUIntVector(MemoryInputStream& stream, std::vector<unsigned int>& values, size_t count)
+    {
+		readPlanes<UIntPlaneCodec>(stream, values, count);
+    }
+
+    static void writeUIntVector(MemoryOutputStream& stream, const std::vector<unsigned int>& values)
+    {
+		writePlanes<UIntPlaneCodec>(stream, values);
     }
 
     static void readIdVector(MemoryInputStream& stream, std::vector<int>& values, size_t count)
@@ -395,72 +902,59 @@ namespace RBX
         writeIntVector(stream, deltas);
 	}
 
-	union FloatBitcast
+	static void readFloatVector(MemoryInputStream& stream, std::vector<float>& values, size_t count)
 	{
-		float f;
-		unsigned int i;
-	};
-
-    static unsigned int encodeFloat(float value)
-    {
-		FloatBitcast bitcast;
-		bitcast.f = value;
-
-		// move sign bit to the end; that way exponent is in the first byte
-        return (bitcast.i << 1) | (bitcast.i >> 31);
-    }
+		readPlanes<FloatPlaneCodec>(stream, values, count);
+	}
 
-    static float decodeFloat(unsigned int value)
+	static void writeFloatVector(MemoryOutputStream& stream, const std::vector<float>& values)
     {
-		FloatBitcast bitcast;
-		bitcast.i = (value >> 1) | (value << 31);
-
-        return bitcast.f;
+		writePlanes<FloatPlaneCodec>(stream, values);
     }
 
-	static void readFloatVector(MemoryInputStream& stream, std::vector<float>& values, size_t count)
+#ifdef RBX_TEST_BUILD
+	template <typename Codec>
+	static std::string encodePlanes(const std::vector<typename Codec::Value>& values)
 	{
-		values.clear();
-		values.reserve(count);
+		MemoryOutputStream stream("planes");
+		writePlanes<Codec>(stream, values);
 
-		if (stream.offset + count * 4 > stream.datasize)
-			throw RBX::runtime_error("Read offset is out of bounds while reading %d bytes", (int)count * 4);
+		return stream.datasize ? std::string(stream.data.get(), stream.datasize) : std::string();
+	}
 
-		for (size_t i = 0; i < count; ++i)
-		{
-			unsigned char v0 = stream.data[stream.offset + i];
-			unsigned char v1 = stream.data[stream.offset + count + i];
-			unsigned char v2 = stream.data[stream.offset + count * 2 + i];
-			unsigned char v3 = stream.data[stream.offset + count * 3 + i];
+	template <typename Codec>
+	static std::vector<typename Codec::Value> decodePlanes(const std::string& planes)
+	{
+		MemoryInputStream stream;
+		stream.data = planes.data();
+		stream.datasize = planes.size();
 
-			values.push_back(decodeFloat((v0 << 24) | (v1 << 16) | (v2 << 8) | v3));
-		}
+		std::vector<typename Codec::Value> result;
+		readPlanes<Codec>(stream, result, planes.size() / 4);
 
-		stream.offset += count * 4;
+		return result;
 	}
 
-	static void writeFloatVector(MemoryOutputStream& stream, const std::vector<float>& values)
-    {
-        for (size_t i = 0; i < values.size(); ++i)
-		{
-			writeRaw(stream, (unsigned char)(encodeFloat(values[i]) >> 24));
-        }
+	std::string SerializerBinary::encodeIntPlanes(const std::vector<int>& values)
+	{
+		return encodePlanes<IntPlaneCodec>(values);
+	}
 
-        for (size_t i = 0; i < values.size(); ++i)
-		{
-			writeRaw(stream, (unsigned char)(encodeFloat(values[i]) >> 16));
-        }
+	std::vector<int> SerializerBinary::decodeIntPlanes(const std::string& planes)
+	{
+		return decodePlanes<IntPlaneCodec>(planes);
+	}
 
-        for (size_t i = 0; i < values.size(); ++i)
-		{
-			writeRaw(stream, (unsigned char)(encodeFloat(values[i]) >> 8));
-        }
+	std::string SerializerBinary::encodeFloatPlanes(const std::vector<float>& values)
+	{
+		return encodePlanes<FloatPlaneCodec>(values);
+	}
 
-        for (size_t i = 0; i < values.size(); ++i)
-		{
-			writeRaw(stream, (unsigned char)encodeFloat(values[i]));
-        }
-    }
+	std::vector<float> SerializerBinary::decodeFloatPlanes(const std::string& planes)
+	{
+		return decodePlanes<FloatPlaneCodec>(planes);
+	}
+#endif
 
 	static void readCFrameRotation(MemoryInputStream& stream, G3D::Matrix3& transform)
     {
@@ -1436,6 +1930,8 @@ namespace RBX
 
 		out.write(reinterpret_cast<char*>(&header), sizeof(header));
 
+		ChunkEncoder encoder(out, DFFlag::SerializerBinaryParallelCompress ? getHelperThreadCount() : 0);
+
 		// Write out object ids for each type
 		unsigned int typeIndex = 0;
 
@@ -1444,10 +1940,10 @@ namespace RBX
 			const Reflection::ClassDescriptor* type = it->first;
 			const std::vector<const Instance*>& instances = it->second;
 
-			MemoryOutputStream stream(type->name.toString());
+			shared_ptr<MemoryOutputStream> stream(new MemoryOutputStream(type->name.toString()));
 
-			writeRaw(stream, typeIndex);
-			writeString(stream, type->name.toString());
+			writeRaw(*stream, typeIndex);
+			writeString(*stream, type->name.toString());
 
 			std::vector<int> ids;
 			ids.reserve(instances.size());
@@ -1459,21 +1955,21 @@ namespace RBX
 			// note that since all objects are of the same type it's enough to dynamic_cast once
 			bool isServiceType = instances.size() > 0 && dynamic_cast<const Service*>(instances[0]) != NULL;
 
-			writeRaw(stream, (char)(isServiceType ? bofServiceType : bofPlain));
+			writeRaw(*stream, (char)(isServiceType ? bofServiceType : bofPlain));
 
-			writeRaw(stream, (unsigned int)ids.size());
-			writeIdVector(stream, ids);
+			writeRaw(*stream, (unsigned int)ids.size());
+			writeIdVector(*stream, ids);
 
 			if (isServiceType)
 			{
 				for (size_t i = 0; i < instances.size(); ++i)
 				{
 					bool value = instances[i]->getParent() == root;
-					writeRaw(stream, value);
+					writeRaw(*stream, value);
 				}
 			}
 
-			writeChunk(out, stream, kChunkInstances, flags);
+			encoder.add(stream, kChunkInstances, flags);
 		}
 
 		// Write out properties for each type
@@ -1489,20 +1985,20 @@ namespace RBX
 
 			for (size_t j = 0; j < properties.size(); ++j)
 			{
-				MemoryOutputStream stream(type->name.toString() + "-" + properties[j]->name.toString());
+				shared_ptr<MemoryOutputStream> stream(new MemoryOutputStream(type->name.toString() + "-" + properties[j]->name.toString()));
 
-				writeRaw(stream, typeIndex);
-				writeString(stream, properties[j]->name.toString());
+				writeRaw(*stream, typeIndex);
+				writeString(*stream, properties[j]->name.toString());
 
-				writePropertyValues(stream, *properties[j], instances, idMap, flags);
+				writePropertyValues(*stream, *properties[j], instances, idMap, flags);
 
-				writeChunk(out, stream, kChunkProperty, flags);
+				encoder.add(stream, kChunkProperty, flags);
 			}
 		}
 
 		// Write out parenting instructions
 		{
-			MemoryOutputStream stream("Instance-Parent");
+			shared_ptr<MemoryOutputStream> stream(new MemoryOutputStream("Instance-Parent"));
 
 			std::vector<int> oids;
 			std::vector<int> pids;
@@ -1516,26 +2012,28 @@ namespace RBX
 				pids.push_back(getInstanceId(idMap, objectspost[i]->getParent()));
 			}
 
-            writeRaw(stream, (char)bplfPlain);
-            writeRaw(stream, (unsigned int)objectspost.size());
+            writeRaw(*stream, (char)bplfPlain);
+            writeRaw(*stream, (unsigned int)objectspost.size());
 
-			writeIdVector(stream, oids);
-			writeIdVector(stream, pids);
+			writeIdVector(*stream, oids);
+			writeIdVector(*stream, pids);
 
-			writeChunk(out, stream, kChunkParents, flags);
+			encoder.add(stream, kChunkParents, flags);
 		}
 
 		// Write the end chunk
 		{
-			MemoryOutputStream stream("End");
+			shared_ptr<MemoryOutputStream> stream(new MemoryOutputStream("End"));
 
 			// This footer is required for the Web code to validate that the file is not truncated
 			const char* footer = "</roblox>";
 
-			stream.write(footer, strlen(footer));
+			stream->write(footer, strlen(footer));
 
-			writeChunk(out, stream, kChunkEnd, SerializerBinary::sfNoCompression);
+			encoder.add(stream, kChunkEnd, SerializerBinary::sfNoCompression);
 		}
+
+		encoder.finish();
 	}
 
     static shared_ptr<Instance> createServiceInstance(Instance* root, const Name& name)
@@ -1677,10 +2175,14 @@ namespace RBX
 		}
 	}
 
-	static void deserializeImpl(std::istream& in, Instance* root, Instances* result)
+	static void deserializeImpl(const char* data, size_t size, Instance* root, Instances* result)
 	{
 		FileHeader header;
-		readData(in, &header, sizeof(header));
+
+		if (size < sizeof(header))
+			throw RBX::runtime_error("Unexpected end of file while reading %d bytes", (int)sizeof(header));
+
+		memcpy(&header, data, sizeof(header));
 
 		if (memcmp(header.magic, SerializerBinary::kMagicHeader, sizeof(header.magic)) != 0)
 			throw RBX::runtime_error("Unrecognized format");
@@ -1691,6 +2193,9 @@ namespace RBX
 		if (header.version != 0)
 			throw RBX::runtime_error("Unrecognized version %d", header.version);
 
+		std::vector<ChunkSource> chunks;
+		scanChunks(data, size, sizeof(header), chunks);
+
 		// Read types and object ids
 		std::vector<const Reflection::ClassDescriptor*> types;
 		types.resize(header.types);
@@ -1702,11 +2207,14 @@ namespace RBX
 		std::vector<std::vector<Instance*> > typedobjects;
 		typedobjects.resize(header.types);
 
-		while (in.good())
+		ChunkDecoder decoder(chunks, getDecodeThreadCount(chunks));
+
+		for (size_t i = 0; i < chunks.size(); ++i)
 		{
-			MemoryInputStream stream;
+			const ChunkHeader& chunk = chunks[i].header;
 
-			ChunkHeader chunk = readChunk(in, stream);
+			MemoryInputStream stream;
+			decoder.take(i, stream);
 
 			if (memcmp(chunk.name, kChunkInstances, sizeof(chunk.name)) == 0)
 			{
@@ -1748,9 +2256,34 @@ namespace RBX
 				// Unknown chunk, skip
 			}
 		}
+	}
 
-		// We should only finish reading the file when we see an END chunk
-		throw RBX::runtime_error("Unexpected end of file");
+	static void deserializeImpl(std::istream& in, Instance* root, Instances* result)
+	{
+		std::vector<char> buffer;
+
+		// Size the buffer up front when the stream can tell us how much is left
+		std::streampos start = in.tellg();
+		std::streampos end = start == std::streampos(-1) ? start : in.seekg(0, std::ios::end).tellg();
+
+		if (end != std::streampos(-1) && end >= start)
+		{
+			in.seekg(start);
+			buffer.resize(end - start);
+
+			if (!buffer.empty())
+				readData(in, &buffer[0], buffer.size());
+		}
+		else
+		{
+			in.clear();
+			if (start != std::streampos(-1))
+				in.seekg(start);
+
+			buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+
+		deserializeImpl(buffer.empty() ? NULL : &buffer[0], buffer.size(), root, result);
 	}
 
 	namespace SerializerBinary
@@ -1785,6 +2318,22 @@ namespace RBX
 		{
 			deserializeImpl(in, NULL, &result);
 		}
+
+		void deserialize(const char* data, size_t size, Instance* root)
+		{
+			deserializeImpl(data, size, root, NULL);
+		}
+
+		void deserialize(const char* data, size_t size, Instances& result)
+		{
+			deserializeImpl(data, size, NULL, &result);
+		}
+
+		void deserializeFile(const std::string& fileName, Instance* root)
+		{
+			boost::iostreams::mapped_file_source file(fileName);
+			deserializeImpl(file.data(), file.size(), root, NULL);
+		}
 	}
 }
 
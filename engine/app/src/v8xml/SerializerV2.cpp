@@ -10,6 +10,7 @@
 
 #include "v8xml/SerializerBinary.h"
 
+#include <fstream>
 #include <map>
 
 #if defined(_WIN32) && defined(_MSC_VER)
@@ -127,6 +128,27 @@ void SerializerV2::load(std::istream& stream, RBX::DataModel* dataModel)
     }
 }
 
+void SerializerV2::loadFile(const std::string& fileName, RBX::DataModel* dataModel)
+{
+	std::ifstream stream(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+
+	char header[8];
+	if (!stream.read(header, 8).good())
+		throw std::runtime_error("SerializerV2::loadFile can't read header");
+
+    if (memcmp(header, SerializerBinary::kMagicHeader, 8) == 0)
+    {
+        stream.close();
+        SerializerBinary::deserializeFile(fileName, dataModel);
+    }
+    else
+    {
+        stream.clear();
+        stream.seekg(0, std::ios::beg);
+        loadXML(stream, dataModel);
+    }
+}
+
 void SerializerV2::loadInstances(std::istream& stream, RBX::Instances& result)
 {
 	char header[8];
@@ -4,8 +4,12 @@
 #include "voxel2/Grid.h"
 #include "voxel2/MaterialTable.h"
 
+#include "util/ThreadPool.h"
+
 #include "rbx/Profiler.h"
 
+FASTINTVARIABLE(SmoothTerrainMesherThreads, 0)
+
 namespace RBX { namespace Voxel2 { namespace Mesher {
 
 	static const unsigned char kVertexIndexTable[][3] =
@@ -911,4 +915,300 @@ namespace RBX { namespace Voxel2 { namespace Mesher {
 		return kTextureBasisV;
 	}
 
+	static size_t hashBox(const Box& box, const Vector3int32& offset, int lod, const Options& options)
+	{
+		size_t result = 0;
+
+		boost::hash_combine(result, offset.x);
+		boost::hash_combine(result, offset.y);
+		boost::hash_combine(result, offset.z);
+		boost::hash_combine(result, lod);
+		boost::hash_combine(result, options.generateWater);
+
+		boost::hash_combine(result, box.getSizeX());
+		boost::hash_combine(result, box.getSizeY());
+		boost::hash_combine(result, box.getSizeZ());
+
+		// Cells are 2 bytes, so hash them 2 at a time; an odd cell count leaves one for the end
+		const Cell* cells = box.readRow(0, 0, 0);
+		size_t count = size_t(box.getSizeX()) * box.getSizeY() * box.getSizeZ();
+
+		BOOST_STATIC_ASSERT(sizeof(Cell) == 2);
+
+		for (size_t i = 0; i + 2 <= count; i += 2)
+		{
+			unsigned int pair;
+			memcpy(&pair, &cells[i], sizeof(pair));
+
+			result = (result ^ pair) * 0x01000193;
+		}
+
+		if (count & 1)
+			result = (result ^ (cells[count - 1].getMaterial() | (cells[count - 1].getOccupancy() << 8))) * 0x01000193;
+
+		return avalanche(result);
+	}
+
+	static bool isSameBox(const Box& lhs, const Box& rhs)
+	{
+		if (lhs.getSize() != rhs.getSize())
+			return false;
+
+		size_t count = size_t(lhs.getSizeX()) * lhs.getSizeY() * lhs.getSizeZ();
+
+		return memcmp(lhs.readRow(0, 0, 0), rhs.readRow(0, 0, 0), count * sizeof(Cell)) == 0;
+	}
+
+	static size_t getMemorySize(const Box& box, const BasicMesh& mesh)
+	{
+		return
+			size_t(box.getSizeX()) * box.getSizeY() * box.getSizeZ() * sizeof(Cell) +
+			mesh.vertices.capacity() * sizeof(Vertex) +
+			mesh.indices.capacity() * sizeof(unsigned int);
+	}
+
+	GeometryCache::GeometryCache(size_t memoryLimit)
+		: memoryLimit(memoryLimit)
+		, memorySize(0)
+		, hitCount(0)
+		, missCount(0)
+	{
+	}
+
+	shared_ptr<const BasicMesh> GeometryCache::generateGeometry(const Box& box, const Vector3int32& offset, int lod, const Options& options)
+	{
+		if (box.isEmpty() || memoryLimit == 0)
+			return shared_ptr<const BasicMesh>(new BasicMesh(Mesher::generateGeometry(box, offset, lod, options)));
+
+		size_t hash = hashBox(box, offset, lod, options);
+
+		{
+			boost::mutex::scoped_lock lock(mutex);
+
+			if (shared_ptr<const BasicMesh> mesh = find(hash, box, offset, lod, options))
+			{
+				hitCount++;
+				return mesh;
+			}
+
+			missCount++;
+		}
+
+		// Mesh without holding the lock so that other threads can use the cache meanwhile
+		shared_ptr<const BasicMesh> mesh(new BasicMesh(Mesher::generateGeometry(box, offset, lod, options)));
+
+		boost::mutex::scoped_lock lock(mutex);
+
+		// Another thread may have meshed the same box; hand out one object so that pointers stay comparable
+		if (shared_ptr<const BasicMesh> existing = find(hash, box, offset, lod, options))
+			return existing;
+
+		// The caller may write to its box later, so keep a copy of the cells
+		Entry entry;
+		entry.hash = hash;
+		entry.box = box.clone();
+		entry.offset = offset;
+		entry.lod = lod;
+		entry.generateWater = options.generateWater;
+		entry.mesh = mesh;
+		entry.memorySize = Mesher::getMemorySize(box, *mesh);
+
+		entries.push_front(entry);
+		entryMap.insert(std::make_pair(hash, entries.begin()));
+		memorySize += entry.memorySize;
+
+		trim();
+
+		return mesh;
+	}
+
+	shared_ptr<const BasicMesh> GeometryCache::find(size_t hash, const Box& box, const Vector3int32& offset, int lod, const Options& options)
+	{
+		std::pair<EntryMap::iterator, EntryMap::iterator> range = entryMap.equal_range(hash);
+
+		for (EntryMap::iterator it = range.first; it != range.second; ++it)
+		{
+			EntryList::iterator entry = it->second;
+
+			if (entry->offset == offset && entry->lod == lod && entry->generateWater == options.generateWater && isSameBox(entry->box, box))
+			{
+				entries.splice(entries.begin(), entries, entry);
+
+				return entry->mesh;
+			}
+		}
+
+		return shared_ptr<const BasicMesh>();
+	}
+
+	void GeometryCache::trim()
+	{
+		while (memorySize > memoryLimit && !entries.empty())
+		{
+			EntryList::iterator entry = --entries.end();
+
+			std::pair<EntryMap::iterator, EntryMap::iterator> range = entryMap.equal_range(entry->hash);
+
+			for (EntryMap::iterator it = range.first; it != range.second; ++it)
+				if (it->second == entry)
+				{
+					entryMap.erase(it);
+					break;
+				}
+
+			memorySize -= entry->memorySize;
+			entries.erase(entry);
+		}
+	}
+
+	void GeometryCache::clear()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		entries.clear();
+		entryMap.clear();
+		memorySize = 0;
+	}
+
+	size_t GeometryCache::getMemorySize() const
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		return memorySize;
+	}
+
+	unsigned int GeometryCache::getHitCount() const
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		return hitCount;
+	}
+
+	unsigned int GeometryCache::getMissCount() const
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		return missCount;
+	}
+
+	// Sized from SmoothTerrainMesherThreads on first use. Like other FInts the flag is meant to be set at startup:
+	// changing it later only changes how many helpers a batch asks for, up to the size the pool was created with.
+	static ThreadPool* getMesherPool()
+	{
+		static boost::once_flag flag = BOOST_ONCE_INIT;
+		static ThreadPool* pool = NULL;
+
+		struct Create
+		{
+			static void run(ThreadPool** result)
+			{
+				// Tasks only run while a batch is waiting on them, so the threads can be abandoned at exit
+				*result = new ThreadPool(FInt::SmoothTerrainMesherThreads);
+			}
+		};
+
+		boost::call_once(flag, boost::bind(&Create::run, &pool));
+
+		return pool;
+	}
+
+	struct Batch::State
+	{
+		GeometryCache* cache;
+		Options options;
+		std::vector<Item>* items;
+
+		boost::mutex mutex;
+		boost::condition_variable finished;
+
+		size_t nextItem;
+		size_t completedItems;
+
+		// Set by run() once every item is done; helpers that start late must not touch items
+		bool closed;
+	};
+
+	Batch::Batch(GeometryCache* cache, const Options& options)
+		: cache(cache)
+		, options(options)
+	{
+	}
+
+	size_t Batch::add(const Box& box, const Vector3int32& offset, int lod)
+	{
+		Item item;
+		item.box = box;
+		item.offset = offset;
+		item.lod = lod;
+
+		items.push_back(item);
+
+		return items.size() - 1;
+	}
+
+	void Batch::work(const shared_ptr<State>& state)
+	{
+		while (true)
+		{
+			Item* item;
+
+			{
+				boost::mutex::scoped_lock lock(state->mutex);
+
+				if (state->closed || state->nextItem == state->items->size())
+					return;
+
+				item = &(*state->items)[state->nextItem++];
+			}
+
+			if (state->cache)
+				item->result = state->cache->generateGeometry(item->box, item->offset, item->lod, state->options);
+			else
+				item->result.reset(new BasicMesh(Mesher::generateGeometry(item->box, item->offset, item->lod, state->options)));
+
+			boost::mutex::scoped_lock lock(state->mutex);
+
+			if (++state->completedItems == state->items->size())
+				state->finished.notify_all();
+		}
+	}
+
+	void Batch::run()
+	{
+		RBXPROFILER_SCOPE("Voxel", "Batch::run");
+
+		shared_ptr<State> state(new State());
+		state->cache = cache;
+		state->options = options;
+		state->items = &items;
+		state->nextItem = 0;
+		state->completedItems = 0;
+		state->closed = false;
+
+		for (size_t i = 0; i < items.size(); ++i)
+			items[i].result.reset();
+
+		int helpers = std::min(FInt::SmoothTerrainMesherThreads, int(items.size()) - 1);
+
+		if (helpers > 0)
+		{
+			ThreadPool* pool = getMesherPool();
+
+			// Helpers beyond the pool size would only wait for a thread and find nothing left to do
+			helpers = std::min(helpers, pool->getThreadCount());
+
+			for (int i = 0; i < helpers; ++i)
+				pool->schedule(boost::bind(&Batch::work, state));
+		}
+
+		work(state);
+
+		boost::mutex::scoped_lock lock(state->mutex);
+
+		while (state->completedItems < items.size())
+			state->finished.wait(lock);
+
+		state->closed = true;
+	}
+
 } } }
@@ -529,6 +529,46 @@ RBX_SIMD_INLINE void transpose2x4( T& a, T& b, T& c, T& d, const T& x, const T&
 template< class T >
 RBX_SIMD_INLINE void transpose4x2( T& x, T& y, const T& a, const T& b, const T& c, const T& d );
 
+//
+// Unsigned Integer Arithmetics
+//
+
+// r[i] = a[i] - b[i], wrapping around, i = 0,1,2,3
+RBX_SIMD_INLINE v4u operator-( v4uArg a, v4uArg b );
+
+// r[i] = a[i] & b[i], i = 0,1,2,3
+RBX_SIMD_INLINE v4u operator&( v4uArg a, v4uArg b );
+
+// r[i] = a[i] | b[i], i = 0,1,2,3
+RBX_SIMD_INLINE v4u operator|( v4uArg a, v4uArg b );
+
+// r[i] = a[i] ^ b[i], i = 0,1,2,3
+RBX_SIMD_INLINE v4u operator^( v4uArg a, v4uArg b );
+
+// r[i] = a[i] << count, i = 0,1,2,3
+// count must be in [1, 31]
+template< int count >
+RBX_SIMD_INLINE v4u shiftLeft( v4uArg a );
+
+// r[i] = a[i] >> count, shifting in zeros, i = 0,1,2,3
+// count must be in [1, 31]
+template< int count >
+RBX_SIMD_INLINE v4u shiftRight( v4uArg a );
+
+//
+// Byte planes
+//
+
+// Combine 16 bytes from each of 4 byte planes into 16 words, p0 holding the most significant bytes
+// rk[j] = (p0[4k+j] << 24) | (p1[4k+j] << 16) | (p2[4k+j] << 8) | p3[4k+j], k,j = 0,1,2,3
+// The addresses don't need to be aligned
+RBX_SIMD_INLINE void loadBytePlanes( v4u& r0, v4u& r1, v4u& r2, v4u& r3, const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, const uint8_t* p3 );
+
+// Split 16 words into 4 byte planes of 16 bytes, the inverse of loadBytePlanes
+// p0[4k+j] = ak[j] >> 24, p1[4k+j] = ak[j] >> 16, p2[4k+j] = ak[j] >> 8, p3[4k+j] = ak[j], k,j = 0,1,2,3
+// The addresses don't need to be aligned
+RBX_SIMD_INLINE void storeBytePlanes( uint8_t* p0, uint8_t* p1, uint8_t* p2, uint8_t* p3, v4uArg a0, v4uArg a1, v4uArg a2, v4uArg a3 );
+
 }
 
 }
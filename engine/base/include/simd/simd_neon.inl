@@ -1504,6 +1504,95 @@ RBX_SIMD_INLINE v4f sumAcross4( v4fArg a, v4fArg b )
     return v4f( details::combine( sum, sum ) );
 }
 
+//
+// Unsigned Integer Arithmetics
+//
+
+RBX_SIMD_INLINE v4u operator-( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = vsubq_u32( a.v, b.v );
+    return r;
+}
+
+RBX_SIMD_INLINE v4u operator&( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = vandq_u32( a.v, b.v );
+    return r;
+}
+
+RBX_SIMD_INLINE v4u operator|( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = vorrq_u32( a.v, b.v );
+    return r;
+}
+
+RBX_SIMD_INLINE v4u operator^( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = veorq_u32( a.v, b.v );
+    return r;
+}
+
+template< int count >
+RBX_SIMD_INLINE v4u shiftLeft( v4uArg a )
+{
+    BOOST_STATIC_ASSERT( count >= 1 && count <= 31 );
+    v4u r;
+    r.v = vshlq_n_u32( a.v, count );
+    return r;
+}
+
+template< int count >
+RBX_SIMD_INLINE v4u shiftRight( v4uArg a )
+{
+    BOOST_STATIC_ASSERT( count >= 1 && count <= 31 );
+    v4u r;
+    r.v = vshrq_n_u32( a.v, count );
+    return r;
+}
+
+//
+// Byte planes
+//
+
+RBX_SIMD_INLINE void loadBytePlanes( v4u& r0, v4u& r1, v4u& r2, v4u& r3, const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, const uint8_t* p3 )
+{
+    // 16 bit halves: the low half of each word is {p3,p2}, the high half is {p1,p0}
+    uint8x16x2_t low = vzipq_u8( vld1q_u8( p3 ), vld1q_u8( p2 ) );
+    uint8x16x2_t high = vzipq_u8( vld1q_u8( p1 ), vld1q_u8( p0 ) );
+
+    uint16x8x2_t words0 = vzipq_u16( vreinterpretq_u16_u8( low.val[0] ), vreinterpretq_u16_u8( high.val[0] ) );
+    uint16x8x2_t words1 = vzipq_u16( vreinterpretq_u16_u8( low.val[1] ), vreinterpretq_u16_u8( high.val[1] ) );
+
+    r0.v = vreinterpretq_u32_u16( words0.val[0] );
+    r1.v = vreinterpretq_u32_u16( words0.val[1] );
+    r2.v = vreinterpretq_u32_u16( words1.val[0] );
+    r3.v = vreinterpretq_u32_u16( words1.val[1] );
+}
+
+namespace details
+{
+    // The narrowing moves keep the low half of every element, so no masking is needed
+    RBX_SIMD_INLINE uint8x16_t packBytePlane( uint32x4_t a0, uint32x4_t a1, uint32x4_t a2, uint32x4_t a3 )
+    {
+        uint16x8_t w01 = vcombine_u16( vmovn_u32( a0 ), vmovn_u32( a1 ) );
+        uint16x8_t w23 = vcombine_u16( vmovn_u32( a2 ), vmovn_u32( a3 ) );
+
+        return vcombine_u8( vmovn_u16( w01 ), vmovn_u16( w23 ) );
+    }
+}
+
+RBX_SIMD_INLINE void storeBytePlanes( uint8_t* p0, uint8_t* p1, uint8_t* p2, uint8_t* p3, v4uArg a0, v4uArg a1, v4uArg a2, v4uArg a3 )
+{
+    vst1q_u8( p0, details::packBytePlane( vshrq_n_u32( a0.v, 24 ), vshrq_n_u32( a1.v, 24 ), vshrq_n_u32( a2.v, 24 ), vshrq_n_u32( a3.v, 24 ) ) );
+    vst1q_u8( p1, details::packBytePlane( vshrq_n_u32( a0.v, 16 ), vshrq_n_u32( a1.v, 16 ), vshrq_n_u32( a2.v, 16 ), vshrq_n_u32( a3.v, 16 ) ) );
+    vst1q_u8( p2, details::packBytePlane( vshrq_n_u32( a0.v, 8 ), vshrq_n_u32( a1.v, 8 ), vshrq_n_u32( a2.v, 8 ), vshrq_n_u32( a3.v, 8 ) ) );
+    vst1q_u8( p3, details::packBytePlane( a0.v, a1.v, a2.v, a3.v ) );
+}
+
 //
 // Packing / unpacking
 //
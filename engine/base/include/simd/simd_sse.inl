@@ -1192,6 +1192,104 @@ RBX_SIMD_INLINE v4f sumAcross4( v4fArg a, v4fArg b )
     return ( a0b0a1b1 + a1b1xxxx ) + ( a2b2a3b3 + a3b3xxxx );
 }
 
+//
+// Unsigned Integer Arithmetics
+//
+
+RBX_SIMD_INLINE v4u operator-( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = _mm_sub_epi32( a.v, b.v );
+    return r;
+}
+
+RBX_SIMD_INLINE v4u operator&( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = _mm_and_si128( a.v, b.v );
+    return r;
+}
+
+RBX_SIMD_INLINE v4u operator|( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = _mm_or_si128( a.v, b.v );
+    return r;
+}
+
+RBX_SIMD_INLINE v4u operator^( v4uArg a, v4uArg b )
+{
+    v4u r;
+    r.v = _mm_xor_si128( a.v, b.v );
+    return r;
+}
+
+template< int count >
+RBX_SIMD_INLINE v4u shiftLeft( v4uArg a )
+{
+    BOOST_STATIC_ASSERT( count >= 1 && count <= 31 );
+    v4u r;
+    r.v = _mm_slli_epi32( a.v, count );
+    return r;
+}
+
+template< int count >
+RBX_SIMD_INLINE v4u shiftRight( v4uArg a )
+{
+    BOOST_STATIC_ASSERT( count >= 1 && count <= 31 );
+    v4u r;
+    r.v = _mm_srli_epi32( a.v, count );
+    return r;
+}
+
+//
+// Byte planes
+//
+
+RBX_SIMD_INLINE void loadBytePlanes( v4u& r0, v4u& r1, v4u& r2, v4u& r3, const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, const uint8_t* p3 )
+{
+    __m128i b0 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p0 ) );
+    __m128i b1 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p1 ) );
+    __m128i b2 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p2 ) );
+    __m128i b3 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p3 ) );
+
+    // 16 bit halves: the low half of each word is {p3,p2}, the high half is {p1,p0}
+    __m128i low0 = _mm_unpacklo_epi8( b3, b2 );
+    __m128i low1 = _mm_unpackhi_epi8( b3, b2 );
+    __m128i high0 = _mm_unpacklo_epi8( b1, b0 );
+    __m128i high1 = _mm_unpackhi_epi8( b1, b0 );
+
+    r0.v = _mm_unpacklo_epi16( low0, high0 );
+    r1.v = _mm_unpackhi_epi16( low0, high0 );
+    r2.v = _mm_unpacklo_epi16( low1, high1 );
+    r3.v = _mm_unpackhi_epi16( low1, high1 );
+}
+
+namespace details
+{
+    template< int shift >
+    RBX_SIMD_INLINE __m128i packBytePlane( __m128i a0, __m128i a1, __m128i a2, __m128i a3 )
+    {
+        const __m128i mask = _mm_set1_epi32( 0xff );
+
+        // After masking every word fits in a signed 16 bit integer, so the saturating packs are exact
+        __m128i w0 = _mm_and_si128( _mm_srli_epi32( a0, shift ), mask );
+        __m128i w1 = _mm_and_si128( _mm_srli_epi32( a1, shift ), mask );
+        __m128i w2 = _mm_and_si128( _mm_srli_epi32( a2, shift ), mask );
+        __m128i w3 = _mm_and_si128( _mm_srli_epi32( a3, shift ), mask );
+
+        return _mm_packus_epi16( _mm_packs_epi32( w0, w1 ), _mm_packs_epi32( w2, w3 ) );
+    }
+}
+
+RBX_SIMD_INLINE void storeBytePlanes( uint8_t* p0, uint8_t* p1, uint8_t* p2, uint8_t* p3, v4uArg a0, v4uArg a1, v4uArg a2, v4uArg a3 )
+{
+    _mm_storeu_si128( reinterpret_cast< __m128i* >( p0 ), details::packBytePlane< 24 >( a0.v, a1.v, a2.v, a3.v ) );
+    _mm_storeu_si128( reinterpret_cast< __m128i* >( p1 ), details::packBytePlane< 16 >( a0.v, a1.v, a2.v, a3.v ) );
+    _mm_storeu_si128( reinterpret_cast< __m128i* >( p2 ), details::packBytePlane< 8 >( a0.v, a1.v, a2.v, a3.v ) );
+    _mm_storeu_si128( reinterpret_cast< __m128i* >( p3 ), details::packBytePlane< 0 >( a0.v, a1.v, a2.v, a3.v ) );
+}
+
 //
 // Packing / unpacking
 //
@@ -15,6 +15,9 @@ namespace Network {
 	public:
 		typedef enum {UNCOMPRESSED = 0, RAKNET_COMPRESSED, HEAVILY_COMPRESSED} CompressionType;
 
+		// Number of translations per part the receiver keeps around to decode deltas against
+		enum { deltaTranslationHistorySize = 16 };
+
 	private:
 		static bool canHeavilyCompressTranslation(const Vector3& translation);
 
@@ -27,6 +30,15 @@ namespace Network {
 
 		static void readTranslation(RakNet::BitStream& bitStream, Vector3& translation);
 		static void readRotation(RakNet::BitStream& bitStream, Matrix3& rotation);
+
+		// The translation readTranslation returns for one written with writeTranslation
+		static Vector3 decodedTranslation(const Vector3& translation, CompressionType compressionType);
+
+		// Translation as quantized residuals against a translation the receiver already has.
+		// writeTranslationDelta returns the translation the receiver will decode.
+		static bool canDeltaCompressTranslation(const Vector3& translation, const Vector3& reference);
+		static Vector3 writeTranslationDelta(RakNet::BitStream& bitStream, const Vector3& translation, const Vector3& reference);
+		static void readTranslationDelta(RakNet::BitStream& bitStream, const Vector3& reference, Vector3& translation);
 	};
 
 }}
\ No newline at end of file
@@ -73,6 +73,8 @@ namespace RBX {
 			boost::shared_ptr<PacketJob> packetJob;
 			class StatsUpdateJob;
 			boost::shared_ptr<StatsUpdateJob> statsUpdateJob;
+			class BitStreamPool;
+			boost::shared_ptr<BitStreamPool> bitStreamPool;
 			RBX::DataModel* const dataModel;
 
 
@@ -90,7 +92,12 @@ namespace RBX {
 
 			bool equals(RakNet::RakPeerInterface* peer) const { return this->peer.get() == peer; }
 
-			void Send(boost::shared_ptr<const RakNet::BitStream> bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, RakNet::SystemAddress systemAddress, bool broadcast );
+			// An empty BitStream for an outgoing packet. It goes back to a pool when the last reference is
+			// dropped, usually once PacketJob has handed it to RakNet, so its buffer is reused by the next packet
+			boost::shared_ptr<RakNet::BitStream> allocateBitStream(unsigned int initialBytesToAllocate = 0);
+
+			// forceReceiptNumber comes from rawPeer()->IncrementNextSendReceipt(), which is thread-safe
+			void Send(boost::shared_ptr<const RakNet::BitStream> bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, RakNet::SystemAddress systemAddress, bool broadcast, uint32_t forceReceiptNumber = 0 );
 			
 			void DeallocatePacket(RakNet::Packet *packet ) 
 			{ 
@@ -4,6 +4,7 @@
 #include "v8tree/Service.h"
 #include "v8datamodel/PartInstance.h"
 #include "rbx/signal.h"
+#include "rbx/atomic.h"
 #include <boost/unordered/unordered_map.hpp>
 
 namespace RakNet {
@@ -75,11 +76,16 @@ namespace RBX {
 			typedef DescribedNonCreatable<InstancePacketCache, Instance, sInstancePacketCache> Super;
 			typedef std::list<rbx::signals::connection> ConnectionList;
 
+			static rbx::atomic<int> nextVersion;
+
 			class CachedBitStream
 			{
 			public:
 				bool dirty;
 
+				// changes whenever the instance does, and is never reused by another entry
+				int version;
+
 				// regular new instance data containing non dictionary properties, and join time data containing all properties (except parent)
 				boost::shared_ptr<RakNet::BitStream> bitStream[2];
 
@@ -89,16 +95,39 @@ namespace RBX {
 				rbx::signals::scoped_connection propChangedConnection;
 				rbx::signals::scoped_connection ancestorChangedConnection;
 
-				CachedBitStream(const std::string& guid) : dirty(true), guidString(guid) {}
+				CachedBitStream(const std::string& guid) : dirty(true), version(++nextVersion), guidString(guid) {}
 				~CachedBitStream() {}
 
-				void onPropertyChanged(const RBX::Reflection::PropertyDescriptor* desc) { dirty = true; }
+				void onPropertyChanged(const RBX::Reflection::PropertyDescriptor* desc) { dirty = true; version = ++nextVersion; }
 			};
 
 			typedef boost::unordered_map<const Instance*, boost::shared_ptr<CachedBitStream> > StreamCacheMap;
 			StreamCacheMap streamCache;
 			boost::shared_mutex sharedMutex;
 
+		public:
+			// A compressed run of join data, exactly as one JoinDataItem::write sent it. Players joining
+			// afterwards walk the same instances in the same order, so they are sent these bytes as they are
+			// rather than each recompressing the whole place. A chunk stops matching as soon as one of its
+			// instances changes, and the next joiner rebuilds just that chunk.
+			class JoinDataChunk
+			{
+			public:
+				struct Entry
+				{
+					const Instance* instance;
+					int version;
+				};
+				std::vector<Entry> entries;
+				int compressionLevel;
+				boost::shared_ptr<RakNet::BitStream> compressedData;
+			};
+
+		private:
+			// keyed by the first instance of the chunk
+			typedef boost::unordered_map<const Instance*, boost::shared_ptr<const JoinDataChunk> > JoinDataChunkMap;
+			JoinDataChunkMap joinDataChunks;
+
 			ConnectionList connections;
 
 			void onAncestorChanged(shared_ptr<Instance> instance, shared_ptr<Instance> newParent);
@@ -118,6 +147,60 @@ namespace RBX {
 			// copy data from bitStream starting at its read position to numBits
 			bool update(const Instance* key, RakNet::BitStream& bitStream, unsigned int numBits, bool isJoinData);
 
+			// Read before writing an instance, a JoinDataChunk holding it is valid while the version stays the same
+			bool getVersion(const Instance* key, int& version);
+
+			// The chunk starting at key, if every instance in it is unchanged since it was built
+			boost::shared_ptr<const JoinDataChunk> fetchJoinDataChunkIfUpToDate(const Instance* key);
+
+			void updateJoinDataChunk(boost::shared_ptr<const JoinDataChunk> chunk);
+
+		protected:
+			virtual void onServiceProvider(ServiceProvider* oldProvider, ServiceProvider* newProvider);
+		};
+
+
+		// Encoded property values shared by all the ServerReplicators, so a change that goes out to every
+		// client is serialized once. Only values whose encoding doesn't depend on per-replicator dictionaries are kept.
+		extern const char* const sPropertyPacketCache;
+		class PropertyPacketCache
+			: public DescribedNonCreatable<PropertyPacketCache, Instance, sPropertyPacketCache>
+			, public Service
+		{
+			typedef DescribedNonCreatable<PropertyPacketCache, Instance, sPropertyPacketCache> Super;
+
+			class CachedInstance
+			{
+			public:
+				// guards against a new instance reusing the address of a destroyed one
+				boost::weak_ptr<const Instance> instance;
+
+				typedef boost::unordered_map<const Reflection::PropertyDescriptor*, boost::shared_ptr<RakNet::BitStream> > PropertyMap;
+				PropertyMap properties;
+
+				CachedInstance(const boost::weak_ptr<const Instance>& instance) : instance(instance) {}
+			};
+
+			typedef boost::unordered_map<const Instance*, CachedInstance> StreamCacheMap;
+			StreamCacheMap streamCache;
+			boost::shared_mutex sharedMutex;
+
+		public:
+			PropertyPacketCache();
+			~PropertyPacketCache();
+
+			static bool canCache(const Reflection::PropertyDescriptor& desc);
+
+			bool fetchIfUpToDate(const Instance* key, const Reflection::PropertyDescriptor& desc, RakNet::BitStream& outBitStream);
+
+			// copy numBits of bitStream starting at startBitPos
+			void update(const Instance* key, const Reflection::PropertyDescriptor& desc, RakNet::BitStream& bitStream, unsigned int startBitPos, unsigned int numBits);
+
+			// must be called for every change of a cacheable property, before any replicator sends it
+			void invalidate(const Instance* key, const Reflection::PropertyDescriptor& desc);
+
+			void remove(const Instance* key);
+
 		protected:
 			virtual void onServiceProvider(ServiceProvider* oldProvider, ServiceProvider* newProvider);
 		};
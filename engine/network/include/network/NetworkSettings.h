@@ -34,6 +34,7 @@ namespace RBX
 
 		bool usePhysicsPacketCache;
 		bool useInstancePacketCache;
+		bool usePropertyPacketCache;
 
 		bool profiling;
         bool profilecpu;
@@ -6,11 +6,13 @@
 #include "rbx/Declarations.h"
 #include "rbx/Boost.hpp"
 #include <vector>
+#include <boost/unordered_map.hpp>
 
 #include "RakNetTypes.h"
 #include "GetTime.h"
 
 #include "GfxBase/IAdornable.h"
+#include "Compressor.h"
 
 namespace RakNet {
 	class BitStream;
@@ -53,8 +55,9 @@ namespace RBX
         void readMovementHistory(RakNet::BitStream& bitStream, RemoteTime remoteSendTime, PartInstance* rootPart, MechanismItem& mechanismItem, int& numNodesInHistory);
 		void readMechanismAttributes(RakNet::BitStream& bitStream, MechanismItem& item);
 
-		void readAssembly(RakNet::BitStream& bitstream, PartInstance* rootPart, MechanismItem& mechanismItem, bool crossPacketCompression);
-		void readPV(RakNet::BitStream& bitStream, AssemblyItem& item, bool crossPacketCompression);
+		void readAssembly(RakNet::BitStream& bitstream, PartInstance* rootPart, MechanismItem& mechanismItem, bool crossPacketCompression, bool deltaTranslation = false);
+		void readPV(RakNet::BitStream& bitStream, AssemblyItem& item, bool crossPacketCompression, bool deltaTranslation = false);
+		bool readTranslationKeyframe(RakNet::BitStream& bitStream, PartInstance* rootPart, unsigned char& generation, bool& deltaTranslation, Vector3& translation);
 		void readCoordinateFrame(RakNet::BitStream& bitStream, CoordinateFrame& cFrame);
 		void readVelocity(RakNet::BitStream& bitStream, Velocity& velocity);
 		void readMotorAngles(RakNet::BitStream& bitStream, AssemblyItem& item);
@@ -62,6 +65,29 @@ namespace RBX
 
 		bool receivePart(shared_ptr<PartInstance>& part, RakNet::BitStream& inBitstream);
 
+		// The last few root translations received per part, by generation, for delta translations to refer to
+		struct TranslationKeyframes
+		{
+			struct Keyframe
+			{
+				Vector3 translation;
+				unsigned char generation;
+				bool valid;
+			};
+
+			weak_ptr<PartInstance> part;
+			unsigned char newestGeneration;
+			Keyframe keyframes[Compressor::deltaTranslationHistorySize];
+
+			TranslationKeyframes();
+		};
+		typedef boost::unordered_map<const PartInstance*, TranslationKeyframes> TranslationKeyframeMap;
+		TranslationKeyframeMap translationKeyframes;
+		size_t translationKeyframesPruneSize;
+
+		TranslationKeyframes& getTranslationKeyframes(PartInstance* part);
+		void storeTranslationKeyframe(PartInstance* part, unsigned char generation, const Vector3& translation, bool isDelta);
+
 	protected:
 
         struct MovementWaypointAdorn
@@ -43,11 +43,13 @@ class Replicator::JoinDataItem : public Item
 	size_t maxInstancesToWrite;
 
 	bool canUseCache(const Instance* instance);
+	bool canUseJoinDataChunks() const;
 
 protected:
 	bool writeInstance(const Instance* instance, RakNet::BitStream& bitStream);
 
 	size_t writeInstances(RakNet::BitStream& bitStream);
+	size_t writeCachedJoinDataChunk(RakNet::BitStream& bitStream);
 
     void writeBonus(RakNet::BitStream& bitStream, unsigned int bytes)
 	{
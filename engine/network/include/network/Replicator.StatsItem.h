@@ -106,6 +106,7 @@ class Replicator::Stats : public RBX::Stats::Item
 	Stats::Item* congestionControlExceeded;
 	Stats::Item* instanceSize;
 	Stats::Item* incomingPacketsSize;
+	Stats::Item* deserializeQueueDepth;
 	Stats::Item* characterPacketsSent;
 	Stats::Item* characterPacketsReceived;
 	Stats::Item* dataPacketsSent;
@@ -137,6 +138,12 @@ class Replicator::Stats : public RBX::Stats::Item
     Stats::Item* physicsPacketDetailedStats_sent;
     Stats::Item* physicsPacketDetailedStats_received;
 	Stats::Item* maxPacketloss;
+	Stats::Item* propertySendAttribution;
+	Stats::Item* eventSendAttribution;
+
+	typedef std::map<std::string, Stats::Item*> AttributionItems;
+	AttributionItems propertySendAttributionItems;
+	AttributionItems eventSendAttributionItems;
     
 	void addStat(const ReplicatorStats& stats, const char* name,
 			const ReplicatorStats::PacketType type) {
@@ -149,6 +156,22 @@ class Replicator::Stats : public RBX::Stats::Item
 
     }
     
+	static void updateAttribution(Stats::Item* parent, AttributionItems& items, const ReplicatorStats::SendAttributionMap& attribution)
+	{
+		double total = 0;
+		for (ReplicatorStats::SendAttributionMap::const_iterator iter = attribution.begin(); iter != attribution.end(); ++iter)
+		{
+			Stats::Item*& item = items[iter->first];
+			if (!item)
+				item = parent->createChildItem(iter->first.c_str());
+
+			const int bytes = iter->second.bytes.getCount();
+			item->formatValue(bytes, "%d B/s, %d items/s, %.3f ms/s", bytes, iter->second.items.getCount(), 1000.0 * iter->second.encodeSeconds.getCount());
+			total += bytes;
+		}
+		parent->formatValue(total, "%.0f B/s", total);
+	}
+
 protected:
 	const weak_ptr<const Replicator> replicator;
 public:
@@ -172,6 +195,7 @@ public:
 		send->createBoundChildItem("Split Messages", stats.numberOfSplitMessages);
 
 		bufferHealth = createBoundChildItem("Send Buffer Health", stats.bufferHealth);
+		createBoundChildItem("Send Rate Scale", stats.sendRateScale);
 
 		bandwidthExceeded = createChildItem("BandwidthExceeded");
 		congestionControlExceeded = createChildItem("CongestionControlExceeded");
@@ -209,6 +233,10 @@ public:
         addStat(stats, ReplicatorStats::kPacketTypeNames[ReplicatorStats::PACKET_TYPE_CategoryControl],    ReplicatorStats::PACKET_TYPE_CategoryControl);
 		addStat(stats, ReplicatorStats::kPacketTypeNames[ReplicatorStats::PACKET_TYPE_Event],			   ReplicatorStats::PACKET_TYPE_Event);
 
+		Item* sendAttribution = createChildItem("Send Attribution");
+			propertySendAttribution = sendAttribution->createChildItem("Properties");
+			eventSendAttribution = sendAttribution->createChildItem("Events");
+
 		physicsPacketsSent = createChildItem("Sent Physics Packets");
 			physicsPacketsSent->createBoundChildItem("Size",
                 stats.physicsSenderStats.physicsPacketsSentSize);
@@ -226,6 +254,7 @@ public:
 
 		dataPacketsReceived = createChildItem("Received Data Packets");
 			incomingPacketsSize = dataPacketsReceived->createChildItem("Queue Size");
+			deserializeQueueDepth = dataPacketsReceived->createBoundChildItem("Deserialize Queue", stats.deserializeQueueDepth);
 			instanceSize = dataPacketsReceived->createChildItem("Instance Size");
 			waitingRefs = dataPacketsReceived->createChildItem("Waiting Refs");
             dataPacketsReceivedSize = dataPacketsReceived->createChildItem("Size");
@@ -290,6 +319,9 @@ public:
 			dataPacketsReceivedTypes->visitChildren(boost::bind(&accumulateValue, _1, &total));
 			dataPacketsReceivedTypes->formatValue(total);
 
+			updateAttribution(propertySendAttribution, propertySendAttributionItems, stats.propertySendAttribution);
+			updateAttribution(eventSendAttribution, eventSendAttributionItems, stats.eventSendAttribution);
+
 			clusterPacketsSent->formatRate(stats.clusterPacketsSent);
 			clusterPacketsReceived->formatRate(stats.clusterPacketsReceived);
             clusterPacketsReceivedSize->formatValue(stats.clusterPacketsReceivedSize.value());
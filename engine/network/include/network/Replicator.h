@@ -6,6 +6,7 @@
 #include "NetworkSettings.h"
 #include "PacketIds.h"
 #include "ReplicatorStats.h"
+#include "SendRateController.h"
 #include "Streaming.h"
 #include "network/api.h"
 #include "raknet/PluginInterface2.h"
@@ -43,6 +44,7 @@ namespace RakNet {
 }
 
 struct ReplicatorTestWrapper;
+struct ReplicatorDeserializeTestWrapper;
 
 namespace RBX {
 
@@ -64,6 +66,7 @@ class PhysicsSender;
 class PhysicsReceiver;
 class Marker;
 class InstancePacketCache;
+class PropertyPacketCache;
 class ClusterPacketCache;
 class OneQuarterClusterPacketCache;
 class StrictNetworkFilter;
@@ -107,6 +110,7 @@ class Replicator
 
 public:
 	friend struct ::ReplicatorTestWrapper; //testing
+	friend struct ::ReplicatorDeserializeTestWrapper; //testing
 
     enum PropertyCacheType
     {
@@ -176,6 +180,19 @@ public:
     Instance* removingInstance; // The currently deleting Instance
     ReplicatorStats replicatorStats;
 
+	// Only set when adaptive send rates are on for this connection
+	boost::scoped_ptr<SendRateController> sendRateController;
+	float dataSendCredit;
+	float physicsSendCredit;
+
+	// RakNet ack/loss notices for physics packets sent with a receipt
+	struct PhysicsSendReceipt
+	{
+		uint32_t receipt;
+		bool acked;
+	};
+	rbx::safe_queue<PhysicsSendReceipt> physicsSendReceipts;
+
 	// ServerReplicator and Client implement these
 	virtual bool checkDistributedReceive(PartInstance* part) = 0;
 	virtual bool checkDistributedSend(const PartInstance* part) = 0;
@@ -195,6 +212,11 @@ public:
 	unsigned int getApproximateSizeOfPendingClusterDeltas() const { return approximateSizeOfPendingClusterDeltas; }
 	size_t getAdjustedMtuSize() const;
 	size_t getPhysicsMtuSize() const;
+	size_t getDataPacketSize() const;
+
+	float getSendRateScale() const { return sendRateController ? sendRateController->getScale() : 1.0f; }
+	// Returns false if the physics sender should skip this step to stay within the send rate scale
+	bool consumePhysicsSendCredit();
 
 	// Used for debugging
 	void disableProcessPackets();
@@ -347,6 +369,7 @@ protected:
 	unsigned int approximateSizeOfPendingClusterDeltas;
 
 	shared_ptr<InstancePacketCache> instancePacketCache;
+	shared_ptr<PropertyPacketCache> propertyPacketCache;
 	shared_ptr<OneQuarterClusterPacketCache> oneQuarterClusterPacketCache; // used by streaming
 	shared_ptr<ClusterPacketCache> clusterPacketCache;
 
@@ -662,8 +685,18 @@ private:
 	std::list<RakNet::Packet*> packetsToDeserailze;
 	rbx::timestamped_safe_queue<DeserializedPacket> deserializedPackets;
 
+	// With a shared deserialize pool, at most one task per replicator is queued or running at a time,
+	// which keeps this connection's packets in order
+	bool deserializePacketsPooled;
+	bool deserializePacketsTaskScheduled;
+	bool deserializePacketsFailed;				// a packet failed to decode, the connection is being dropped
+	boost::condition_variable deserializePacketsTaskFinished;
+
 	boost::scoped_ptr<boost::thread> deserializePacketsThread;
+	bool isDeserializingPacketsOffThread() const { return deserializePacketsThread || deserializePacketsPooled; }
 	void deserializePacketsThreadImpl();
+	void deserializePacketsTask();
+	bool deserializeReceivedPacket(RakNet::Packet* receivedPacket);
 	void deserializeData(RakNet::BitStream& inBitstream, std::vector<shared_ptr<DeserializedItem> >& items);
 
 	void logPacketError(RakNet::Packet* packet, const std::string& type, const std::string& message);
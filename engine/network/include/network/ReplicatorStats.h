@@ -4,6 +4,9 @@
 #include "Item.h"
 #include "v8datamodel/Stats.h"
 
+#include <map>
+#include <string>
+
 namespace RBX {
 namespace Network {
 
@@ -80,6 +83,21 @@ struct ReplicatorStats {
     PacketSizeByTypeMap dataPacketSizeSentTypes;
     PacketSizeByTypeMap dataPacketSizeReceiveTypes;
 
+	// Outgoing bytes, items and encode time broken down by the member that produced
+	// them ("Class.Property", "Class.Event", or the full name of a RemoteEvent/RemoteFunction).
+	// Only one in DFInt::ReplicatorSendAttributionSampleInterval items is measured and the
+	// totals are scaled back up, so this can stay on for live servers.
+	struct SendAttribution {
+		TotalCountTimeInterval<int> items;
+		TotalCountTimeInterval<int> bytes;
+		TotalCountTimeInterval<double> encodeSeconds;
+	};
+	typedef std::map<std::string, SendAttribution> SendAttributionMap;
+
+	SendAttributionMap propertySendAttribution;
+	SendAttributionMap eventSendAttribution;
+	unsigned int sendAttributionCounter;
+
     // Incoming packets
 	double kiloBytesReceivedPerSecond;
 
@@ -97,12 +115,18 @@ struct ReplicatorStats {
     RunningAverageTimeInterval<> touchPacketsReceived;
     RunningAverage<double> touchPacketsReceivedSize;
 
+	// packets received but not deserialized yet, sampled on receive when deserializing off the DataModel thread
+	RunningAverage<int> deserializeQueueDepth;
+
    double kiloBytesSentPerSecond;
 
 	// 0 to 1
 	// 1: good, nothing in buffer, room to grow. 0: bad, buffer is increasing, should probably send less data
 	double bufferHealth;
 
+	// Share of the desired send rate the connection is allowed, see SendRateController
+	RunningAverage<double> sendRateScale;
+
 	RunningAverageTimeInterval<> dataPacketsSent;
 	RunningAverage<double> dataPacketSendThrottle;
 	RunningAverage<int> dataPacketsSentSize;
@@ -145,6 +169,13 @@ struct ReplicatorStats {
     void samplePacketsReceived(PacketType type, int size);
     void samplePacketsReceived(const std::string& categoryName, int size);
 
+    static std::string propertyAttributionKey(const Instance* instance, const Reflection::PropertyDescriptor& desc);
+    static std::string eventAttributionKey(const Instance* instance, const Reflection::EventDescriptor& desc);
+
+    // Returns the scale to apply to the next item's sample, or 0 if it should not be attributed
+    int beginSendAttribution();
+    void sampleSendAttribution(SendAttributionMap& map, const std::string& key, int scale, int bytes, double encodeSeconds);
+
     void resetSecurityTimes();
 
 };
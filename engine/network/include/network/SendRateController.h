@@ -0,0 +1,31 @@
+#pragma once
+
+#include "rbx/rbxTime.h"
+
+namespace RBX { namespace Network {
+
+// Scales how much a Replicator sends to one peer, based on that peer's connection quality.
+// The scale backs off multiplicatively (at most once per round trip) while the peer's send
+// buffer is growing, packets are being lost or the ping is climbing above its best value,
+// and recovers linearly once the connection settles down.
+class SendRateController
+{
+public:
+	SendRateController();
+
+	// bufferHealth is ConnectionStats::bufferHealth (0: buffer growing, 1: empty),
+	// packetLoss is 0..1 over the last second
+	void update(double bufferHealth, float packetLoss, int averagePing, int lowestPing, const Time& now);
+
+	// 1 when the connection keeps up, down to DFInt::SendRateControllerMinPercent when it doesn't
+	float getScale() const { return scale; }
+	bool isCongested() const { return congested; }
+
+private:
+	float scale;
+	bool congested;
+	Time lastUpdate;
+	Time lastDecrease;
+};
+
+}}
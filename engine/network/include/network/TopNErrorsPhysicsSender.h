@@ -9,6 +9,8 @@
 #include "boost/pool/pool_alloc.hpp"
 
 
+struct TopNErrorsPhysicsSenderTestWrapper;
+
 namespace RBX { 
 	
 	class Instance;
@@ -22,6 +24,8 @@ namespace RBX {
 
 	class TopNErrorsPhysicsSender : public PhysicsSender
 	{
+		friend struct ::TopNErrorsPhysicsSenderTestWrapper; //testing
+
 		class Nugget;
 
 		typedef std::list<shared_ptr<PartInstance>, boost::fast_pool_allocator<shared_ptr<PartInstance> > > Assemblies;
@@ -43,16 +47,27 @@ namespace RBX {
 
 			void onSent(const Time& t, const CoordinateFrame& cf, float accumulatedError);
 			void computeError(const CoordinateFrame& focus, const ModelInstance* focusModel, int timestamp, const TopNErrorsPhysicsSender* sender);
+			void computeInterest(float squaredDistance, const Time& now);
 
 			CoordinateFrame lastSent;	// the CF last sent
 			bool sendDetailed;			// Should this send detailed (uncompressed) physics info
 			bool notInService;
+			bool outOfInterest;			// Too far from the player's character to send this step
 			float biggestSize;			// May change for an articulated assembly....
 			float radius;				// cached assembly radius
 
             Time lastSendTime;
             float accumulatedError;
 
+			// Delta translation: the newest full translation the client acknowledged, and the generation it was sent with.
+			// Acked deltas are not used as references, the client may have dropped one it could not decode.
+			Vector3 ackedTranslation;
+			unsigned char ackedGeneration;
+			bool hasAckedTranslation;
+			unsigned char nextGeneration;
+
+			void onTranslationReceipt(unsigned char generation, const Vector3& translation, bool delta, bool acked);
+
 			static float minDistance();
 			static float maxDistance();
 			static float minSize();
@@ -64,6 +79,27 @@ namespace RBX {
 			}
 		};
 		
+		// A translation sent with a generation, waiting for the client to ack or lose the packet it went out in
+		struct SentTranslation
+		{
+			shared_ptr<const PartInstance> part;
+			unsigned char generation;
+			Vector3 translation;
+			bool delta;
+		};
+		typedef std::vector<SentTranslation> SentTranslations;
+
+		struct SentPacket
+		{
+			uint32_t receipt;
+			SentTranslations translations;
+		};
+
+		std::deque<SentPacket> sentPackets;			// packets with translations, oldest first
+		SentTranslations packetTranslations;		// translations in the packet being written
+		const Nugget* sendingNugget;				// nugget being written by sendPhysicsData
+		bool deltaTranslation;						// the root assembly's translation was sent as a delta
+
 		shared_ptr<PhysicsService> physicsService;
 		shared_ptr<PhysicsPacketCache> physicsPacketCache;
 		int stepId;
@@ -90,7 +126,10 @@ namespace RBX {
 
 	private:
 		void updateErrors();
-		bool sendPhysicsData(RakNet::BitStream& bitStream, const Nugget& nugget, CoordinateFrame& outLastSendCFrame, float& accumulatedError, const PartInstance* playerHead);
+		void processSendReceipts();
+		void writeTranslationKeyframe(RakNet::BitStream& bitStream, const Vector3& translation, Compressor::CompressionType compressionType);
+		void sendBitStream(const boost::shared_ptr<RakNet::BitStream>& bitStream, PacketPriority packetPriority, ReplicatorStats::PhysicsSenderStats* stats, int sentItemCount);
+		bool sendPhysicsData(RakNet::BitStream& bitStream, Nugget& nugget, CoordinateFrame& outLastSendCFrame, float& accumulatedError, const PartInstance* playerHead);
 
 		void addNugget(PartInstance& part);
 		void addNugget2(shared_ptr<PartInstance> part);
@@ -164,6 +164,12 @@
 #define INTERNAL_PACKET_PAGE_SIZE 8
 #endif
 
+// Most datagrams a single recvmmsg / sendmmsg call handles, when RakPeer batches socket I/O on Linux.
+// The send batch allocates about MAXIMUM_MTU_SIZE*SOCKET_BATCH_MAX_DATAGRAMS bytes per instance of RakPeer
+#ifndef SOCKET_BATCH_MAX_DATAGRAMS
+#define SOCKET_BATCH_MAX_DATAGRAMS 32
+#endif
+
 //#define USE_THREADED_SEND
 
 #endif // __RAKNET_DEFINES_H
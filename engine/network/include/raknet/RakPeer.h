@@ -27,6 +27,7 @@
 #include "NativeFeatureIncludes.h"
 #include "SecureHandshake.h"
 #include "LocklessTypes.h"
+#include "SocketLayer.h"
 
 namespace RakNet {
 /// Forward declarations
@@ -866,6 +867,9 @@ protected:
 
 	DataStructures::ThreadsafeAllocatingQueue<RecvFromStruct> bufferedPackets;
 
+	// ROBLOX: datagrams sent by the reliability layers during one update cycle, sent together
+	SocketLayerSendBatch sendBatch;
+
 
 	struct SocketQueryOutput
 	{
@@ -41,6 +41,40 @@ public:
 };
 
 
+/// Holds the datagrams SocketLayer::SendTo is given on one thread between Begin() and End(), so they go out
+/// with one sendmmsg per socket rather than one sendto each. Only Linux batches; elsewhere SendTo sends immediately.
+class RAK_DLL_EXPORT SocketLayerSendBatch
+{
+public:
+	SocketLayerSendBatch();
+	~SocketLayerSendBatch();
+
+	/// Start holding datagrams sent from the calling thread, sending them at most \a capacity at a time.
+	/// A capacity of 1 or less leaves sends unbatched
+	void Begin( int capacity );
+
+	/// Send everything held and stop holding datagrams
+	void End( void );
+
+	/// Called by SocketLayer::SendTo, sends the held datagrams first if this one is for another socket or the batch is full
+	void Add( SOCKET s, const char *data, int length, const SystemAddress &systemAddress );
+
+private:
+	void Flush( void );
+
+	struct Datagram
+	{
+		char data[ MAXIMUM_MTU_SIZE ];
+		int length;
+		SystemAddress systemAddress;
+	};
+
+	Datagram *datagrams;
+	int capacity;
+	int count;
+	SOCKET s;
+};
+
 // A platform independent implementation of Berkeley sockets, with settings used by RakNet
 class RAK_DLL_EXPORT SocketLayer
 {
@@ -87,6 +121,16 @@ public:
 	static void RecvFromBlocking_Old( const SOCKET s, RakPeer *rakPeer, unsigned short remotePortRakNetWasStartedOn_PS3, unsigned int extraSocketOptions, char *dataOut, int *bytesReadOut, SystemAddress *systemAddressOut, RakNet::TimeUS *timeRead );
 	static void RecvFromBlocking( const SOCKET s, RakPeer *rakPeer, unsigned short remotePortRakNetWasStartedOn_PS3, unsigned int extraSocketOptions, char *dataOut, int *bytesReadOut, SystemAddress *systemAddressOut, RakNet::TimeUS *timeRead );
 
+	/// Read up to \a count datagrams with a single recvmmsg, blocking until the first one arrives. Linux only
+	/// \param[in] s the socket
+	/// \param[in] count How many buffers \a dataOut holds, at most SOCKET_BATCH_MAX_DATAGRAMS
+	/// \param[out] dataOut Buffers of MAXIMUM_MTU_SIZE bytes, datagram i is written to dataOut[i]
+	/// \param[out] bytesReadOut Length of each datagram read
+	/// \param[out] systemAddressOut Sender of each datagram read
+	/// \param[out] timeRead When the datagrams were read
+	/// \return The number of datagrams read, 0 on error
+	static int RecvFromBlockingBatch( const SOCKET s, int count, char *dataOut[], int bytesReadOut[], SystemAddress systemAddressOut[], RakNet::TimeUS *timeRead );
+
 	/// Given a socket and IP, retrieves the subnet mask, on linux the socket is unused
 	/// \param[in] inSock the socket 
 	/// \param[in] inIpString The ip of the interface you wish to retrieve the subnet mask from
@@ -3,6 +3,7 @@
 #include "Compressor.h"
 #include "Replicator.h"
 #include "util/Quaternion.h"
+#include "util/VarInt.h"
 
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/stream.hpp>
@@ -23,6 +24,20 @@ enum
 static const float translationMin[] = { -1024, -512, -1024 };
 static const float translationMax[] = { 1024, 512, 1024 };
 
+// Delta translations are sent in 1/128 stud steps, zig-zag encoded so small moves either way take few bits
+static const float deltaTranslationScale = 128.0f;
+static const float deltaTranslationMax = (float)(1 << 20) / deltaTranslationScale;
+
+static unsigned int zigZagEncode(int value)
+{
+	return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int zigZagDecode(unsigned int value)
+{
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
 void Compressor::writeRotation(RakNet::BitStream& bitStream, const Matrix3& rotation, CompressionType compressionType)
 {
 	writeCompressionType(bitStream, compressionType);
@@ -104,6 +119,50 @@ void Compressor::writeTranslation(RakNet::BitStream& bitStream, const Vector3& t
 	}
 }
 
+Vector3 Compressor::decodedTranslation(const Vector3& translation, CompressionType compressionType)
+{
+	RakNet::BitStream bitStream;
+	writeTranslation(bitStream, translation, compressionType);
+
+	Vector3 result;
+	readTranslation(bitStream, result);
+	return result;
+}
+
+bool Compressor::canDeltaCompressTranslation(const Vector3& translation, const Vector3& reference)
+{
+	const Vector3 delta = translation - reference;
+	return	fabs(delta.x) < deltaTranslationMax &&
+			fabs(delta.y) < deltaTranslationMax &&
+			fabs(delta.z) < deltaTranslationMax;
+}
+
+Vector3 Compressor::writeTranslationDelta(RakNet::BitStream& bitStream, const Vector3& translation, const Vector3& reference)
+{
+	RBXASSERT(canDeltaCompressTranslation(translation, reference));
+
+	Vector3 decoded;
+	for (int i = 0; i < 3; ++i)
+	{
+		int steps = G3D::iRound((translation[i] - reference[i]) * deltaTranslationScale);
+		VarInt<>::encode(bitStream, zigZagEncode(steps));
+
+		// same arithmetic as readTranslationDelta so both ends agree on the value
+		decoded[i] = reference[i] + (float)steps / deltaTranslationScale;
+	}
+	return decoded;
+}
+
+void Compressor::readTranslationDelta(RakNet::BitStream& bitStream, const Vector3& reference, Vector3& translation)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		unsigned int steps;
+		VarInt<>::decode(bitStream, &steps);
+		translation[i] = reference[i] + (float)zigZagDecode(steps) / deltaTranslationScale;
+	}
+}
+
 bool Compressor::canHeavilyCompressTranslation(const Vector3& translation)
 {
 	return !(	translation.x>translationMax[0] || translation.x<translationMin[0] ||
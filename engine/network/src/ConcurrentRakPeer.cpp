@@ -4,8 +4,13 @@
 #include "RakNetStatistics.h"
 #include "NetworkSettings.h"
 #include "util/SystemAddress.h"
+#include "BitStream.h"
+#include "boost/bind.hpp"
+#include "boost/enable_shared_from_this.hpp"
 
 LOGGROUP(NetworkStatsReport)
+DYNAMIC_FASTFLAGVARIABLE(ConcurrentRakPeerPoolBitStreams, false)
+DYNAMIC_FASTINTVARIABLE(ConcurrentRakPeerBitStreamPoolSize, 512)
 
 using namespace RBX;
 using namespace RBX::Network;
@@ -22,6 +27,7 @@ public:
 		char orderingChannel;
 		RakNet::SystemAddress systemAddress;
 		bool broadcast;
+		uint32_t forceReceiptNumber;
 	};
 	rbx::timestamped_safe_queue<SendData> sendQueue;
 	bool isQueueErrorComputed;
@@ -81,7 +87,7 @@ private:
 			SendData data;
 			while (sendQueue.pop_if_present(data))
 			{
-				bool result = safePeer->Send(data.bitStream.get(), data.priority, data.reliability, data.orderingChannel, data.systemAddress, data.broadcast) != 0;
+				bool result = safePeer->Send(data.bitStream.get(), data.priority, data.reliability, data.orderingChannel, data.systemAddress, data.broadcast, data.forceReceiptNumber) != 0;
 				RBXASSERT(result);
 			}
 			return TaskScheduler::Stepped;
@@ -91,6 +97,63 @@ private:
 };
 
 
+// Recycles the BitStreams of sent packets. Streams are taken on the replicators' job threads and returned
+// from PacketJob, so the free list is locked. A stream that grew past maxRetainedBytes (join data, big
+// remote event payloads) is freed rather than kept around for the small packets that make up most traffic.
+class ConcurrentRakPeer::BitStreamPool : public boost::enable_shared_from_this<BitStreamPool>
+{
+	static const unsigned int maxRetainedBytes = 64 * 1024;
+
+	boost::mutex mutex;
+	std::vector<RakNet::BitStream*> freeBitStreams;
+
+	static void release(const weak_ptr<BitStreamPool>& weakPool, RakNet::BitStream* bitStream)
+	{
+		if (shared_ptr<BitStreamPool> pool = weakPool.lock())
+		{
+			if (BITS_TO_BYTES(bitStream->GetNumberOfBitsAllocated()) <= maxRetainedBytes)
+			{
+				bitStream->Reset();
+
+				boost::mutex::scoped_lock lock(pool->mutex);
+				if (pool->freeBitStreams.size() < (size_t)DFInt::ConcurrentRakPeerBitStreamPoolSize)
+				{
+					pool->freeBitStreams.push_back(bitStream);
+					return;
+				}
+			}
+		}
+
+		delete bitStream;
+	}
+
+public:
+	~BitStreamPool()
+	{
+		for (size_t i = 0; i < freeBitStreams.size(); ++i)
+			delete freeBitStreams[i];
+	}
+
+	shared_ptr<RakNet::BitStream> allocate(unsigned int initialBytesToAllocate)
+	{
+		RakNet::BitStream* bitStream = NULL;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			if (!freeBitStreams.empty())
+			{
+				bitStream = freeBitStreams.back();
+				freeBitStreams.pop_back();
+			}
+		}
+
+		if (!bitStream)
+			bitStream = new RakNet::BitStream(initialBytesToAllocate);
+
+		return shared_ptr<RakNet::BitStream>(bitStream, boost::bind(&BitStreamPool::release, weak_ptr<BitStreamPool>(shared_from_this()), _1));
+	}
+};
+
+
 class ConcurrentRakPeer::StatsUpdateJob : public RBX::DataModelJob
 {
 private:
@@ -227,6 +290,7 @@ void ConcurrentRakPeer::removeStats(RakNet::SystemAddress address)
 
 ConcurrentRakPeer::ConcurrentRakPeer(RakNet::RakPeerInterface* peer, RBX::DataModel* dataModel)
 	:peer(shared_ptr<RakNet::RakPeerInterface>(peer))
+	,bitStreamPool(new BitStreamPool())
 	,dataModel(dataModel)
 {
 	packetJob.reset(new PacketJob(this->peer, dataModel));
@@ -242,13 +306,21 @@ ConcurrentRakPeer::~ConcurrentRakPeer()
 	RBX::TaskScheduler::singleton().remove(statsUpdateJob);
 }
 
-void ConcurrentRakPeer::Send(boost::shared_ptr<const RakNet::BitStream> bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, RakNet::SystemAddress systemAddress, bool broadcast )
+void ConcurrentRakPeer::Send(boost::shared_ptr<const RakNet::BitStream> bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, RakNet::SystemAddress systemAddress, bool broadcast, uint32_t forceReceiptNumber )
 {
-	PacketJob::SendData data = { bitStream, priority, reliability, orderingChannel, systemAddress, broadcast };
+	PacketJob::SendData data = { bitStream, priority, reliability, orderingChannel, systemAddress, broadcast, forceReceiptNumber };
 	packetJob->sendQueue.push(data);
 	TaskScheduler::singleton().reschedule(packetJob);
 }
 
+shared_ptr<RakNet::BitStream> ConcurrentRakPeer::allocateBitStream(unsigned int initialBytesToAllocate)
+{
+	if (DFFlag::ConcurrentRakPeerPoolBitStreams)
+		return bitStreamPool->allocate(initialBytesToAllocate);
+
+	return shared_ptr<RakNet::BitStream>(initialBytesToAllocate ? new RakNet::BitStream(initialBytesToAllocate) : new RakNet::BitStream());
+}
+
 double ConcurrentRakPeer::GetBufferHealth()
 {
 	boost::mutex::scoped_lock lock(statsUpdateJob->mapMutex);
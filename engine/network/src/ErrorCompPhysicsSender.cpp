@@ -152,7 +152,7 @@ int ErrorCompPhysicsSender::sendPacket(int maxPackets, PacketPriority packetPrio
 			if (packetCount>=maxPackets)
 				break;
 
-			bitStream.reset(new RakNet::BitStream(maxStreamSize));
+			bitStream = replicator.rakPeer->allocateBitStream(maxStreamSize);
 
 			++packetCount;
 
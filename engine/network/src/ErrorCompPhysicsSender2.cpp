@@ -222,7 +222,7 @@ int ErrorCompPhysicsSender2::sendPacket(int maxPackets, PacketPriority packetPri
 					break;
 				}
 
-				bitStream.reset(new RakNet::BitStream(maxStreamSize));
+				bitStream = replicator.rakPeer->allocateBitStream(maxStreamSize);
 
 				++packetCount;
 
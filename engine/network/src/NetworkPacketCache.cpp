@@ -5,7 +5,10 @@
 #include "v8world/World.h"
 #include "v8world/Assembly.h"
 
+#include "util/ContentId.h"
+#include "util/ProtectedString.h"
 #include "util/RobloxGoogleAnalytics.h"
+#include "util/SystemAddress.h"
 
 // raknet
 #include "BitStream.h"
@@ -17,6 +20,7 @@ DYNAMIC_FASTFLAGVARIABLE(DebugLogStaleInstanceCacheEntry, false)
 
 const char* const RBX::Network::sPhysicsPacketCache = "PhysicsPacketCache";
 const char* const RBX::Network::sInstancePacketCache = "InstancePacketCache";
+const char* const RBX::Network::sPropertyPacketCache = "PropertyPacketCache";
 
 using namespace RBX;
 using namespace RBX::Network;
@@ -212,6 +216,8 @@ void PhysicsPacketCache::addPart(PartInstance& part)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+rbx::atomic<int> InstancePacketCache::nextVersion;
+
 InstancePacketCache::InstancePacketCache()
 {
 	setName(sInstancePacketCache);
@@ -232,6 +238,7 @@ void InstancePacketCache::onServiceProvider(ServiceProvider* oldProvider, Servic
 		}
 
 		streamCache.clear();
+		joinDataChunks.clear();
 	}
 
 	Super::onServiceProvider(oldProvider, newProvider);
@@ -269,6 +276,7 @@ void InstancePacketCache::insert(const Instance* key)
 				RobloxGoogleAnalytics::trackEvent(GA_CATEGORY_ERROR, "InstanceCache stale entry", "insert");
 
 			result.first->second->dirty = true;
+			result.first->second->version = ++nextVersion;
 		}
 	}
 }
@@ -283,6 +291,8 @@ void InstancePacketCache::remove(const Instance* key)
 		iter->second->propChangedConnection.disconnect();
 		streamCache.erase(iter);
 	}
+
+	joinDataChunks.erase(key);
 }
 
 bool InstancePacketCache::fetchIfUpToDate(const Instance* key, RakNet::BitStream& outBitStream, bool isJoinData)
@@ -301,6 +311,7 @@ bool InstancePacketCache::fetchIfUpToDate(const Instance* key, RakNet::BitStream
 				RobloxGoogleAnalytics::trackEvent(GA_CATEGORY_ERROR, "InstanceCache stale entry", "fetch");
 
 			cachedItem->dirty = true;
+			cachedItem->version = ++nextVersion;
 		}
 
 		if (!cachedItem->bitStream[(int)isJoinData] || cachedItem->dirty)
@@ -343,3 +354,145 @@ bool InstancePacketCache::update(const Instance* key, RakNet::BitStream& bitStre
 	return false;
 }
 
+bool InstancePacketCache::getVersion(const Instance* key, int& version)
+{
+	boost::shared_lock<boost::shared_mutex> lock(sharedMutex);
+
+	StreamCacheMap::iterator iter = streamCache.find(key);
+	if (iter == streamCache.end())
+		return false;
+
+	version = iter->second->version;
+	return true;
+}
+
+boost::shared_ptr<const InstancePacketCache::JoinDataChunk> InstancePacketCache::fetchJoinDataChunkIfUpToDate(const Instance* key)
+{
+	boost::shared_lock<boost::shared_mutex> lock(sharedMutex);
+
+	JoinDataChunkMap::iterator chunkIter = joinDataChunks.find(key);
+	if (chunkIter == joinDataChunks.end())
+		return boost::shared_ptr<const JoinDataChunk>();
+
+	const JoinDataChunk* chunk = chunkIter->second.get();
+	for (size_t i = 0; i < chunk->entries.size(); ++i)
+	{
+		StreamCacheMap::iterator iter = streamCache.find(chunk->entries[i].instance);
+		if (iter == streamCache.end() || iter->second->dirty || iter->second->version != chunk->entries[i].version)
+			return boost::shared_ptr<const JoinDataChunk>();
+	}
+
+	return chunkIter->second;
+}
+
+void InstancePacketCache::updateJoinDataChunk(boost::shared_ptr<const JoinDataChunk> chunk)
+{
+	RBXASSERT(!chunk->entries.empty());
+
+	boost::unique_lock<boost::shared_mutex> lock(sharedMutex);
+	joinDataChunks[chunk->entries.front().instance] = chunk;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+PropertyPacketCache::PropertyPacketCache()
+{
+	setName(sPropertyPacketCache);
+}
+
+PropertyPacketCache::~PropertyPacketCache()
+{
+}
+
+void PropertyPacketCache::onServiceProvider(ServiceProvider* oldProvider, ServiceProvider* newProvider)
+{
+	if (oldProvider)
+	{
+		boost::unique_lock<boost::shared_mutex> lock(sharedMutex);
+		streamCache.clear();
+	}
+
+	Super::onServiceProvider(oldProvider, newProvider);
+}
+
+bool PropertyPacketCache::canCache(const Reflection::PropertyDescriptor& desc)
+{
+	// These are the types Replicator::serializePropertyValue sends through dictionaries (or per-client enum tables),
+	// so their bits depend on what the receiving replicator has seen before
+	return !(desc.type == Reflection::Type::singleton<ProtectedString>() ||
+		desc.type == Reflection::Type::singleton<std::string>() ||
+		desc.type == Reflection::Type::singleton<ContentId>() ||
+		desc.type == Reflection::Type::singleton<SystemAddress>() ||
+		desc.bIsEnum ||
+		Reflection::RefPropertyDescriptor::isRefPropertyDescriptor(desc));
+}
+
+bool PropertyPacketCache::fetchIfUpToDate(const Instance* key, const Reflection::PropertyDescriptor& desc, RakNet::BitStream& outBitStream)
+{
+	boost::shared_lock<boost::shared_mutex> lock(sharedMutex);
+
+	StreamCacheMap::iterator iter = streamCache.find(key);
+
+	if (iter == streamCache.end() || iter->second.instance.lock().get() != key)
+		return false;
+
+	CachedInstance::PropertyMap::iterator propIter = iter->second.properties.find(&desc);
+
+	if (propIter == iter->second.properties.end())
+		return false;
+
+	outBitStream.WriteBits(propIter->second->GetData(), propIter->second->GetNumberOfBitsUsed(), false);
+	return true;
+}
+
+void PropertyPacketCache::update(const Instance* key, const Reflection::PropertyDescriptor& desc, RakNet::BitStream& bitStream, unsigned int startBitPos, unsigned int numBits)
+{
+	RBXASSERT(canCache(desc));
+
+	boost::unique_lock<boost::shared_mutex> lock(sharedMutex);
+
+	StreamCacheMap::iterator iter = streamCache.find(key);
+
+	if (iter != streamCache.end() && iter->second.instance.lock().get() != key)
+	{
+		// address was reused by a new instance
+		streamCache.erase(iter);
+		iter = streamCache.end();
+	}
+
+	if (iter == streamCache.end())
+		iter = streamCache.insert(std::make_pair(key, CachedInstance(shared_from(key)))).first;
+
+	boost::shared_ptr<RakNet::BitStream>& cached = iter->second.properties[&desc];
+
+	if (!cached)
+		cached.reset(new RakNet::BitStream());
+
+	cached->Reset();
+
+	unsigned int readOffset = bitStream.GetReadOffset();
+	bitStream.SetReadOffset(startBitPos);
+	cached->Write(bitStream, numBits);
+	bitStream.SetReadOffset(readOffset);
+}
+
+void PropertyPacketCache::invalidate(const Instance* key, const Reflection::PropertyDescriptor& desc)
+{
+	boost::upgrade_lock<boost::shared_mutex> lock(sharedMutex);
+
+	StreamCacheMap::iterator iter = streamCache.find(key);
+
+	if (iter != streamCache.end())
+	{
+		boost::upgrade_to_unique_lock<boost::shared_mutex> uniqueLock(lock);
+		iter->second.properties.erase(&desc);
+	}
+}
+
+void PropertyPacketCache::remove(const Instance* key)
+{
+	boost::unique_lock<boost::shared_mutex> lock(sharedMutex);
+
+	streamCache.erase(key);
+}
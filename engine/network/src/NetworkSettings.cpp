@@ -62,6 +62,7 @@ namespace RBX
 	static Reflection::PropDescriptor<NetworkSettings, std::string> prop_ReportStatUrl("ReportStatURL", "Network", &NetworkSettings::getReportStatURL, &NetworkSettings::setReportStatURL, Reflection::PropertyDescriptor::Attributes::deprecated(Reflection::PropertyDescriptor::HIDDEN_SCRIPTING));
 	static Reflection::BoundProp<bool> prop_UsePhysicsPacketCache("UsePhysicsPacketCache", "Network", &NetworkSettings::usePhysicsPacketCache);
 	static Reflection::BoundProp<bool> prop_UseInstancePacketCache("UseInstancePacketCache", "Network", &NetworkSettings::useInstancePacketCache);
+	static Reflection::BoundProp<bool> prop_UsePropertyPacketCache("UsePropertyPacketCache", "Network", &NetworkSettings::usePropertyPacketCache);
 	static Reflection::BoundProp<bool> propIsQueueErrorComputed("IsQueueErrorComputed", "Network", &NetworkSettings::isQueueErrorComputed);
 
 	static Reflection::BoundProp<bool> prop_TrackDataTypes("TrackDataTypes", "Diagnostics", &NetworkSettings::trackDataTypes);
@@ -136,6 +137,7 @@ namespace RBX
 		,isQueueErrorComputed(true)
 		,usePhysicsPacketCache(false)
 		,useInstancePacketCache(false)
+		,usePropertyPacketCache(false)
 		,canSendPacketBufferLimit(1)
 		,sendPacketBufferLimit(-1)  // default is to not check it
 		,physicsMtuAdjust(-200)
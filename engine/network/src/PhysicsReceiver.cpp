@@ -37,6 +37,7 @@ using namespace RBX::Network;
 DYNAMIC_FASTFLAG(HumanoidFloorPVUpdateSignal)
 DYNAMIC_FASTINTVARIABLE(DebugMovementPathNumTotalWayPoint, 1000)
 DYNAMIC_FASTFLAG(SimpleHermiteSplineInterpolate)
+SYNCHRONIZED_FASTFLAG(PhysicsSenderDeltaTranslation)
 
 namespace RBX { namespace Network {
 	namespace PathBasedMovementDebug
@@ -65,7 +66,7 @@ void DeserializedTouchItem::process(Replicator& replicator)
 }
 
 PhysicsReceiver::PhysicsReceiver(Replicator* replicator, bool isServer)
-: replicator(replicator), iAmServer(isServer), stats(NULL), movementWaypointList(DFInt::DebugMovementPathNumTotalWayPoint)
+: replicator(replicator), iAmServer(isServer), stats(NULL), movementWaypointList(DFInt::DebugMovementPathNumTotalWayPoint), translationKeyframesPruneSize(256)
 {
 	setTime(Time::nowFast());
 }
@@ -198,7 +199,32 @@ void PhysicsReceiver::readMovementHistory(RakNet::BitStream& bitStream, RemoteTi
         CoordinateFrame cf;
         bool crossPacketCompression;
         bitStream >> crossPacketCompression;
-        readAssembly(bitStream, rootPart, mechanismItem, crossPacketCompression);
+
+        if (SFFlag::getPhysicsSenderDeltaTranslation() && !crossPacketCompression)
+        {
+            unsigned char generation;
+            bool deltaTranslation;
+            Vector3 translation;
+            bool hasTranslation = readTranslationKeyframe(bitStream, rootPart, generation, deltaTranslation, translation);
+
+            readAssembly(bitStream, rootPart, mechanismItem, false, deltaTranslation);
+
+            AssemblyItem& assemblyItem = mechanismItem.getAssemblyItem(mechanismItem.numAssemblies()-1);
+            if (deltaTranslation)
+            {
+                // Without the reference the best we can do is hold the part where it is, the server falls back to a full translation on loss
+                assemblyItem.pv.position.translation = hasTranslation ? translation : (rootPart ? rootPart->getCoordinateFrame().translation : Vector3());
+            }
+            if (rootPart && hasTranslation)
+            {
+                storeTranslationKeyframe(rootPart, generation, assemblyItem.pv.position.translation, deltaTranslation);
+            }
+        }
+        else
+        {
+            readAssembly(bitStream, rootPart, mechanismItem, crossPacketCompression);
+        }
+
         if (rootPart)
         {
             if (crossPacketCompression)
@@ -348,13 +374,107 @@ void PhysicsReceiver::readMechanismAttributes(RakNet::BitStream& bitStream, Mech
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void PhysicsReceiver::readAssembly(RakNet::BitStream& bitstream, PartInstance* rootPart, MechanismItem& mechanismItem, bool crossPacketCompression)
+bool PhysicsReceiver::readTranslationKeyframe(RakNet::BitStream& bitStream, PartInstance* rootPart, unsigned char& generation, bool& deltaTranslation, Vector3& translation)
+{
+    NETPROFILE_START("readTranslationKeyframe", &bitStream);
+    int bitStart = bitStream.GetReadOffset();
+
+    bitStream >> generation;
+    bitStream >> deltaTranslation;
+
+    // a full translation is read with the rest of the PV
+    bool hasTranslation = true;
+    if (deltaTranslation)
+    {
+        unsigned char referenceGeneration;
+        bitStream >> referenceGeneration;
+
+        hasTranslation = false;
+        Vector3 reference;
+        if (rootPart)
+        {
+            const TranslationKeyframes::Keyframe& keyframe = getTranslationKeyframes(rootPart).keyframes[referenceGeneration % Compressor::deltaTranslationHistorySize];
+            if (keyframe.valid && keyframe.generation == referenceGeneration)
+            {
+                reference = keyframe.translation;
+                hasTranslation = true;
+            }
+            else if (replicator->settings().printPhysicsErrors)
+            {
+                RBX::StandardOut::singleton()->printf(RBX::MESSAGE_INFO, "Physics-in missing translation generation %d", referenceGeneration);
+            }
+        }
+
+        Compressor::readTranslationDelta(bitStream, reference, translation);
+
+        if (stats)
+        {
+            stats->details.translation.increment();
+            stats->details.translationSize.sample((bitStream.GetReadOffset() - bitStart)/8);
+        }
+    }
+
+    NETPROFILE_END("readTranslationKeyframe", &bitStream);
+    return hasTranslation;
+}
+
+PhysicsReceiver::TranslationKeyframes::TranslationKeyframes()
+: newestGeneration(0)
+{
+    for (int i = 0; i < Compressor::deltaTranslationHistorySize; ++i)
+        keyframes[i].valid = false;
+}
+
+PhysicsReceiver::TranslationKeyframes& PhysicsReceiver::getTranslationKeyframes(PartInstance* part)
+{
+    TranslationKeyframes& result = translationKeyframes[part];
+
+    // A part that went away may have left its keyframes behind at the same address
+    if (result.part.expired())
+    {
+        result = TranslationKeyframes();
+        result.part = shared_from(part);
+    }
+
+    return result;
+}
+
+void PhysicsReceiver::storeTranslationKeyframe(PartInstance* part, unsigned char generation, const Vector3& translation, bool isDelta)
+{
+    TranslationKeyframes& keyframes = getTranslationKeyframes(part);
+
+    // Deltas can arrive out of order, don't let an old one evict a newer keyframe. A full translation always
+    // goes in, it may start a new sequence after the server dropped and re-added the part.
+    if (isDelta && (signed char)(generation - keyframes.newestGeneration) <= 0)
+        return;
+
+    TranslationKeyframes::Keyframe& keyframe = keyframes.keyframes[generation % Compressor::deltaTranslationHistorySize];
+    keyframe.translation = translation;
+    keyframe.generation = generation;
+    keyframe.valid = true;
+    keyframes.newestGeneration = generation;
+
+    if (translationKeyframes.size() > translationKeyframesPruneSize)
+    {
+        for (TranslationKeyframeMap::iterator iter = translationKeyframes.begin(); iter != translationKeyframes.end(); )
+        {
+            if (iter->second.part.expired())
+                iter = translationKeyframes.erase(iter);
+            else
+                ++iter;
+        }
+
+        translationKeyframesPruneSize = std::max<size_t>(256, translationKeyframes.size() * 2);
+    }
+}
+
+void PhysicsReceiver::readAssembly(RakNet::BitStream& bitstream, PartInstance* rootPart, MechanismItem& mechanismItem, bool crossPacketCompression, bool deltaTranslation)
 {
 	NETPROFILE_START("readAssembly", &bitstream);
 	AssemblyItem& assemblyItem = mechanismItem.appendAssembly();
 	assemblyItem.rootPart = shared_from<PartInstance>(rootPart);
 
-    readPV(bitstream, assemblyItem, crossPacketCompression);
+    readPV(bitstream, assemblyItem, crossPacketCompression, deltaTranslation);
     if (crossPacketCompression && rootPart)
     {
         // reuse the last translation (for now)
@@ -465,7 +585,7 @@ void PhysicsReceiver::processTouchPair(const TouchPair& tp)
 	physicsService->onTouchStep(tp);
 }
 
-void PhysicsReceiver::readPV(RakNet::BitStream& bitStream, AssemblyItem& item, bool crossPacketCompression)
+void PhysicsReceiver::readPV(RakNet::BitStream& bitStream, AssemblyItem& item, bool crossPacketCompression, bool deltaTranslation)
 {
     NETPROFILE_START("readPV", &bitStream);
     if (crossPacketCompression)
@@ -473,6 +593,12 @@ void PhysicsReceiver::readPV(RakNet::BitStream& bitStream, AssemblyItem& item, b
         // readRotation only
         Compressor::readRotation(bitStream, item.pv.position.rotation);
     }
+    else if (deltaTranslation)
+    {
+        // the translation came ahead of the PV
+        Compressor::readRotation(bitStream, item.pv.position.rotation);
+        readVelocity(bitStream, item.pv.velocity);
+    }
     else
     {
         readCoordinateFrame(bitStream, item.pv.position);
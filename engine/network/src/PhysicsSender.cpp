@@ -89,6 +89,10 @@ private:
 			}
 		}
 		
+		// Drop steps on connections that can't keep up with the full physics rate
+		if (replicator && !replicator->consumePhysicsSendCredit())
+			return TaskScheduler::Stepped;
+
 		if(shared_ptr<PhysicsSender> safePhysicsSender = physicsSender.lock())
 		{
 			safePhysicsSender->step();
@@ -233,7 +237,7 @@ void PhysicsSender::sendTouches(PacketPriority packetPriority)
 
 	while (!touchPairs.empty() && (numPackets > 0))
 	{
-		boost::shared_ptr<RakNet::BitStream> bitStream(new RakNet::BitStream(maxStreamSize));
+		boost::shared_ptr<RakNet::BitStream> bitStream = replicator.rakPeer->allocateBitStream(maxStreamSize);
 
 		*bitStream << (unsigned char) ID_PHYSICS_TOUCHES;
 
@@ -38,6 +38,9 @@ Replicator::DeleteInstanceItem::DeleteInstanceItem(Replicator* replicator, const
 	// remove entry from instance cache
 	if (replicator->instancePacketCache)
 		replicator->instancePacketCache->remove(instance.get());
+
+	if (replicator->propertyPacketCache)
+		replicator->propertyPacketCache->remove(instance.get());
 }
 
 bool Replicator::DeleteInstanceItem::write(RakNet::BitStream& bitStream) {
@@ -51,6 +51,12 @@ bool Replicator::EventInvocationItem::write(RakNet::BitStream& bitStream)
     }
 
 	int byteStart = bitStream.GetNumberOfBytesUsed();
+
+	const int attributionScale = replicator.replicatorStats.beginSendAttribution();
+	Time attributionStart;
+	if (attributionScale)
+		attributionStart = Time::now<Time::Precise>();
+
 	writeItemType(bitStream, ItemTypeEventInvocation);
 
 	// Write the GUID
@@ -79,6 +85,10 @@ bool Replicator::EventInvocationItem::write(RakNet::BitStream& bitStream)
 		replicator.replicatorStats.samplePacketsSent(ReplicatorStats::PACKET_TYPE_Event, bitStream.GetNumberOfBytesUsed()-byteStart);
 	}
 
+	if (attributionScale)
+		replicator.replicatorStats.sampleSendAttribution(replicator.replicatorStats.eventSendAttribution, ReplicatorStats::eventAttributionKey(instance.get(), desc),
+			attributionScale, bitStream.GetNumberOfBytesUsed()-byteStart, (Time::now<Time::Precise>() - attributionStart).seconds());
+
 	return true;
 }
 
@@ -16,7 +16,7 @@ void Replicator::ItemSender::openPacket()
 {
 	if (!bitStream)
 	{
-		bitStream.reset(new RakNet::BitStream());
+		bitStream = rakPeer->allocateBitStream();
 		*bitStream << (unsigned char) ID_DATA;
 	}
 }
@@ -41,7 +41,7 @@ void Replicator::ItemSender::closePacket()
 
 Replicator::ItemSender::ItemSender(Replicator& replicator, ConcurrentRakPeer *rakPeer)
 	:replicator(replicator),rakPeer(rakPeer)
-	,maxStreamSize(replicator.getAdjustedMtuSize())		// guesstimate
+	,maxStreamSize(replicator.getDataPacketSize())		// guesstimate
 	,sentItems(false)
 	,packetPriority(replicator.settings().getDataSendPriority())
 {
@@ -2,6 +2,7 @@
 #include "Replicator.NewInstanceItem.h"
 
 SYNCHRONIZED_FASTFLAGVARIABLE(NetworkAlignJoinData, true) // 223
+DYNAMIC_FASTFLAGVARIABLE(JoinDataChunkCache, false)
 
 namespace RBX {
 namespace Network {
@@ -89,17 +90,68 @@ bool Replicator::JoinDataItem::writeInstance(const Instance* instance, RakNet::B
 }
 
 
+bool Replicator::JoinDataItem::canUseJoinDataChunks() const
+{
+	return DFFlag::JoinDataChunkCache && replicator.instancePacketCache && sendBytesPerStep > 0 && maxInstancesToWrite == 0 && !replicator.settings().printInstances;
+}
+
+size_t Replicator::JoinDataItem::writeCachedJoinDataChunk(RakNet::BitStream& bitStream)
+{
+	shared_ptr<const InstancePacketCache::JoinDataChunk> chunk = replicator.instancePacketCache->fetchJoinDataChunkIfUpToDate(instances.front().get());
+	if (!chunk || chunk->compressionLevel != DFInt::JoinDataCompressionLevel || chunk->entries.size() > instances.size())
+		return 0;
+
+	// The chunk has to be the next run of instances for this player too, with all of them still waiting to be sent
+	std::list<shared_ptr<const Instance> >::const_iterator iter = instances.begin();
+	for (size_t i = 0; i < chunk->entries.size(); ++i, ++iter)
+	{
+		const Instance* instance = iter->get();
+		if (instance != chunk->entries[i].instance || !canUseCache(instance) || replicator.isClassRemoved(instance) || !replicator.isSerializePending(instance))
+			return 0;
+	}
+
+	for (size_t i = 0; i < chunk->entries.size(); ++i)
+	{
+		replicator.removeFromPendingNewInstances(instances.front().get());
+		instances.pop_front();
+	}
+
+	const unsigned int numWritten = chunk->entries.size();
+
+	bitStream.AlignWriteToByteBoundary();
+	bitStream << numWritten;
+	bitStream.WriteBits(chunk->compressedData->GetData(), chunk->compressedData->GetNumberOfBitsUsed(), false);
+
+	instancesWrittenOverLifetime += numWritten;
+	FASTLOG2(DFLog::NetworkJoin, "JoinDataItem(0x%p) Wrote a cached chunk of %u instances", this, numWritten);
+
+	return numWritten;
+}
+
 size_t Replicator::JoinDataItem::writeInstances(RakNet::BitStream& bitStream)
 {
+	const bool useJoinDataChunks = canUseJoinDataChunks();
+	if (useJoinDataChunks)
+	{
+		if (size_t numWritten = writeCachedJoinDataChunk(bitStream))
+			return numWritten;
+	}
+
 	// preallocate memory for bitstream using estimated size
 	RakNet::BitStream dataBitstream(instances.size() * 256);
 
+	// Build a chunk for the players joining after this one, as long as every instance in it comes from the cache
+	shared_ptr<InstancePacketCache::JoinDataChunk> chunk;
+	if (useJoinDataChunks)
+		chunk.reset(new InstancePacketCache::JoinDataChunk());
+
 	unsigned int numWritten = 0;
 	while (!instances.empty() && (0 == maxInstancesToWrite || numWritten < maxInstancesToWrite))
 	{
 		const Instance* instance = instances.front().get();
 		if (!replicator.removeFromPendingNewInstances(instance))
 		{
+			chunk.reset();
 			instances.pop_front();
 			continue;
 		}
@@ -107,6 +159,11 @@ size_t Replicator::JoinDataItem::writeInstances(RakNet::BitStream& bitStream)
 		bool instanceWritten;
 		if (replicator.instancePacketCache && canUseCache(instance))	// use cache
 		{
+			// Taken before the instance is written, so a change made while writing it invalidates the chunk
+			InstancePacketCache::JoinDataChunk::Entry entry = { instance, 0 };
+			if (chunk && !replicator.instancePacketCache->getVersion(instance, entry.version))
+				chunk.reset();
+
 			unsigned int startBit = dataBitstream.GetWriteOffset();
 
 			// try fetch from cache.
@@ -134,9 +191,18 @@ size_t Replicator::JoinDataItem::writeInstances(RakNet::BitStream& bitStream)
 					dataBitstream.GetWriteOffset() - startBit
 					);
 			}
+
+			if (chunk)
+			{
+				if (instanceWritten)
+					chunk->entries.push_back(entry);
+				else
+					chunk.reset();
+			}
 		}
 		else
         {
+			chunk.reset();
 			instanceWritten = writeInstance(instance, dataBitstream);
         }
 
@@ -168,7 +234,19 @@ size_t Replicator::JoinDataItem::writeInstances(RakNet::BitStream& bitStream)
 
 	// compress the data and write to bitstream
 	if (numWritten > 0)
-		Replicator::compressBitStream(dataBitstream, bitStream, DFInt::JoinDataCompressionLevel);
+	{
+		if (chunk)
+		{
+			chunk->compressionLevel = DFInt::JoinDataCompressionLevel;
+			chunk->compressedData.reset(new RakNet::BitStream());
+			Replicator::compressBitStream(dataBitstream, *chunk->compressedData, chunk->compressionLevel);
+			bitStream.WriteBits(chunk->compressedData->GetData(), chunk->compressedData->GetNumberOfBitsUsed(), false);
+
+			replicator.instancePacketCache->updateJoinDataChunk(chunk);
+		}
+		else
+			Replicator::compressBitStream(dataBitstream, bitStream, DFInt::JoinDataCompressionLevel);
+	}
 
 	instancesWrittenOverLifetime += numWritten;
 	FASTLOG2(DFLog::NetworkJoin, "JoinDataItem(0x%p) Finished writing %u instances", this, numWritten);
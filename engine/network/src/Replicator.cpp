@@ -96,6 +96,7 @@
 #include "GetTime.h"
 
 #include "util/ScopedAssign.h"
+#include "util/ThreadPool.h"
 #include "util/standardout.h"
 #include "util/Math.h"
 #include "util/RobloxGoogleAnalytics.h"
@@ -144,9 +145,14 @@ DYNAMIC_FASTINTVARIABLE(MaxClusterKBPerSecond, 40)
 DYNAMIC_FASTINT(RakNetMaxSplitPacketCount)
 
 DYNAMIC_FASTINTVARIABLE(MaxDataPacketPerSend, 1)
+DYNAMIC_FASTINTVARIABLE(SendRateControllerMinPacketPercent, 50)
 
 DYNAMIC_FASTINTVARIABLE(PacketErrorInfluxHundredthsPercentage, 10000)
 
+// 0 gives each replicator that deserializes off the DataModel thread its own thread
+DYNAMIC_FASTINTVARIABLE(DeserializePacketsPoolThreads, 0)
+DYNAMIC_FASTINTVARIABLE(DeserializePacketsPerTask, 16)
+
 DYNAMIC_FASTFLAGVARIABLE(WhiteListChatFilter, false)
 
 DYNAMIC_FASTFLAGVARIABLE(ReadDeSerializeProcessFlow, true)
@@ -366,6 +372,8 @@ Replicator::Replicator(
 	,remotePlayerId(remotePlayerId)
 	,clusterDebounceEnabled(clusterDebounceEnabled)
 	,removingInstance(NULL)
+	,dataSendCredit(0)
+	,physicsSendCredit(0)
 	,players(NULL)
 	,deserializingProperty(NULL)
 	,deserializingEventInvocation(NULL)
@@ -387,6 +395,9 @@ Replicator::Replicator(
 	,canTimeout(false)
 	,packetReceivedEvent(false)
 	,deserializePacketsThreadEnabled(false)
+	,deserializePacketsPooled(false)
+	,deserializePacketsTaskScheduled(false)
+	,deserializePacketsFailed(false)
 {
 	if (rakPeer)
 	{
@@ -411,13 +422,51 @@ std::string Replicator::getIpAddress() const
 	return RakNetAddressToString(remotePlayerId, false);
 }
 
+static ThreadPool* getDeserializePacketsPool()
+{
+	static boost::once_flag flag = BOOST_ONCE_INIT;
+	static ThreadPool* pool = NULL;
+
+	struct Create
+	{
+		static void run(ThreadPool** result)
+		{
+			// Replicators wait for their own task on shutdown, so the threads can be abandoned at exit
+			*result = new ThreadPool(DFInt::DeserializePacketsPoolThreads);
+		}
+	};
+
+	boost::call_once(flag, boost::bind(&Create::run, &pool));
+
+	return pool;
+}
+
 void Replicator::pushIncomingPacket(Packet* packet)
 {
-	if (deserializePacketsThread)
+	if (deserializePacketsPooled)
 	{
+		bool schedule = false;
 		{
 			boost::mutex::scoped_lock lock(receivedPacketsMutex);
 			receivedPackets.push_back(packet);
+			replicatorStats.deserializeQueueDepth.sample(receivedPackets.size());
+
+			if (!deserializePacketsTaskScheduled && deserializePacketsThreadEnabled && !deserializePacketsFailed)
+			{
+				deserializePacketsTaskScheduled = true;
+				schedule = true;
+			}
+		}
+
+		if (schedule)
+			getDeserializePacketsPool()->schedule(boost::bind(&Replicator::deserializePacketsTask, shared_from(this)));
+	}
+	else if (deserializePacketsThread)
+	{
+		{
+			boost::mutex::scoped_lock lock(receivedPacketsMutex);
+			receivedPackets.push_back(packet);
+			replicatorStats.deserializeQueueDepth.sample(receivedPackets.size() + packetsToDeserailze.size());
 		}
 		packetReceivedEvent.Set();
 	}
@@ -844,6 +893,20 @@ void Replicator::onServiceProvider(ServiceProvider* oldProvider, ServiceProvider
 		deserializePacketsThread.reset();
 	}
 
+	if (deserializePacketsPooled)
+	{
+		boost::mutex::scoped_lock lock(receivedPacketsMutex);
+
+		RBXASSERT(deserializePacketsThreadEnabled);
+		deserializePacketsThreadEnabled = false;
+
+		// the running task stops after its current packet
+		while (deserializePacketsTaskScheduled)
+			deserializePacketsTaskFinished.wait(lock);
+
+		deserializePacketsPooled = false;
+	}
+
 	while(!replicationContainers.empty())
 	{
 		ReplicationData item = replicationContainers.begin()->second;
@@ -858,6 +921,9 @@ void Replicator::onServiceProvider(ServiceProvider* oldProvider, ServiceProvider
 	if (instancePacketCache)
 		instancePacketCache.reset();
 
+	if (propertyPacketCache)
+		propertyPacketCache.reset();
+
 	if (clusterPacketCache)
 		clusterPacketCache.reset();
 
@@ -919,6 +985,7 @@ void Replicator::onServiceProvider(ServiceProvider* oldProvider, ServiceProvider
 		TaskScheduler::singleton().add(pingJob);
 
 		instancePacketCache = shared_from(ServiceProvider::find<InstancePacketCache>(newProvider));
+		propertyPacketCache = shared_from(ServiceProvider::find<PropertyPacketCache>(newProvider));
 		oneQuarterClusterPacketCache = shared_from(ServiceProvider::find<OneQuarterClusterPacketCache>(newProvider));
 		clusterPacketCache = shared_from(ServiceProvider::find<ClusterPacketCache>(newProvider));
 
@@ -1043,7 +1110,7 @@ void Replicator::createPhysicsSender(NetworkSettings::PhysicsSendMethod physicsS
 
 double Replicator::incomingPacketsCountHeadWaitTimeSec(const RBX::Time& timeNow)
 {
-	if (deserializePacketsThread)
+	if (isDeserializingPacketsOffThread())
 		return deserializedPackets.head_waittime_sec(timeNow);
 
 	return incomingPackets.head_waittime_sec(timeNow);
@@ -1051,7 +1118,7 @@ double Replicator::incomingPacketsCountHeadWaitTimeSec(const RBX::Time& timeNow)
 
 size_t Replicator::incomingPacketsCount() const
 {
-	if (deserializePacketsThread)
+	if (isDeserializingPacketsOffThread())
 		return deserializedPackets.size();
 
 	return incomingPackets.size();
@@ -2101,6 +2168,11 @@ void Replicator::writeChangedProperty(const Instance* instance, const Reflection
 
     int byteStart = outBitStream.GetNumberOfBytesUsed();
 
+	const int attributionScale = replicatorStats.beginSendAttribution();
+	Time attributionStart;
+	if (attributionScale)
+		attributionStart = Time::now<Time::Precise>();
+
 	Item::writeItemType(outBitStream, Item::ItemTypeChangeProperty);
 
 	// Write the GUID
@@ -2126,6 +2198,10 @@ void Replicator::writeChangedProperty(const Instance* instance, const Reflection
 		replicatorStats.incrementPacketsSent(desc.category.str);
 		replicatorStats.samplePacketsSent(desc.category.str, outBitStream.GetNumberOfBytesUsed()-byteStart);
 	}
+
+	if (attributionScale)
+		replicatorStats.sampleSendAttribution(replicatorStats.propertySendAttribution, ReplicatorStats::propertyAttributionKey(instance, desc),
+			attributionScale, outBitStream.GetNumberOfBytesUsed()-byteStart, (Time::now<Time::Precise>() - attributionStart).seconds());
 }
 
 void Replicator::writeChangedRefProperty(const Instance* instance,
@@ -2141,6 +2217,11 @@ void Replicator::writeChangedRefProperty(const Instance* instance,
 
     int byteStart = outBitStream.GetNumberOfBytesUsed();
 
+	const int attributionScale = replicatorStats.beginSendAttribution();
+	Time attributionStart;
+	if (attributionScale)
+		attributionStart = Time::now<Time::Precise>();
+
 	Item::writeItemType(outBitStream, Item::ItemTypeChangeProperty);
 
 	// Write the GUID
@@ -2173,6 +2254,10 @@ void Replicator::writeChangedRefProperty(const Instance* instance,
 		replicatorStats.incrementPacketsSent(desc.category.str);
 		replicatorStats.samplePacketsSent(desc.category.str, outBitStream.GetNumberOfBytesUsed()-byteStart);
 	}
+
+	if (attributionScale)
+		replicatorStats.sampleSendAttribution(replicatorStats.propertySendAttribution, ReplicatorStats::propertyAttributionKey(instance, desc),
+			attributionScale, outBitStream.GetNumberOfBytesUsed()-byteStart, (Time::now<Time::Precise>() - attributionStart).seconds());
 }
 
 bool Replicator::wantReplicate(const Instance* source) const
@@ -2298,6 +2383,13 @@ void Replicator::onStatisticsChanged(const ConnectionStats& newStats) {
 	replicatorStats.kiloBytesReceivedPerSecond = newStats.kiloBytesReceivedPerSecond.value();
 	replicatorStats.kiloBytesSentPerSecond = newStats.kiloBytesSentPerSecond.value();
 	replicatorStats.bufferHealth = newStats.bufferHealth.value();
+
+	if (sendRateController)
+	{
+		sendRateController->update(newStats.bufferHealth.value(), newStats.rakStats.packetlossLastSecond,
+			newStats.averagePing, newStats.lowestPing, Time::nowFast());
+		replicatorStats.sendRateScale.sample(sendRateController->getScale());
+	}
 }
 
 Replicator::ReplicationData& Replicator::addReplicationData(shared_ptr<Instance> instance, bool listenToChanges, bool replicateChildren)
@@ -2484,6 +2576,11 @@ void Replicator::onCombinedSignal(ReplicationData* replicationData, Instance::Co
 	{
 		if(replicationData->listenToChanges){
 			const Instance::PropertyChangedSignalData* data = boost::polymorphic_downcast<const Instance::PropertyChangedSignalData*>(genericData);
+
+			// Invalidate before filtering: a change this replicator drops (e.g. bounce back) still changes what the others send
+			if (propertyPacketCache && PropertyPacketCache::canCache(*data->propertyDescriptor))
+				propertyPacketCache->invalidate(replicationData->instance.get(), *data->propertyDescriptor);
+
 			if (filterChangedProperty(replicationData->instance.get(), *data->propertyDescriptor) == Accept)
 				onPropertyChanged(replicationData->instance.get(), data->propertyDescriptor);
 		}
@@ -2677,7 +2774,7 @@ bool Replicator::processNextIncomingPacket()
 	const double wait = settings().incommingReplicationLag;
 	if (wait <= 0)
 	{
-		if (deserializePacketsThread)
+		if (isDeserializingPacketsOffThread())
 		{
 			if (!deserializedPackets.pop_if_present(deserializedPacket))
 				return false;
@@ -2692,7 +2789,7 @@ bool Replicator::processNextIncomingPacket()
 	}
 	else
 	{
-		if (deserializePacketsThread)
+		if (isDeserializingPacketsOffThread())
 		{
 			if (!deserializedPackets.pop_if_waited(Time::Interval(wait), deserializedPacket))
 				return false;
@@ -2713,7 +2810,7 @@ bool Replicator::processNextIncomingPacket()
 				physicsReceiver->setTime(Time::nowFast());
 			}
 
-			if (deserializePacketsThread)
+			if (isDeserializingPacketsOffThread())
 				processDeserializedPacket(deserializedPacket);
 			else
 				processPacket(packet);
@@ -2783,6 +2880,16 @@ bool Replicator::sendItemsPacket()
 		replicatorStats.dataPacketSendThrottle.sample(1.0f - count / limit);
 	}
 
+	// When the connection can't keep up, only a share of the packets may carry
+	// regular items. The rest are reserved for highPriorityPendingItems.
+	int normalCount = count;
+	if (sendRateController)
+	{
+		dataSendCredit = std::min<float>(dataSendCredit + count * sendRateController->getScale(), (float)count);
+		normalCount = (int)dataSendCredit;
+		dataSendCredit -= normalCount;
+	}
+
 	replicatorStats.dataNewItemsPerSec.increment(pendingItems.size() - numItemsLeftFromPrevStep);
 	int itemcounter = 0;
 	for (int i=0; i<count; ++i)
@@ -2790,7 +2897,8 @@ bool Replicator::sendItemsPacket()
 		ItemSender sender(*this, rakPeer.get());
 
 		itemcounter += sendItems(sender, highPriorityPendingItems);
-		itemcounter += sendItems(sender, pendingItems);
+		if (i < normalCount)
+			itemcounter += sendItems(sender, pendingItems);
 
 		if (!sender.sentItems)
 			return false;
@@ -4544,23 +4652,94 @@ void Replicator::enableDeserializePacketThread()
 {
 	boost::mutex::scoped_lock lock(receivedPacketsMutex);
 
+	RBXASSERT(!isDeserializingPacketsOffThread());
 	deserializePacketsThreadEnabled = true;
 
-	// start packet deserialize thread
-	deserializePacketsThread.reset(new boost::thread(RBX::thread_wrapper(boost::bind(&Replicator::deserializePacketsThreadImpl, shared_from(this)), "Deserialize Packets Thread")));
+	if (DFInt::DeserializePacketsPoolThreads > 0)
+		deserializePacketsPooled = true;
+	else // start packet deserialize thread
+		deserializePacketsThread.reset(new boost::thread(RBX::thread_wrapper(boost::bind(&Replicator::deserializePacketsThreadImpl, shared_from(this)), "Deserialize Packets Thread")));
 
 	// transfer packets to the list used in the deserialize thread
 	Packet* packet;
 	while (incomingPackets.pop_if_present(packet))
 		receivedPackets.push_back(packet);
+
+	if (deserializePacketsPooled && !receivedPackets.empty())
+	{
+		deserializePacketsTaskScheduled = true;
+		getDeserializePacketsPool()->schedule(boost::bind(&Replicator::deserializePacketsTask, shared_from(this)));
+	}
+}
+
+bool Replicator::deserializeReceivedPacket(Packet* receivedPacket)
+{
+	RBXPROFILER_SCOPE("Network", "deserializePacket");
+	RBXPROFILER_LABELF("Network", "ID %d (%d bytes)", receivedPacket->data[0], receivedPacket->length);
+
+	bool deserialized = false;
+	DeserializedPacket deserializedPacket(receivedPacket);
+
+	RakNet::BitStream inBitstream(receivedPacket->data, receivedPacket->length, false);
+	inBitstream.IgnoreBits(8); // Ignore the packet id
+
+	try
+	{
+		if (receivedPacket->data[0] == ID_DATA)
+		{
+			deserializeData(inBitstream, deserializedPacket.deserializedItems);
+			deserialized = true;
+		}
+		else if (receivedPacket->data[0] == ID_PHYSICS_TOUCHES)
+		{
+			if (physicsReceiver.get())
+			{
+				shared_ptr<DeserializedTouchItem> deserializedTouchItem(new DeserializedTouchItem());
+				physicsReceiver->deserializeTouches(inBitstream, receivedPacket->systemAddress, deserializedTouchItem->touchPairs);
+				deserializedPacket.deserializedItems.push_back(deserializedTouchItem);
+			}
+			deserialized = true;
+		}
+	}
+	catch(std::out_of_range& e) // Workaround for iPad, where exceptions can't be caught by ancestor class
+	{
+		logPacketError(deserializedPacket.rawPacket, "Stream", e.what());
+		rakPeer->DeallocatePacket(deserializedPacket.rawPacket);
+		requestDisconnectWithSignal(DisconnectReason_ReceivePacketError);
+		return false;
+	}
+	catch (RBX::network_stream_exception& e)
+	{
+		logPacketError(deserializedPacket.rawPacket, "Stream", e.what());
+		rakPeer->DeallocatePacket(deserializedPacket.rawPacket);
+		requestDisconnectWithSignal(DisconnectReason_ReceivePacketStreamError);
+		return false;
+	}
+	catch (RBX::base_exception& e)
+	{
+		logPacketError(deserializedPacket.rawPacket, "Other", e.what());
+		rakPeer->DeallocatePacket(deserializedPacket.rawPacket);
+		requestDisconnectWithSignal(DisconnectReason_ReceivePacketError);
+		return false;
+	}
+
+	// if we did not deserialize any data items, possibly due to outdated client, skip adding this packet to the deserialized list
+	// so the datamodel job (processDeserializedPacket) doesn't try to process the raw packet again
+	if (!deserialized || deserializedPacket.deserializedItems.size() != 0)
+	{
+		bool wasEmpty = deserializedPackets.empty();
+		deserializedPackets.push(deserializedPacket);
+		if (wasEmpty && processPacketsJob && !TaskScheduler::singleton().isCyclicExecutive())
+			TaskScheduler::singleton().reschedule(processPacketsJob);
+	}
+
+	return true;
 }
 
 void Replicator::deserializePacketsThreadImpl()
 {
     Profiler::onThreadCreate("DeserializePackets");
 
-	bool addToDeserializedPacketsList = true;
-	bool deserialized = false;
 	while (deserializePacketsThreadEnabled)
 	{
 		if (packetsToDeserailze.empty() && !receivedPackets.empty())
@@ -4574,77 +4753,53 @@ void Replicator::deserializePacketsThreadImpl()
 			Packet* receivedPacket = packetsToDeserailze.front();
 			packetsToDeserailze.pop_front();
 
-            RBXPROFILER_SCOPE("Network", "deserializePacket");
-            RBXPROFILER_LABELF("Network", "ID %d (%d bytes)", receivedPacket->data[0], receivedPacket->length);
+			if (!deserializeReceivedPacket(receivedPacket))
+				break;
+		}
+		else if (receivedPackets.empty())
+		{
+			// wait for signal from pushIncomingPacket
+			packetReceivedEvent.Wait();
+		}
+	}
 
-			addToDeserializedPacketsList = true;
-			deserialized = false;
-			DeserializedPacket deserializedPacket(receivedPacket);
+    Profiler::onThreadExit();
+}
 
-			RakNet::BitStream inBitstream(receivedPacket->data, receivedPacket->length, false);
-			inBitstream.IgnoreBits(8); // Ignore the packet id
+void Replicator::deserializePacketsTask()
+{
+	// Handle a bounded number of packets and requeue, so one busy connection can't hold a pool thread
+	// while the others wait
+	for (int i = 0; i < DFInt::DeserializePacketsPerTask; ++i)
+	{
+		Packet* receivedPacket;
+		{
+			boost::mutex::scoped_lock lock(receivedPacketsMutex);
 
-			try
-			{
-				if (receivedPacket->data[0] == ID_DATA)
-				{
-					deserializeData(inBitstream, deserializedPacket.deserializedItems);
-					deserialized = true;
-				}
-				else if (receivedPacket->data[0] == ID_PHYSICS_TOUCHES)
-				{
-					if (physicsReceiver.get())
-					{
-						shared_ptr<DeserializedTouchItem> deserializedTouchItem(new DeserializedTouchItem());
-						physicsReceiver->deserializeTouches(inBitstream, receivedPacket->systemAddress, deserializedTouchItem->touchPairs);
-						deserializedPacket.deserializedItems.push_back(deserializedTouchItem);
-					}
-					deserialized = true;
-				}
-			}
-			catch(std::out_of_range& e) // Workaround for iPad, where exceptions can't be caught by ancestor class
-			{
-				logPacketError(deserializedPacket.rawPacket, "Stream", e.what());
-				rakPeer->DeallocatePacket(deserializedPacket.rawPacket);
-				requestDisconnectWithSignal(DisconnectReason_ReceivePacketError);
-				break;
-			}
-			catch (RBX::network_stream_exception& e)
-			{
-				logPacketError(deserializedPacket.rawPacket, "Stream", e.what());
-				rakPeer->DeallocatePacket(deserializedPacket.rawPacket);
-				requestDisconnectWithSignal(DisconnectReason_ReceivePacketStreamError);
-				break;
-			}
-			catch (RBX::base_exception& e)
+			if (!deserializePacketsThreadEnabled || deserializePacketsFailed || receivedPackets.empty())
 			{
-				logPacketError(deserializedPacket.rawPacket, "Other", e.what());
-				rakPeer->DeallocatePacket(deserializedPacket.rawPacket);
-				requestDisconnectWithSignal(DisconnectReason_ReceivePacketError);
-				break;
+				deserializePacketsTaskScheduled = false;
+				deserializePacketsTaskFinished.notify_all();
+				return;
 			}
 
-			// if we did not deserialize any data items, possibly due to outdated client, skip adding this packet to the deserialized list
-			// so the datamodel job (processDeserializedPacket) doesn't try to process the raw packet again
-			if (deserialized && deserializedPacket.deserializedItems.size() == 0)
-				addToDeserializedPacketsList = false;
-
-			if (addToDeserializedPacketsList)
-			{
-				bool wasEmpty = deserializedPackets.empty();
-				deserializedPackets.push(deserializedPacket);
-                if (wasEmpty && processPacketsJob && !TaskScheduler::singleton().isCyclicExecutive())
-					TaskScheduler::singleton().reschedule(processPacketsJob);
-			}
+			receivedPacket = receivedPackets.front();
+			receivedPackets.pop_front();
 		}
-		else if (receivedPackets.empty())
+
+		if (!deserializeReceivedPacket(receivedPacket))
 		{
-			// wait for signal from pushIncomingPacket
-			packetReceivedEvent.Wait();
+			// same as the dedicated thread: stop deserializing for this connection, it is being disconnected.
+			// deserializePacketsThreadEnabled stays set, teardown still owns clearing it.
+			boost::mutex::scoped_lock lock(receivedPacketsMutex);
+			deserializePacketsFailed = true;
+			deserializePacketsTaskScheduled = false;
+			deserializePacketsTaskFinished.notify_all();
+			return;
 		}
 	}
 
-    Profiler::onThreadExit();
+	getDeserializePacketsPool()->schedule(boost::bind(&Replicator::deserializePacketsTask, shared_from(this)));
 }
 
 PluginReceiveResult Replicator::OnReceive(Packet *packet)
@@ -4766,6 +4921,17 @@ PluginReceiveResult Replicator::OnReceive(Packet *packet)
 					return RR_STOP_PROCESSING_AND_DEALLOCATE;
 				};
 
+			case ID_SND_RECEIPT_ACKED:
+			case ID_SND_RECEIPT_LOSS:
+				{
+					// Only physics packets are sent with a receipt, see TopNErrorsPhysicsSender
+					PhysicsSendReceipt receipt;
+					memcpy(&receipt.receipt, packet->data + sizeof(RakNet::MessageID), sizeof(uint32_t));
+					receipt.acked = packet->data[0] == ID_SND_RECEIPT_ACKED;
+					physicsSendReceipts.push(receipt);
+				}
+				return RR_STOP_PROCESSING_AND_DEALLOCATE;
+
 			case ID_REPORT_ABUSE:
 				switch (players->OnReceiveReportAbuse(findTargetPlayer(), this->rakPeer->rawPeer(), packet))
 				{
@@ -4895,6 +5061,31 @@ size_t Replicator::getAdjustedMtuSize() const
 		settings().getReplicationMtuAdjust());
 }
 
+size_t Replicator::getDataPacketSize() const
+{
+	size_t size = getAdjustedMtuSize();
+	if (sendRateController && sendRateController->isCongested())
+	{
+		// Smaller packets lose less per drop and let high priority items out sooner
+		const float scale = std::max(sendRateController->getScale(), DFInt::SendRateControllerMinPacketPercent / 100.0f);
+		size = std::min(size, (size_t)(size * scale));
+	}
+	return size;
+}
+
+bool Replicator::consumePhysicsSendCredit()
+{
+	if (!sendRateController)
+		return true;
+
+	physicsSendCredit = std::min(physicsSendCredit + sendRateController->getScale(), 1.0f);
+	if (physicsSendCredit < 1.0f)
+		return false;
+
+	physicsSendCredit -= 1.0f;
+	return true;
+}
+
 size_t Replicator::getPhysicsMtuSize() const {
 	RBXASSERT(settings().getPhysicsMtuAdjust() <= 0);
 	return std::max(0, replicatorStats.peerStats.mtuSize +
@@ -4946,6 +5137,18 @@ double Replicator::getMetricValue(const std::string& metric) const
 		FASTLOG1(FLog::NetworkStatsReport, "Reporting ACTUAL_BYTES_RECEIVED: %d", getRakNetStats()->runningTotal[ACTUAL_BYTES_RECEIVED]);
 		return getRakNetStats()->runningTotal[ACTUAL_BYTES_RECEIVED];
 	}
+	if (metric == "Total Bytes Sent")
+	{
+		return getRakNetStats()->runningTotal[ACTUAL_BYTES_SENT];
+	}
+	if (metric == "Network Send CPU")
+	{
+		return 100.0 * sendDataJob->averageDutyCycle();
+	}
+	if (metric == "Data Items Sent")
+	{
+		return replicatorStats.dataItemsSentPerSec.getCount();
+	}
 
 	return 0.0;
 }
@@ -1,10 +1,15 @@
 #include "ReplicatorStats.h"
 
 #include "v8tree/Property.h"
+#include "v8tree/Instance.h"
+#include "v8datamodel/Remote.h"
 
 //RakNet
 #include "GetTime.h"
 
+DYNAMIC_FASTINTVARIABLE(ReplicatorSendAttributionSampleInterval, 0)
+DYNAMIC_FASTINTVARIABLE(ReplicatorSendAttributionMaxEntries, 64)
+
 namespace RBX {
 namespace Network {
 
@@ -75,6 +80,7 @@ ReplicatorStats::ReplicatorStats() :
     ,kiloBytesReceivedPerSecond(lerp)
 	,kiloBytesSentPerSecond(lerp)
 	,bufferHealth(1.0)
+	,sendRateScale(lerp, 1.0)
     ,packetsReceived(lerp)
 	,dataPacketsReceived(lerp)
 	,physicsPacketsReceived(lerp)
@@ -85,6 +91,7 @@ ReplicatorStats::ReplicatorStats() :
 	,clusterPacketsSentSize(lerp)
     ,touchPacketsReceived(lerp)
     ,touchPacketsReceivedSize(lerp)
+    ,deserializeQueueDepth(lerp)
     ,numberOfUnsplitMessages(0)
     ,numberOfSplitMessages(0)
     ,dataPing(0.25)
@@ -98,6 +105,7 @@ ReplicatorStats::ReplicatorStats() :
     ,lastBitsReceived(0)
     ,lastItem(Item::ItemTypeEnd)
 	,lastPacketType(-1)
+	,sendAttributionCounter(0)
 	{}
 
 void ReplicatorStats::incrementPacketsSent(PacketType type) {
@@ -152,6 +160,47 @@ void ReplicatorStats::samplePacketsReceived(const std::string& categoryName, int
     }
 }
 
+std::string ReplicatorStats::propertyAttributionKey(const Instance* instance, const Reflection::PropertyDescriptor& desc) {
+	return instance->getClassName().toString() + "." + desc.name.toString();
+}
+
+std::string ReplicatorStats::eventAttributionKey(const Instance* instance, const Reflection::EventDescriptor& desc) {
+	// Every RemoteEvent shares the same descriptor, so tell them apart by where they live
+	if (Instance::fastDynamicCast<RemoteEvent>(instance) || Instance::fastDynamicCast<RemoteFunction>(instance))
+		return instance->getFullName();
+
+	return instance->getClassName().toString() + "." + desc.name.toString();
+}
+
+int ReplicatorStats::beginSendAttribution() {
+	const int interval = DFInt::ReplicatorSendAttributionSampleInterval;
+	if (interval <= 0)
+		return 0;
+
+	if (++sendAttributionCounter < (unsigned int)interval)
+		return 0;
+
+	sendAttributionCounter = 0;
+	return interval;
+}
+
+void ReplicatorStats::sampleSendAttribution(SendAttributionMap& map, const std::string& key, int scale, int bytes, double encodeSeconds) {
+	SendAttributionMap::iterator iter = map.find(key);
+	if (iter == map.end())
+	{
+		// Keep the breakdown bounded when a game creates remotes dynamically
+		if ((int)map.size() >= DFInt::ReplicatorSendAttributionMaxEntries)
+			iter = map.insert(std::make_pair(std::string("Other"), SendAttribution())).first;
+		else
+			iter = map.insert(std::make_pair(key, SendAttribution())).first;
+	}
+
+	SendAttribution& attribution = iter->second;
+	attribution.items.increment(scale);
+	attribution.bytes.increment(scale * bytes);
+	attribution.encodeSeconds.increment(scale * encodeSeconds);
+}
+
     void ReplicatorStats::resetSecurityTimes()
     {
         const RakNet::Time now = RakNet::GetTimeMS();
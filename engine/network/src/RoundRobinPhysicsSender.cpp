@@ -127,7 +127,7 @@ class RoundRobinPhysicsSender::JobSender : public boost::noncopyable
 
 	void openPacket()
 	{
-		bitStream.reset(new RakNet::BitStream(maxStreamSize));
+		bitStream = rakPeer->allocateBitStream(maxStreamSize);
 		*bitStream << (unsigned char) ID_TIMESTAMP;
 		RakNet::Time now = RakNet::GetTime();
 		*bitStream << now;
@@ -140,7 +140,7 @@ class RoundRobinPhysicsSender::JobSender : public boost::noncopyable
 
 	void openPacketPhysicsOffset(RakNet::Time& newTimeStamp)
 	{
-		bitStream.reset(new RakNet::BitStream(maxStreamSize));
+		bitStream = rakPeer->allocateBitStream(maxStreamSize);
 		*bitStream << (unsigned char) ID_TIMESTAMP;
 		RakNet::Time now = RakNet::GetTime();
 		*bitStream << now;
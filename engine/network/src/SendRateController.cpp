@@ -0,0 +1,52 @@
+#include "SendRateController.h"
+
+#include "rbx/Debug.h"
+#include "FastLog.h"
+
+#include <algorithm>
+
+DYNAMIC_FASTINTVARIABLE(SendRateControllerMinPercent, 10)
+DYNAMIC_FASTINTVARIABLE(SendRateControllerDecreasePercent, 50)
+DYNAMIC_FASTINTVARIABLE(SendRateControllerRecoveryPercentPerSec, 20)
+DYNAMIC_FASTINTVARIABLE(SendRateControllerBufferHealthPercent, 50)
+DYNAMIC_FASTINTVARIABLE(SendRateControllerPacketLossPercent, 5)
+DYNAMIC_FASTINTVARIABLE(SendRateControllerPingIncreaseMs, 250)
+
+namespace RBX { namespace Network {
+
+SendRateController::SendRateController()
+	: scale(1.0f)
+	, congested(false)
+{
+}
+
+void SendRateController::update(double bufferHealth, float packetLoss, int averagePing, int lowestPing, const Time& now)
+{
+	const double elapsed = lastUpdate.isZero() ? 0.0 : std::min(1.0, std::max(0.0, (now - lastUpdate).seconds()));
+	lastUpdate = now;
+
+	congested = bufferHealth < DFInt::SendRateControllerBufferHealthPercent / 100.0
+		|| packetLoss * 100.0f > DFInt::SendRateControllerPacketLossPercent
+		|| (lowestPing > 0 && averagePing - lowestPing > DFInt::SendRateControllerPingIncreaseMs);
+
+	const float minScale = std::min(1.0f, std::max(0.01f, DFInt::SendRateControllerMinPercent / 100.0f));
+
+	if (congested)
+	{
+		// Give the previous decrease a round trip to take effect before backing off again
+		const double backoffInterval = std::max(0.1, averagePing / 1000.0);
+		if (lastDecrease.isZero() || (now - lastDecrease).seconds() >= backoffInterval)
+		{
+			scale = std::max(minScale, scale * DFInt::SendRateControllerDecreasePercent / 100.0f);
+			lastDecrease = now;
+		}
+	}
+	else
+	{
+		scale = std::min(1.0f, scale + (float)elapsed * DFInt::SendRateControllerRecoveryPercentPerSec / 100.0f);
+	}
+
+	RBXASSERT(scale >= minScale && scale <= 1.0f);
+}
+
+}}
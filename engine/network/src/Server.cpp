@@ -441,6 +441,9 @@ void Server::onServiceProvider(ServiceProvider* oldProvider, ServiceProvider* ne
 		if (networkSettings->useInstancePacketCache)
 			instancePacketCache = ServiceProvider::create<InstancePacketCache>(newProvider);
 
+		if (networkSettings->usePropertyPacketCache)
+			ServiceProvider::create<PropertyPacketCache>(newProvider);
+
 		ServiceProvider::create<OneQuarterClusterPacketCache >(newProvider);
 		ServiceProvider::create<ClusterPacketCache>(newProvider);
 		
@@ -75,7 +75,9 @@ DYNAMIC_FASTFLAGVARIABLE(DebugLogProcessCharacterRequestTime, false)
 DYNAMIC_FASTFLAGVARIABLE(DisablePlaceAuthenticationPoll, false)
 DYNAMIC_FASTFLAGVARIABLE(FilterAllPlayerPropChanges, false)
 DYNAMIC_FASTFLAGVARIABLE(LogAllPlayerPropChanges, false)
+DYNAMIC_FASTFLAGVARIABLE(ServerReplicatorAdaptiveSendRate, false)
 DYNAMIC_FASTFLAGVARIABLE(TeamCreateAcceptTerrainReplicatedUpdatesWhenFilteringEnabled, true)
+DYNAMIC_FASTFLAGVARIABLE(ServerDeserializePacketsOffThread, false)
 
 DYNAMIC_FASTFLAG(LoadGuisWithoutChar)
 DYNAMIC_FASTFLAG(RCCSupportCloudEdit)
@@ -357,6 +359,9 @@ ServerReplicator::ServerReplicator(RakNet::SystemAddress systemAddress, Server*
 	outdoorAmbientDescriptor = lightingService ? lightingService->getDescriptor().findPropertyDescriptor("OutdoorAmbient") : NULL;
 	outlinesDescriptor = lightingService ? lightingService->getDescriptor().findPropertyDescriptor("Outlines") : NULL;
 
+	if (DFFlag::ServerReplicatorAdaptiveSendRate)
+		sendRateController.reset(new SendRateController());
+
 	canTimeout = false;
 }
 
@@ -1338,6 +1343,7 @@ void CheatHandlingServerReplicator::processTicket(Packet *packet)
             oneQuarterClusterPacketCache.reset();
 	    	clusterPacketCache.reset();
             instancePacketCache.reset();
+            propertyPacketCache.reset();
         }
 
 	    FASTLOG1(FLog::Network, "ServerReplicator:processTicket - remoteProtocolVersion = %i",remoteProtocolVersion);
@@ -2643,7 +2649,19 @@ void ServerReplicator::writeChangedProperty(const Instance* instance, const Refl
 	bool versionReset = propSync.onPropertySend(Reflection::ConstProperty(desc, instance)) == PropSync::Master::SendVersionReset;
 	outBitStream << versionReset;
 
-	serializePropertyValue(Reflection::ConstProperty(desc, instance), outBitStream, true/*useDictionary*/);
+	if (propertyPacketCache && PropertyPacketCache::canCache(desc))
+	{
+		if (!propertyPacketCache->fetchIfUpToDate(instance, desc, outBitStream))
+		{
+			unsigned int startBit = outBitStream.GetNumberOfBitsUsed();
+			serializePropertyValue(Reflection::ConstProperty(desc, instance), outBitStream, true/*useDictionary*/);
+			propertyPacketCache->update(instance, desc, outBitStream, startBit, outBitStream.GetNumberOfBitsUsed() - startBit);
+		}
+	}
+	else
+	{
+		serializePropertyValue(Reflection::ConstProperty(desc, instance), outBitStream, true/*useDictionary*/);
+	}
 
 	if (settings().printProperties) {
 		RBX::StandardOut::singleton()->printf(RBX::MESSAGE_SENSITIVE,
@@ -2779,6 +2797,11 @@ void ServerReplicator::onServiceProvider(ServiceProvider* oldProvider, ServicePr
 	// streamJob in the right order.
 	Super::onServiceProvider(oldProvider, newProvider);
 
+	// Server replicators have all their top containers from the start, so unlike the client
+	// there is nothing to wait for before deserializing off the DataModel thread
+	if (newProvider && DFFlag::ServerDeserializePacketsOffThread)
+		enableDeserializePacketThread();
+
 	joinAnalytics.addPoint("ReplicatorAdded", (Time::nowFast()-startTime).seconds());
 }
 
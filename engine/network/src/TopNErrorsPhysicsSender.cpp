@@ -45,13 +45,26 @@ DYNAMIC_FASTFLAGVARIABLE(PhysicsSenderUseOwnerTimestamp, false)
 DYNAMIC_FASTFLAGVARIABLE(PhysicsSenderCheckPartInServiceBeforeSend, false)
 DYNAMIC_FASTFLAGVARIABLE(DebugPhysicsSenderLogCacheMissToGA, false)
 
+// Interest management: mechanisms further than these distances (in studs) from the player's character are sent
+// at most once per interval, or not at all past the cull distance. A near distance of 0 turns it off; a cull distance of 0 never culls
+DYNAMIC_FASTINTVARIABLE(PhysicsSenderInterestNearDistance, 0)
+DYNAMIC_FASTINTVARIABLE(PhysicsSenderInterestFarDistance, 0)
+DYNAMIC_FASTINTVARIABLE(PhysicsSenderInterestCullDistance, 0)
+DYNAMIC_FASTINTVARIABLE(PhysicsSenderInterestNearIntervalMs, 100)
+DYNAMIC_FASTINTVARIABLE(PhysicsSenderInterestFarIntervalMs, 500)
+
 SYNCHRONIZED_FASTFLAG(PhysicsPacketSendWorldStepTimestamp)
 
+// Physics packets go out with a receipt, and root translations are sent as deltas against the newest one the client acked
+SYNCHRONIZED_FASTFLAGVARIABLE(PhysicsSenderDeltaTranslation, false)
+
 #define CROSS_PACKET_COMPRESSION_DISTANCE_SQ_THRESHOLD 2500.0f
 #define CROSS_PACKET_COMPRESSION_VELOCITY_THRESHOLD 15.0f
 
 TopNErrorsPhysicsSender::TopNErrorsPhysicsSender(Replicator& replicator)
 : PhysicsSender(replicator)
+, sendingNugget(NULL)
+, deltaTranslation(false)
 , stepId(0)
 , sendId(0)
 , sortId(0)
@@ -89,6 +102,8 @@ void TopNErrorsPhysicsSender::step()
 	std::for_each(newMovingAssemblies.begin(), newMovingAssemblies.end(), boost::bind(&TopNErrorsPhysicsSender::addNugget2, this, _1));
 	newMovingAssemblies.clear();
 
+	processSendReceipts();
+
 	// Prepare the data needed to compute errors
 	const ModelInstance* characterModel = NULL;
 	CoordinateFrame focus;
@@ -150,6 +165,8 @@ void TopNErrorsPhysicsSender::step()
 			}
 		}
 
+		nugget->outOfInterest = false;
+
 		if (replicator.checkDistributedSendFast(nugget->part.get()))
 			nugget->computeError(focus, characterModel, stepId, this);
 		else
@@ -195,11 +212,17 @@ int TopNErrorsPhysicsSender::sendPacket(int maxPackets, PacketPriority packetPri
 	while (iter != nuggetList.end())
 	{
 		Nugget* nugget = *iter;
+		if (nugget->outOfInterest)
+		{
+			++iter;
+			continue;
+		}
+
 		if (!bitStream) {
 			if (packetCount>=maxPackets)
 				break;
 
-			bitStream.reset(new RakNet::BitStream(maxStreamSize));
+			bitStream = replicator.rakPeer->allocateBitStream(maxStreamSize);
 
 			++packetCount;
 
@@ -302,38 +325,13 @@ int TopNErrorsPhysicsSender::sendPacket(int maxPackets, PacketPriority packetPri
 
 		if (bitStream->GetNumberOfBytesUsed() > static_cast<int>(maxStreamSize)) 
 		{
-			// Packet "end" tag
-			if (replicator.isStreamingEnabled())
-				*bitStream << true; // done
-			else
-				replicator.serializeId(*bitStream, NULL);
-
-			// Send ID_PHYSICS
-			replicator.rakPeer->Send(bitStream, packetPriority, UNRELIABLE, PHYSICS_CHANNEL, replicator.remotePlayerId, false);
-			stats->physicsPacketsSent.sample();
-			stats->physicsPacketsSentSmooth.sample();
-			stats->physicsPacketsSentSize.sample(bitStream->GetNumberOfBytesUsed());
-			stats->physicsItemsPerPacket.sample(sentItemCount);
-
+			sendBitStream(bitStream, packetPriority, stats, sentItemCount);
 			bitStream.reset();
 		}
 	}
 
 	if (bitStream)
-	{
-		// Packet "end" tag
-		if (replicator.isStreamingEnabled())
-			*bitStream << true; // done
-		else
-			replicator.serializeId(*bitStream, NULL);
-
-		// Send ID_PHYSICS
-		replicator.rakPeer->Send(bitStream, packetPriority, UNRELIABLE, PHYSICS_CHANNEL, replicator.remotePlayerId, false);
-		stats->physicsPacketsSent.sample();
-		stats->physicsPacketsSentSmooth.sample();
-		stats->physicsPacketsSentSize.sample(bitStream->GetNumberOfBytesUsed());
-		stats->physicsItemsPerPacket.sample(sentItemCount);
-	}
+		sendBitStream(bitStream, packetPriority, stats, sentItemCount);
 
 	sendId = stepId;
 
@@ -343,6 +341,64 @@ int TopNErrorsPhysicsSender::sendPacket(int maxPackets, PacketPriority packetPri
 };
 
 
+void TopNErrorsPhysicsSender::sendBitStream(const boost::shared_ptr<RakNet::BitStream>& bitStream, PacketPriority packetPriority, ReplicatorStats::PhysicsSenderStats* stats, int sentItemCount)
+{
+	// Packet "end" tag
+	if (replicator.isStreamingEnabled())
+		*bitStream << true; // done
+	else
+		replicator.serializeId(*bitStream, NULL);
+
+	// Send ID_PHYSICS
+	if (SFFlag::getPhysicsSenderDeltaTranslation())
+	{
+		uint32_t receipt = replicator.rakPeer->rawPeer()->IncrementNextSendReceipt();
+		replicator.rakPeer->Send(bitStream, packetPriority, UNRELIABLE_WITH_ACK_RECEIPT, PHYSICS_CHANNEL, replicator.remotePlayerId, false, receipt);
+
+		if (!packetTranslations.empty())
+		{
+			sentPackets.push_back(SentPacket());
+			sentPackets.back().receipt = receipt;
+			sentPackets.back().translations.swap(packetTranslations);
+
+			// RakNet reports every receipt, this only guards against a connection that stopped reporting
+			if (sentPackets.size() > 256)
+				sentPackets.pop_front();
+		}
+	}
+	else
+		replicator.rakPeer->Send(bitStream, packetPriority, UNRELIABLE, PHYSICS_CHANNEL, replicator.remotePlayerId, false);
+
+	stats->physicsPacketsSent.sample();
+	stats->physicsPacketsSentSmooth.sample();
+	stats->physicsPacketsSentSize.sample(bitStream->GetNumberOfBytesUsed());
+	stats->physicsItemsPerPacket.sample(sentItemCount);
+}
+
+void TopNErrorsPhysicsSender::processSendReceipts()
+{
+	Replicator::PhysicsSendReceipt receipt;
+	while (replicator.physicsSendReceipts.pop_if_present(receipt))
+	{
+		// Receipts come back roughly in send order, so this is usually the front
+		std::deque<SentPacket>::iterator iter = sentPackets.begin();
+		while (iter != sentPackets.end() && iter->receipt != receipt.receipt)
+			++iter;
+
+		if (iter == sentPackets.end())
+			continue;
+
+		for (SentTranslations::const_iterator t = iter->translations.begin(); t != iter->translations.end(); ++t)
+		{
+			NuggetMap::iterator mapIter = nuggetMap.find(t->part);
+			if (mapIter != nuggetMap.end())
+				mapIter->second.onTranslationReceipt(t->generation, t->translation, t->delta, receipt.acked);
+		}
+
+		sentPackets.erase(iter);
+	}
+}
+
 void TopNErrorsPhysicsSender::onAddingAssembly(shared_ptr<Instance> assembly)
 {
 	shared_ptr<PartInstance> part = Instance::fastSharedDynamicCast<PartInstance>(assembly);
@@ -398,10 +454,59 @@ void TopNErrorsPhysicsSender::onRemovedAssembly(shared_ptr<Instance> assembly)
 }
 
 
-bool TopNErrorsPhysicsSender::sendPhysicsData(RakNet::BitStream& bitStream, const Nugget& nugget, CoordinateFrame& outLastSendCFrame, float& accumulatedError, const PartInstance* playerHead)
+bool TopNErrorsPhysicsSender::sendPhysicsData(RakNet::BitStream& bitStream, Nugget& nugget, CoordinateFrame& outLastSendCFrame, float& accumulatedError, const PartInstance* playerHead)
 {
 	sendDetailed = nugget.sendDetailed;
-	return PhysicsSender::sendPhysicsData(bitStream, nugget.part.get(), sendDetailed, nugget.lastSendTime, outLastSendCFrame, accumulatedError, playerHead);
+	sendingNugget = &nugget;
+
+	size_t numTranslations = packetTranslations.size();
+	bool result = PhysicsSender::sendPhysicsData(bitStream, nugget.part.get(), sendDetailed, nugget.lastSendTime, outLastSendCFrame, accumulatedError, playerHead);
+
+	sendingNugget = NULL;
+
+	if (packetTranslations.size() > numTranslations)
+	{
+		RBXASSERT(result);
+		nugget.nextGeneration++;
+	}
+
+	return result;
+}
+
+void TopNErrorsPhysicsSender::writeTranslationKeyframe(RakNet::BitStream& bitStream, const Vector3& translation, Compressor::CompressionType compressionType)
+{
+	RBXASSERT(sendingNugget);
+	const Nugget& nugget = *sendingNugget;
+
+	const unsigned char generation = nugget.nextGeneration;
+	bitStream << generation;
+
+	// The client only keeps the last few generations, and a streamed out part loses them
+	deltaTranslation = nugget.hasAckedTranslation
+		&& compressionType != Compressor::UNCOMPRESSED
+		&& !replicator.isStreamingEnabled()
+		&& (unsigned char)(generation - nugget.ackedGeneration) < Compressor::deltaTranslationHistorySize
+		&& Compressor::canDeltaCompressTranslation(translation, nugget.ackedTranslation);
+
+	SentTranslation sent;
+	sent.part = nugget.part;
+	sent.generation = generation;
+	sent.delta = deltaTranslation;
+
+	bitStream << deltaTranslation;
+	if (deltaTranslation)
+	{
+		bitStream << nugget.ackedGeneration;
+		sent.translation = Compressor::writeTranslationDelta(bitStream, translation, nugget.ackedTranslation);
+	}
+	else
+	{
+		// The full translation goes out with the PV. Keep what the client decodes rather than the exact value,
+		// later deltas have to be against the reference the client actually has.
+		sent.translation = Compressor::decodedTranslation(translation, compressionType);
+	}
+
+	packetTranslations.push_back(sent);
 }
 
 void TopNErrorsPhysicsSender::writeAssembly(RakNet::BitStream& bitStream, const Assembly* assembly, Compressor::CompressionType compressionType, bool crossPacketCompression)
@@ -413,6 +518,8 @@ void TopNErrorsPhysicsSender::writeAssembly(RakNet::BitStream& bitStream, const
 			index |= 1;
 		if (crossPacketCompression)
 			index |= 2;
+		if (deltaTranslation)
+			index |= 4;		// the translation went out separately, the rest is the same for every client
 
 		// look for this packet in the cache
 		if (!physicsPacketCache->fetchIfUpToDate(assembly, index, bitStream))
@@ -462,12 +569,41 @@ TopNErrorsPhysicsSender::Nugget::Nugget(shared_ptr<PartInstance> part)
 	, biggestSize(minSize())
 	, sendDetailed(true)
 	, notInService(false)
+	, outOfInterest(false)
 	, radius(0.0f)
     , lastSendTime(Time())
     , accumulatedError(0.f)
+	, ackedGeneration(0)
+	, hasAckedTranslation(false)
+	, nextGeneration(0)
 {
 }
 
+void TopNErrorsPhysicsSender::Nugget::onTranslationReceipt(unsigned char generation, const Vector3& translation, bool delta, bool acked)
+{
+	if (!acked)
+	{
+		// The client may be behind on this part; send the full translation until a new ack comes in
+		hasAckedTranslation = false;
+		return;
+	}
+
+	// An acked delta is not necessarily a keyframe: the client drops one whose reference it lacks, or that arrives
+	// after a newer one. Keep deltaing against the full translation, the history window then forces a new one.
+	if (delta)
+		return;
+
+	// Ignore acks older than the one we have, or for generations this nugget did not send
+	if (hasAckedTranslation && (signed char)(generation - ackedGeneration) <= 0)
+		return;
+	if ((unsigned char)(nextGeneration - generation) > Compressor::deltaTranslationHistorySize)
+		return;
+
+	ackedTranslation = translation;
+	ackedGeneration = generation;
+	hasAckedTranslation = true;
+}
+
 void TopNErrorsPhysicsSender::Nugget::onSent(const Time& t, const CoordinateFrame& cf, float err)			
 {
 	// part - no change
@@ -496,9 +632,10 @@ void TopNErrorsPhysicsSender::Nugget::computeError(const CoordinateFrame& focus,
 		
 	// current
 	float currentDistance = minDistance();			// There is no center of interest.  Location doesn't affect error
+	float squaredDistance = 0.0f;
 	if (focusModel)	{
-		currentDistance = (cf.translation - focus.translation).squaredMagnitude() - radius*radius;
-		currentDistance = G3D::clamp(currentDistance, minDistance(), maxDistance());
+		squaredDistance = (cf.translation - focus.translation).squaredMagnitude() - radius*radius;
+		currentDistance = G3D::clamp(squaredDistance, minDistance(), maxDistance());
 	}
 
 	// 2. Error
@@ -520,9 +657,37 @@ void TopNErrorsPhysicsSender::Nugget::computeError(const CoordinateFrame& focus,
 				sendDetailed = true;
 			}
 		}
+
+		// The clamp above only bounds the error divisor, interest tiers can be further out than maxDistance
+		if (focusModel && DFInt::PhysicsSenderInterestNearDistance > 0)
+			computeInterest(squaredDistance, sender->currentStepTimestamp);
 	}
 }
 
+void TopNErrorsPhysicsSender::Nugget::computeInterest(float squaredDistance, const Time& now)
+{
+	const float nearDistance = (float)DFInt::PhysicsSenderInterestNearDistance;
+	if (squaredDistance <= nearDistance * nearDistance)
+		return;
+
+	const float cullDistance = (float)DFInt::PhysicsSenderInterestCullDistance;
+	if (cullDistance > 0 && squaredDistance > cullDistance * cullDistance)
+	{
+		outOfInterest = true;
+	}
+	else
+	{
+		const float farDistance = (float)std::max(DFInt::PhysicsSenderInterestFarDistance, DFInt::PhysicsSenderInterestNearDistance);
+		const int intervalMs = (squaredDistance <= farDistance * farDistance) ? DFInt::PhysicsSenderInterestNearIntervalMs : DFInt::PhysicsSenderInterestFarIntervalMs;
+
+		outOfInterest = (now - lastSendTime).msec() < intervalMs;
+	}
+
+	// Leave the packet room to the mechanisms that can go out this step
+	if (outOfInterest)
+		error = 0.0f;
+}
+
 void TopNErrorsPhysicsSender::writePV(RakNet::BitStream& bitStream, const Assembly* a, Compressor::CompressionType compressionType, bool crossPacketCompression)
 {
         const CoordinateFrame* cf;
@@ -539,7 +704,7 @@ void TopNErrorsPhysicsSender::writePV(RakNet::BitStream& bitStream, const Assemb
             v = &a->getConstAssemblyPrimitive()->getPV().velocity;
         }
         // writeTranslation
-        if (!crossPacketCompression)
+        if (!crossPacketCompression && !deltaTranslation)
         {
             Compressor::writeTranslation(bitStream, cf->translation, compressionType);
         }
@@ -642,7 +807,12 @@ bool TopNErrorsPhysicsSender::writeMovementHistory(RakNet::BitStream& bitStream,
             }
 
             bitStream << crossPacketCompression;
+            if (SFFlag::getPhysicsSenderDeltaTranslation() && !crossPacketCompression)
+            {
+                writeTranslationKeyframe(bitStream, history.getBaselineCFrame().translation, compressionType);
+            }
             writeAssembly(bitStream, assembly, compressionType, crossPacketCompression);
+            deltaTranslation = false; // child assemblies always send their full translation
             if (crossPacketCompression)
             {
                 lastSendCFrame = calculatedCFrame;
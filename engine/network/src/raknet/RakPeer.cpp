@@ -14,6 +14,8 @@
 //Roblox
 #include "FastLog.h"
 LOGGROUP(RakNetDisconnect)
+DYNAMIC_FASTINT(RakNetRecvBatchSize)
+DYNAMIC_FASTINT(RakNetSendBatchSize)
 
 #ifdef _WIN32
 
@@ -5341,6 +5343,9 @@ bool RakPeer::RunUpdateCycle( RakNet::TimeUS timeNS, RakNet::Time timeMS, BitStr
 
 	// remoteSystemList in network thread
 
+	// ROBLOX: what the reliability layers send below goes out in as few syscalls as possible
+	sendBatch.Begin(DFInt::RakNetSendBatchSize);
+
 ////// ROBLOX:
 	unsigned int count = 0;
 	bool newStartingIndexAssigned = false;
@@ -5784,6 +5789,8 @@ bool RakPeer::RunUpdateCycle( RakNet::TimeUS timeNS, RakNet::Time timeMS, BitStr
 
 	}
 
+	sendBatch.End();
+
 	return true;
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -5805,6 +5812,58 @@ RAK_THREAD_DECLARATION(RakNet::RecvFromLoop)
 	RakPeer::RecvFromStruct *recvFromStruct;
 	while ( rakPeer->endThreads == false )
 	{
+#if defined(__linux__)
+		// ROBLOX: drain everything queued on the socket with one recvmmsg
+		const int recvBatchSize = DFInt::RakNetRecvBatchSize < SOCKET_BATCH_MAX_DATAGRAMS ? DFInt::RakNetRecvBatchSize : SOCKET_BATCH_MAX_DATAGRAMS;
+		if (recvBatchSize > 1 && SocketLayer::GetSocketLayerOverride()==0)
+		{
+			RakPeer::RecvFromStruct *recvFromStructs[ SOCKET_BATCH_MAX_DATAGRAMS ];
+			char *dataOut[ SOCKET_BATCH_MAX_DATAGRAMS ];
+			int bytesReadOut[ SOCKET_BATCH_MAX_DATAGRAMS ];
+			SystemAddress systemAddressOut[ SOCKET_BATCH_MAX_DATAGRAMS ];
+			RakNet::TimeUS timeRead;
+
+			int allocated = 0;
+			while (allocated < recvBatchSize && (recvFromStructs[allocated]=rakPeer->bufferedPackets.Allocate( _FILE_AND_LINE_ ))!=NULL)
+			{
+				dataOut[allocated] = recvFromStructs[allocated]->data;
+				allocated++;
+			}
+
+			if (allocated == 0)
+			{
+				RakSleep(30);
+				continue;
+			}
+
+			int received = SocketLayer::RecvFromBlockingBatch(s, allocated, dataOut, bytesReadOut, systemAddressOut, &timeRead);
+			for (int i=0; i < allocated; i++)
+			{
+				recvFromStruct = recvFromStructs[i];
+				if (i < received && bytesReadOut[i] > 0)
+				{
+					recvFromStruct->s=s;
+					recvFromStruct->remotePortRakNetWasStartedOn_PS3=remotePortRakNetWasStartedOn_PS3;
+					recvFromStruct->extraSocketOptions=extraSocketOptions;
+					recvFromStruct->bytesRead=bytesReadOut[i];
+					recvFromStruct->systemAddress=systemAddressOut[i];
+					recvFromStruct->timeRead=timeRead;
+
+					RakAssert(recvFromStruct->systemAddress.GetPort());
+					rakPeer->bufferedPackets.Push(recvFromStruct);
+				}
+				else
+				{
+					rakPeer->bufferedPackets.Deallocate(recvFromStruct, _FILE_AND_LINE_);
+				}
+			}
+
+			if (received > 0)
+				rakPeer->quitAndDataEvents.SetEvent();
+			continue;
+		}
+#endif
+
 		recvFromStruct=rakPeer->bufferedPackets.Allocate( _FILE_AND_LINE_ );
 		if (recvFromStruct != NULL)
 		{
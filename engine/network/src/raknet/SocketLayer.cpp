@@ -23,6 +23,11 @@ using namespace RakNet;
 
 SocketLayerOverride *SocketLayer::slo=0;
 
+#if defined(__linux__)
+// The batch SendTo adds to on this thread, if any
+static __thread SocketLayerSendBatch *threadSendBatch=0;
+#endif
+
 #ifdef _WIN32
 #else
 #include <string.h> // memcpy
@@ -1104,6 +1109,69 @@ void SocketLayer::RecvFromBlocking( const SOCKET s, RakPeer *rakPeer, unsigned s
 #endif // defined(_PS3) || defined(__PS3__) || defined(SN_TARGET_PS3) || defined(SN_TARGET_PSP2)
 }
 
+int SocketLayer::RecvFromBlockingBatch( const SOCKET s, int count, char *dataOut[], int bytesReadOut[], SystemAddress systemAddressOut[], RakNet::TimeUS *timeRead )
+{
+#if defined(__linux__)
+	RakAssert(count>0 && count<=SOCKET_BATCH_MAX_DATAGRAMS);
+
+	mmsghdr messages[ SOCKET_BATCH_MAX_DATAGRAMS ];
+	iovec buffers[ SOCKET_BATCH_MAX_DATAGRAMS ];
+	sockaddr_storage addresses[ SOCKET_BATCH_MAX_DATAGRAMS ];
+	memset(messages,0,sizeof(mmsghdr)*count);
+
+	for (int i=0; i < count; i++)
+	{
+		buffers[i].iov_base=dataOut[i];
+		buffers[i].iov_len=MAXIMUM_MTU_SIZE;
+		messages[i].msg_hdr.msg_iov=&buffers[i];
+		messages[i].msg_hdr.msg_iovlen=1;
+		messages[i].msg_hdr.msg_name=&addresses[i];
+		messages[i].msg_hdr.msg_namelen=sizeof(sockaddr_storage);
+	}
+
+	// Block for the first datagram only, then take whatever else is already queued
+	int received = recvmmsg( s, messages, count, MSG_WAITFORONE, 0 );
+	if (received<=0)
+		return 0;
+	*timeRead=RakNet::GetTimeUS();
+
+	for (int i=0; i < received; i++)
+	{
+		bytesReadOut[i]=(int) messages[i].msg_len;
+
+		const sockaddr_storage &their_addr=addresses[i];
+		SystemAddress *systemAddress=&systemAddressOut[i];
+#if RAKNET_SUPPORT_IPV6!=1
+		const sockaddr_in *sa=(const sockaddr_in *)&their_addr;
+		systemAddress->SetPortNetworkOrder( sa->sin_port );
+		systemAddress->address.addr4.sin_addr.s_addr=sa->sin_addr.s_addr;
+#else
+		if (their_addr.ss_family==AF_INET)
+		{
+			memcpy(&systemAddress->address.addr4,(sockaddr_in *)&their_addr,sizeof(sockaddr_in));
+			systemAddress->debugPort=ntohs(systemAddress->address.addr4.sin_port);
+		}
+		else
+		{
+			memcpy(&systemAddress->address.addr6,(sockaddr_in6 *)&their_addr,sizeof(sockaddr_in6));
+			systemAddress->debugPort=ntohs(systemAddress->address.addr6.sin6_port);
+		}
+#endif
+	}
+
+	return received;
+#else
+	(void) s;
+	(void) count;
+	(void) dataOut;
+	(void) bytesReadOut;
+	(void) systemAddressOut;
+	(void) timeRead;
+	RakAssert(0);
+	return 0;
+#endif
+}
+
 int SocketLayer::SendTo_PS3Lobby( SOCKET s, const char *data, int length, const SystemAddress &systemAddress, unsigned short remotePortRakNetWasStartedOn_PS3 )
 {
 	(void) s;
@@ -1266,6 +1334,118 @@ int SocketLayer::SendTo_PC( SOCKET s, const char *data, int length, const System
 	return len;
 }
 
+SocketLayerSendBatch::SocketLayerSendBatch()
+{
+	datagrams=0;
+	capacity=0;
+	count=0;
+	s=(SOCKET) -1;
+}
+
+SocketLayerSendBatch::~SocketLayerSendBatch()
+{
+	End();
+	RakNet::OP_DELETE_ARRAY(datagrams, _FILE_AND_LINE_);
+}
+
+void SocketLayerSendBatch::Begin( int capacity )
+{
+#if defined(__linux__)
+	RakAssert(threadSendBatch==0);
+
+	if (capacity<=1)
+		return;
+
+	if (datagrams==0)
+		datagrams=RakNet::OP_NEW_ARRAY<Datagram>(SOCKET_BATCH_MAX_DATAGRAMS, _FILE_AND_LINE_);
+
+	this->capacity=capacity < SOCKET_BATCH_MAX_DATAGRAMS ? capacity : SOCKET_BATCH_MAX_DATAGRAMS;
+	threadSendBatch=this;
+#else
+	(void) capacity;
+#endif
+}
+
+void SocketLayerSendBatch::End( void )
+{
+#if defined(__linux__)
+	if (threadSendBatch!=this)
+		return;
+
+	Flush();
+	threadSendBatch=0;
+#endif
+}
+
+void SocketLayerSendBatch::Add( SOCKET s, const char *data, int length, const SystemAddress &systemAddress )
+{
+	// sendmmsg takes a single socket
+	if (count>0 && s!=this->s)
+		Flush();
+
+	Datagram &datagram=datagrams[count++];
+	memcpy(datagram.data, data, length);
+	datagram.length=length;
+	datagram.systemAddress=systemAddress;
+	this->s=s;
+
+	if (count==capacity)
+		Flush();
+}
+
+void SocketLayerSendBatch::Flush( void )
+{
+#if defined(__linux__)
+	mmsghdr messages[ SOCKET_BATCH_MAX_DATAGRAMS ];
+	iovec buffers[ SOCKET_BATCH_MAX_DATAGRAMS ];
+	memset(messages,0,sizeof(mmsghdr)*count);
+
+	for (int i=0; i < count; i++)
+	{
+		Datagram &datagram=datagrams[i];
+		buffers[i].iov_base=datagram.data;
+		buffers[i].iov_len=datagram.length;
+		messages[i].msg_hdr.msg_iov=&buffers[i];
+		messages[i].msg_hdr.msg_iovlen=1;
+
+		if (datagram.systemAddress.address.addr4.sin_family==AF_INET)
+		{
+			messages[i].msg_hdr.msg_name=&datagram.systemAddress.address.addr4;
+			messages[i].msg_hdr.msg_namelen=sizeof(sockaddr_in);
+		}
+#if RAKNET_SUPPORT_IPV6==1
+		else
+		{
+			messages[i].msg_hdr.msg_name=&datagram.systemAddress.address.addr6;
+			messages[i].msg_hdr.msg_namelen=sizeof(sockaddr_in6);
+		}
+#endif
+	}
+
+	int sent=0;
+	while (sent < count)
+	{
+		int result=sendmmsg( s, messages+sent, count-sent, 0 );
+		if (result>0)
+		{
+			sent+=result;
+		}
+		else if (result<0 && errno==EINTR)
+		{
+			continue;
+		}
+		else
+		{
+			// The datagram at the front failed the way a sendto of it would have, drop it and carry on with the rest
+			RAKNET_DEBUG_PRINTF("sendmmsg failed with errno %i for char %i and length %i.\n", errno, datagrams[sent].data[0], datagrams[sent].length);
+			sent++;
+		}
+	}
+#endif
+
+	count=0;
+}
+
 #ifdef _MSC_VER
 #pragma warning( disable : 4702 ) // warning C4702: unreachable code
 #endif
@@ -1292,6 +1472,13 @@ int SocketLayer::SendTo( SOCKET s, const char *data, int length, SystemAddress &
 		return -1;
 	}
 
+#if defined(__linux__)
+	if (threadSendBatch && remotePortRakNetWasStartedOn_PS3==0)
+	{
+		threadSendBatch->Add(s,data,length,systemAddress);
+		return 0;
+	}
+#endif
 
 	if (remotePortRakNetWasStartedOn_PS3!=0)
 	{
@@ -37,6 +37,8 @@ namespace RBX {
 		virtual void invalidateEntity() {};
 		virtual void updateEntity(bool assetsUpdated = false) {};
 		virtual void updateChunk(const SpatialRegion::Id& pos, bool isWaterChunk) {};
+		// called with chunks that are about to get updateChunk calls, so that work can be done for all of them at once
+		virtual void prepareChunks(const std::vector<SpatialRegion::Id>& positions) {};
 		virtual void onCoordinateFrameChanged() {};
 		virtual void onSizeChanged() { invalidateEntity(); };
 		virtual void onTransparencyChanged() { invalidateEntity(); };
@@ -12,7 +12,7 @@
 
 #include "voxel2/GridListener.h"
 
-namespace RBX { namespace Voxel2 { class MaterialTable; class Grid; class Region; } }
+namespace RBX { namespace Voxel2 { class MaterialTable; class Grid; class Region; namespace Mesher { class GeometryCache; struct BasicMesh; } } }
 
 namespace RBX
 {
@@ -49,6 +49,7 @@ namespace Graphics
         shared_ptr<Material> solidMaterial;
 
 		Voxel2::MaterialTable* materialTable;
+		Voxel2::Mesher::GeometryCache* geometryCache;
 
         std::vector<float> materialConstants;
 	};
@@ -88,13 +89,20 @@ namespace Graphics
 
 		// GfxBinding override
 		virtual void updateChunk(const SpatialRegion::Id& pos, bool isWaterChunk);
+		virtual void prepareChunks(const std::vector<SpatialRegion::Id>& positions);
 
 		void markDirty(const SpatialRegion::Id& pos);
 
+		static Voxel2::Region getChunkRegion(const SpatialRegion::Id& pos);
+
         RenderNode* updateChunkNode(const SpatialRegion::Id& pos);
 		std::pair<RenderEntity*, RenderEntity*> createChunkGeometry(const SpatialRegion::Id& pos, unsigned int* outQuads);
 
 		Voxel::ChunkMap<ChunkData> chunks;
+
+		// Meshed by prepareChunks, consumed by updateChunk
+		typedef boost::unordered_map<SpatialRegion::Id, shared_ptr<const Voxel2::Mesher::BasicMesh>, SpatialRegion::Id::boost_compatible_hash_value> PreparedGeometryMap;
+		PreparedGeometryMap preparedGeometry;
 	};
 
 	class SmoothClusterLOD: public SmoothClusterBase
@@ -158,7 +166,14 @@ namespace Graphics
         RenderNode* updateChunkNode(Chunk& chunk);
 		std::pair<RenderEntity*, RenderEntity*> createChunkGeometry(Chunk& chunk, unsigned int* outQuads);
 
+		static Voxel2::Region getChunkMeshRegion(const ChunkId& id);
+		void prepareChunks(const std::vector<ChunkId>& ids);
+
 		boost::unordered_map<ChunkId, Chunk> chunks;
+
+		// Meshed by prepareChunks, consumed by updateChunk
+		typedef boost::unordered_map<ChunkId, shared_ptr<const Voxel2::Mesher::BasicMesh> > PreparedGeometryMap;
+		PreparedGeometryMap preparedGeometry;
 	};
 
 }
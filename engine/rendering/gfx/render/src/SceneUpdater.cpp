@@ -466,10 +466,36 @@ void SceneUpdater::updateMegaClusters(bool bulkExecution)
 
 	mRenderStats->lastFrameMegaClusterChunks = 0;
 
-	for(MegaClusterChunkList::iterator itChunk = tmpChunk.begin(); itChunk != tmpChunk.end(); ++itChunk)
+	// Let clusters prepare a slice of chunks at once (smooth terrain meshes them in parallel), then update them in order
+	const size_t kPrepareSliceSize = 32;
+
+	for (size_t sliceBegin = 0; sliceBegin < tmpChunk.size(); sliceBegin += kPrepareSliceSize)
 	{
-		itChunk->cluster->updateChunk(itChunk->chunkPos, itChunk->isWaterChunk);
-		mRenderStats->lastFrameMegaClusterChunks++;
+		size_t sliceEnd = std::min(tmpChunk.size(), sliceBegin + kPrepareSliceSize);
+
+		std::vector<std::pair<RBX::GfxPart*, std::vector<SpatialRegion::Id> > > prepare;
+
+		for (size_t i = sliceBegin; i < sliceEnd; ++i)
+		{
+			size_t cluster = 0;
+
+			while (cluster < prepare.size() && prepare[cluster].first != tmpChunk[i].cluster)
+				cluster++;
+
+			if (cluster == prepare.size())
+				prepare.push_back(std::make_pair(tmpChunk[i].cluster, std::vector<SpatialRegion::Id>()));
+
+			prepare[cluster].second.push_back(tmpChunk[i].chunkPos);
+		}
+
+		for (size_t i = 0; i < prepare.size(); ++i)
+			prepare[i].first->prepareChunks(prepare[i].second);
+
+		for (size_t i = sliceBegin; i < sliceEnd; ++i)
+		{
+			tmpChunk[i].cluster->updateChunk(tmpChunk[i].chunkPos, tmpChunk[i].isWaterChunk);
+			mRenderStats->lastFrameMegaClusterChunks++;
+		}
 	}
 }
 
@@ -106,6 +106,7 @@ SmoothClusterBase::SmoothClusterBase(VisualEngine* visualEngine, const boost::sh
     connections.push_back(part->ancestryChangedSignal.connect(boost::bind(&SmoothClusterBase::zombify, this)));
 
 	materialTable = mci->getMaterialTable();
+	geometryCache = mci->getGeometryCache();
 
 	updateMaterialConstants();
 }
@@ -309,6 +310,7 @@ void SmoothClusterBase::reloadMaterialTable()
     MegaClusterInstance* mci = boost::polymorphic_downcast<MegaClusterInstance*>(partInstance.get());
 
 	materialTable = mci->getMaterialTable();
+	geometryCache = mci->getGeometryCache();
 
 	updateMaterialConstants();
 
@@ -483,30 +485,81 @@ RenderNode* SmoothClusterChunked::updateChunkNode(const SpatialRegion::Id& pos)
     return chunk.node.get();
 }
 
-std::pair<RenderEntity*, RenderEntity*> SmoothClusterChunked::createChunkGeometry(const SpatialRegion::Id& pos, unsigned int* outQuads)
+Voxel2::Region SmoothClusterChunked::getChunkRegion(const SpatialRegion::Id& pos)
 {
 	Region3int16 extents = SpatialRegion::inclusiveVoxelExtentsOfRegion(pos);
-	Voxel2::Region region = Voxel2::Region(Vector3int32(extents.getMinPos()), Vector3int32(extents.getMaxPos()) + Vector3int32::one()).expand(kChunkBorder);
 
-	Voxel2::Box box = grid->read(region);
+	return Voxel2::Region(Vector3int32(extents.getMinPos()), Vector3int32(extents.getMaxPos()) + Vector3int32::one()).expand(kChunkBorder);
+}
+
+void SmoothClusterChunked::prepareChunks(const std::vector<SpatialRegion::Id>& positions)
+{
+	using namespace Voxel2::Mesher;
+
+	preparedGeometry.clear();
+
+	if (positions.size() < 2 || !grid || !grid->isAllocated())
+		return;
+
+	Options options = { materialTable, /* generateWater= */ true };
+	Batch batch(geometryCache, options);
+
+	std::vector<SpatialRegion::Id> batchPositions;
 
-	if (box.isEmpty())
+	for (size_t i = 0; i < positions.size(); ++i)
 	{
-        *outQuads = 0;
-		return std::pair<RenderEntity*, RenderEntity*>(NULL, NULL);
+		Voxel2::Region region = getChunkRegion(positions[i]);
+		Voxel2::Box box = grid->read(region);
+
+		// Empty chunks are handled by createChunkGeometry without meshing
+		if (!box.isEmpty())
+		{
+			batch.add(box, region.begin(), 0);
+			batchPositions.push_back(positions[i]);
+		}
 	}
 
+	batch.run();
+
+	for (size_t i = 0; i < batchPositions.size(); ++i)
+		preparedGeometry[batchPositions[i]] = batch.getResult(i);
+}
+
+std::pair<RenderEntity*, RenderEntity*> SmoothClusterChunked::createChunkGeometry(const SpatialRegion::Id& pos, unsigned int* outQuads)
+{
+	Voxel2::Region region = getChunkRegion(pos);
+
 	using namespace Voxel2::Mesher;
 
 	Options options = { materialTable, /* generateWater= */ true };
-	BasicMesh geometry = generateGeometry(box, region.begin(), 0, options);
+	shared_ptr<const BasicMesh> geometry;
+
+	PreparedGeometryMap::iterator prepared = preparedGeometry.find(pos);
+
+	if (prepared != preparedGeometry.end())
+	{
+		geometry = prepared->second;
+		preparedGeometry.erase(prepared);
+	}
+	else
+	{
+		Voxel2::Box box = grid->read(region);
+
+		if (box.isEmpty())
+		{
+			*outQuads = 0;
+			return std::pair<RenderEntity*, RenderEntity*>(NULL, NULL);
+		}
+
+		geometry = geometryCache->generateGeometry(box, region.begin(), 0, options);
+	}
     
-    if (geometry.indices.empty())
+    if (geometry->indices.empty())
         return std::pair<RenderEntity*, RenderEntity*>(NULL, NULL);
     
 	auto packInfo = getPackInfo(region);
 
-	auto graphicsGeometry = generateGraphicsGeometryPacked(geometry, packInfo.first, options);
+	auto graphicsGeometry = generateGraphicsGeometryPacked(*geometry, packInfo.first, options);
 
 	*outQuads = (graphicsGeometry.solidIndices.size() + graphicsGeometry.waterIndices.size()) / 6;
 	
@@ -598,16 +651,23 @@ void SmoothClusterLOD::updateEntity(bool assetsUpdated)
 
 			removeChunk(id);
 
+			std::vector<ChunkId> children;
+
 			for (int x = 0; x < 2; ++x)
 				for (int y = 0; y < 2; ++y)
 					for (int z = 0; z < 2; ++z)
-					{
-						Chunk& child = getChunk(getChildChunk(id, x, y, z));
+						children.push_back(getChildChunk(id, x, y, z));
 
-						updateChunk(child);
+			prepareChunks(children);
+
+			for (size_t i = 0; i < children.size(); ++i)
+			{
+				updateChunk(getChunk(children[i]));
 
-						updatedChunks++;
-					}
+				updatedChunks++;
+			}
+
+			preparedGeometry.clear();
 		}
 		else if (chunk->flags & Flag_NeedsMerge)
 		{
@@ -797,31 +857,77 @@ RenderNode* SmoothClusterLOD::updateChunkNode(Chunk& chunk)
     return chunk.node.get();
 }
 
-std::pair<RenderEntity*, RenderEntity*> SmoothClusterLOD::createChunkGeometry(Chunk& chunk, unsigned int* outQuads)
+Voxel2::Region SmoothClusterLOD::getChunkMeshRegion(const ChunkId& id)
 {
-	int lod = chunk.id.second;
+	return Voxel2::Region::fromChunk(id.first, kChunkSizeLog2 + id.second).expand(kChunkBorder << id.second);
+}
 
-	Voxel2::Region region = chunk.getRegion().expand(kChunkBorder << lod);
+void SmoothClusterLOD::prepareChunks(const std::vector<ChunkId>& ids)
+{
+	using namespace Voxel2::Mesher;
 
-	Voxel2::Box box = grid->read(region, lod);
+	preparedGeometry.clear();
 
-	if (box.isEmpty())
+	Options options = { materialTable, /* generateWater= */ true };
+	Batch batch(geometryCache, options);
+
+	std::vector<ChunkId> batchIds;
+
+	for (size_t i = 0; i < ids.size(); ++i)
 	{
-        *outQuads = 0;
-		return std::pair<RenderEntity*, RenderEntity*>(NULL, NULL);
+		Voxel2::Region region = getChunkMeshRegion(ids[i]);
+		Voxel2::Box box = grid->read(region, ids[i].second);
+
+		if (!box.isEmpty())
+		{
+			batch.add(box, region.begin(), ids[i].second);
+			batchIds.push_back(ids[i]);
+		}
 	}
 
+	batch.run();
+
+	for (size_t i = 0; i < batchIds.size(); ++i)
+		preparedGeometry[batchIds[i]] = batch.getResult(i);
+}
+
+std::pair<RenderEntity*, RenderEntity*> SmoothClusterLOD::createChunkGeometry(Chunk& chunk, unsigned int* outQuads)
+{
+	int lod = chunk.id.second;
+
+	Voxel2::Region region = getChunkMeshRegion(chunk.id);
+
 	using namespace Voxel2::Mesher;
 
 	Options options = { materialTable, /* generateWater= */ true };
-	BasicMesh geometry = generateGeometry(box, region.begin(), lod, options);
+	shared_ptr<const BasicMesh> geometry;
+
+	PreparedGeometryMap::iterator prepared = preparedGeometry.find(chunk.id);
+
+	if (prepared != preparedGeometry.end())
+	{
+		geometry = prepared->second;
+		preparedGeometry.erase(prepared);
+	}
+	else
+	{
+		Voxel2::Box box = grid->read(region, lod);
+
+		if (box.isEmpty())
+		{
+			*outQuads = 0;
+			return std::pair<RenderEntity*, RenderEntity*>(NULL, NULL);
+		}
+
+		geometry = geometryCache->generateGeometry(box, region.begin(), lod, options);
+	}
 
-    if (geometry.indices.empty())
+    if (geometry->indices.empty())
 		return std::pair<RenderEntity*, RenderEntity*>(NULL, NULL);
     
     auto packInfo = getPackInfo(region);
 
-	auto graphicsGeometry = generateGraphicsGeometryPacked(geometry, packInfo.first, options);
+	auto graphicsGeometry = generateGraphicsGeometryPacked(*geometry, packInfo.first, options);
 
 	*outQuads = (graphicsGeometry.solidIndices.size() + graphicsGeometry.waterIndices.size()) / 6;
 	
@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+
+#include "v8datamodel/Folder.h"
+#include "util/ScopedAssign.h"
+#include "FastLog.h"
+
+#include <boost/lexical_cast.hpp>
+
+DYNAMIC_FASTINT(InstanceChildNameIndexThreshold)
+
+using namespace RBX;
+
+// What findFirstChildByName must agree with
+static Instance* scanForChild(Instance* parent, const std::string& name)
+{
+	for (size_t i = 0; i < parent->numChildren(); ++i)
+		if (parent->getChild(i)->getName() == name)
+			return parent->getChild(i);
+	return NULL;
+}
+
+static shared_ptr<Folder> addChild(const shared_ptr<Folder>& parent, const std::string& name)
+{
+	shared_ptr<Folder> child = Creatable<Instance>::create<Folder>();
+	child->setName(name);
+	child->setParent(parent.get());
+	return child;
+}
+
+// Looks every child name up on a parent that is being torn down, as a script's ChildRemoved handler might
+struct LookUpChildren
+{
+	Instance* parent;
+	int count;
+	int* mismatches;
+
+	void operator()(shared_ptr<Instance> removed) const
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			std::string name = "Child" + boost::lexical_cast<std::string>(i);
+			if (parent->findFirstChildByName(name) != scanForChild(parent, name))
+				++*mismatches;
+		}
+	}
+};
+
+BOOST_AUTO_TEST_SUITE(ChildNameIndexTest)
+
+BOOST_AUTO_TEST_CASE(IndexedLookupMatchesScan)
+{
+	ScopedAssign<int> threshold(DFInt::InstanceChildNameIndexThreshold, 8);
+
+	shared_ptr<Folder> parent = Creatable<Instance>::create<Folder>();
+	std::vector<shared_ptr<Folder> > children;
+	for (int i = 0; i < 40; ++i)
+		children.push_back(addChild(parent, "Child" + boost::lexical_cast<std::string>(i % 10)));
+
+	const char* names[] = { "Child0", "Child3", "Child9", "Missing" };
+	const size_t nameCount = sizeof(names) / sizeof(names[0]);
+
+	for (size_t n = 0; n < nameCount; ++n)
+		BOOST_CHECK_EQUAL(parent->findFirstChildByName(names[n]), scanForChild(parent.get(), names[n]));
+
+	// Removing children fast-removes (swaps the last child forward) on big parents
+	children[0]->setParent(NULL);
+	children[13]->setParent(NULL);
+	for (size_t n = 0; n < nameCount; ++n)
+		BOOST_CHECK_EQUAL(parent->findFirstChildByName(names[n]), scanForChild(parent.get(), names[n]));
+
+	// Renames in both directions
+	children[25]->setName("Missing");
+	children[3]->setName("Renamed");
+	for (size_t n = 0; n < nameCount; ++n)
+		BOOST_CHECK_EQUAL(parent->findFirstChildByName(names[n]), scanForChild(parent.get(), names[n]));
+	BOOST_CHECK_EQUAL(parent->findFirstChildByName("Renamed"), children[3].get());
+
+	// Reparenting in
+	shared_ptr<Folder> added = addChild(parent, "Added");
+	BOOST_CHECK_EQUAL(parent->findFirstChildByName("Added"), added.get());
+
+	for (size_t i = 0; i < children.size(); ++i)
+		children[i]->setParent(NULL);
+	added->setParent(NULL);
+	BOOST_CHECK(!parent->findFirstChildByName("Child1"));
+}
+
+BOOST_AUTO_TEST_CASE(LookupWhileParentIsDeleted)
+{
+	ScopedAssign<int> threshold(DFInt::InstanceChildNameIndexThreshold, 8);
+
+	const int count = 40;
+	int mismatches = 0;
+
+	shared_ptr<Folder> parent = Creatable<Instance>::create<Folder>();
+	for (int i = 0; i < count; ++i)
+		addChild(parent, "Child" + boost::lexical_cast<std::string>(i));	// only the parent holds them
+
+	LookUpChildren lookUp = { parent.get(), count, &mismatches };
+	parent->getOrCreateChildRemovedSignal()->connect(lookUp);
+
+	// The last reference goes with the children still attached: each one is released as soon as it
+	// is removed, so an index entry left behind would point at a deleted child
+	parent.reset();
+	BOOST_CHECK_EQUAL(mismatches, 0);
+
+	// Destroy removes the children one by one through the Parent property
+	parent = Creatable<Instance>::create<Folder>();
+	for (int i = 0; i < count; ++i)
+		addChild(parent, "Child" + boost::lexical_cast<std::string>(i));
+
+	lookUp.parent = parent.get();
+	parent->getOrCreateChildRemovedSignal()->connect(lookUp);
+
+	parent->destroy();
+	BOOST_CHECK_EQUAL(mismatches, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
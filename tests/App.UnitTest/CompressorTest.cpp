@@ -0,0 +1,89 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/Compressor.h"
+
+#include "BitStream.h"
+
+using namespace RBX;
+using namespace RBX::Network;
+
+BOOST_AUTO_TEST_SUITE(CompressorTest)
+
+BOOST_AUTO_TEST_CASE(DeltaTranslationDecodesToWrittenValue)
+{
+	const Vector3 reference(812.25f, 37.5f, -1403.75f);
+	const Vector3 moves[] = { Vector3(0, 0, 0), Vector3(0.3f, -0.01f, 1.7f), Vector3(-25.1f, 3.3f, 0.004f), Vector3(-4000, 2000, 7000) };
+
+	for (size_t i = 0; i < sizeof(moves) / sizeof(moves[0]); ++i)
+	{
+		const Vector3 translation = reference + moves[i];
+		BOOST_REQUIRE(Compressor::canDeltaCompressTranslation(translation, reference));
+
+		RakNet::BitStream bitStream;
+		Vector3 written = Compressor::writeTranslationDelta(bitStream, translation, reference);
+
+		Vector3 read;
+		Compressor::readTranslationDelta(bitStream, reference, read);
+
+		BOOST_CHECK_EQUAL(read, written);
+		BOOST_CHECK_SMALL((read - translation).length(), 0.01f);
+		BOOST_CHECK_EQUAL(bitStream.GetNumberOfUnreadBits(), 0u);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SmallDeltaTranslationIsSmallerThanAbsolute)
+{
+	const Vector3 reference(812.25f, 37.5f, -1403.75f);
+	const Vector3 translation = reference + Vector3(0.4f, 0, -0.2f);
+
+	RakNet::BitStream delta;
+	Compressor::writeTranslationDelta(delta, translation, reference);
+
+	RakNet::BitStream absolute;
+	Compressor::writeTranslation(absolute, translation, Compressor::HEAVILY_COMPRESSED);
+
+	BOOST_CHECK_LT(delta.GetNumberOfBitsUsed(), absolute.GetNumberOfBitsUsed() / 2);
+}
+
+BOOST_AUTO_TEST_CASE(FarDeltaTranslationFallsBackToAbsolute)
+{
+	const Vector3 reference(0, 0, 0);
+	BOOST_CHECK(!Compressor::canDeltaCompressTranslation(Vector3(0, 100000, 0), reference));
+	BOOST_CHECK(!Compressor::canDeltaCompressTranslation(Vector3(-100000, 0, 0), reference));
+}
+
+BOOST_AUTO_TEST_CASE(DeltaAfterFullTranslationReconstructsPosition)
+{
+	// Off the heavily compressed grid, so the full translation does not decode to the exact value
+	const Vector3 first(812.3f, 37.55f, -403.71f);
+	const Vector3 second = first + Vector3(0.3f, -0.02f, 1.1f);
+
+	const Compressor::CompressionType compressionTypes[] = { Compressor::RAKNET_COMPRESSED, Compressor::HEAVILY_COMPRESSED };
+
+	for (size_t i = 0; i < sizeof(compressionTypes) / sizeof(compressionTypes[0]); ++i)
+	{
+		// Server sends the full translation with the PV and keeps it as the keyframe the next delta refers to
+		RakNet::BitStream full;
+		Compressor::writeTranslation(full, first, compressionTypes[i]);
+		const Vector3 senderReference = Compressor::decodedTranslation(first, compressionTypes[i]);
+
+		// Client keeps the translation it decoded
+		Vector3 receiverReference;
+		Compressor::readTranslation(full, receiverReference);
+		BOOST_CHECK_EQUAL(senderReference, receiverReference);
+
+		// Once the keyframe is acked the next update goes out as a delta against it
+		RakNet::BitStream delta;
+		Vector3 sent = Compressor::writeTranslationDelta(delta, second, senderReference);
+
+		Vector3 received;
+		Compressor::readTranslationDelta(delta, receiverReference, received);
+
+		BOOST_CHECK_EQUAL(received, sent);
+		BOOST_CHECK_SMALL((received - second).length(), 0.01f);
+	}
+
+	BOOST_CHECK(Compressor::decodedTranslation(first, Compressor::HEAVILY_COMPRESSED) != first);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/NetworkPacketCache.h"
+#include "v8datamodel/BasicPartInstance.h"
+
+#include "BitStream.h"
+
+using namespace RBX;
+using namespace RBX::Network;
+
+static shared_ptr<const InstancePacketCache::JoinDataChunk> buildChunk(InstancePacketCache& cache, const std::vector<shared_ptr<BasicPartInstance> >& parts)
+{
+	shared_ptr<InstancePacketCache::JoinDataChunk> chunk(new InstancePacketCache::JoinDataChunk());
+	chunk->compressionLevel = 1;
+	chunk->compressedData.reset(new RakNet::BitStream());
+
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+		InstancePacketCache::JoinDataChunk::Entry entry = { parts[i].get(), 0 };
+		BOOST_REQUIRE(cache.getVersion(parts[i].get(), entry.version));
+
+		RakNet::BitStream data;
+		data.Write((int)i);
+		cache.update(parts[i].get(), data, data.GetNumberOfBitsUsed(), true);
+
+		chunk->entries.push_back(entry);
+	}
+
+	cache.updateJoinDataChunk(chunk);
+	return chunk;
+}
+
+BOOST_AUTO_TEST_SUITE(InstancePacketCacheTest)
+
+BOOST_AUTO_TEST_CASE(JoinDataChunkIsDroppedWhenAnInstanceChanges)
+{
+	shared_ptr<InstancePacketCache> cache = Creatable<Instance>::create<InstancePacketCache>();
+
+	std::vector<shared_ptr<BasicPartInstance> > parts;
+	for (int i = 0; i < 3; ++i)
+	{
+		parts.push_back(Creatable<Instance>::create<BasicPartInstance>());
+		cache->insert(parts.back().get());
+	}
+
+	shared_ptr<const InstancePacketCache::JoinDataChunk> chunk = buildChunk(*cache, parts);
+	BOOST_CHECK(cache->fetchJoinDataChunkIfUpToDate(parts[0].get()) == chunk);
+
+	// Chunks are only found by their first instance
+	BOOST_CHECK(!cache->fetchJoinDataChunkIfUpToDate(parts[1].get()));
+
+	// A change to any instance in the chunk invalidates it, until the chunk is rebuilt
+	parts[2]->setTransparency(0.5f);
+	BOOST_CHECK(!cache->fetchJoinDataChunkIfUpToDate(parts[0].get()));
+
+	chunk = buildChunk(*cache, parts);
+	BOOST_CHECK(cache->fetchJoinDataChunkIfUpToDate(parts[0].get()) == chunk);
+
+	// So does an instance leaving the cache
+	cache->remove(parts[1].get());
+	BOOST_CHECK(!cache->fetchJoinDataChunkIfUpToDate(parts[0].get()));
+
+	cache->remove(parts[0].get());
+	cache->remove(parts[2].get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,187 @@
+#include <boost/test/unit_test.hpp>
+
+#include "script/LuaCompileCache.h"
+#include "script/LuaVM.h"
+
+#include "lua.h"
+#include "lauxlib.h"
+#include "lobject.h"
+#include "lstate.h"
+
+using namespace RBX;
+using namespace RBX::Lua;
+
+static const char* kSource =
+	"local Players = game:GetService('Players')\n"
+	"local function onAdded(player, count)\n"
+	"	local greeting = 'Hello ' .. player.Name\n"
+	"	return function() return greeting, count * 2.5, true, nil end\n"
+	"end\n"
+	"Players.PlayerAdded:connect(onAdded)\n";
+
+struct LoadS
+{
+	const char* s;
+	size_t size;
+};
+
+static const char* getS(lua_State* L, void* ud, size_t* size)
+{
+	LoadS* ls = static_cast<LoadS*>(ud);
+	if (ls->size == 0) return NULL;
+	*size = ls->size;
+	ls->size = 0;
+	return ls->s;
+}
+
+static int compile(lua_State* L, const std::string& source, const char* chunkname)
+{
+	LoadS ls = { source.c_str(), source.size() };
+	return lua_load(L, getS, &ls, chunkname);
+}
+
+static const Proto* topProto(lua_State* L)
+{
+	return clvalue(L->top - 1)->l.p;
+}
+
+static std::string str(const TString* s)
+{
+	return s ? std::string(getstr(s), s->tsv.len) : "<null>";
+}
+
+static void checkSameProto(const Proto* a, const Proto* b)
+{
+	BOOST_REQUIRE_EQUAL(a->sizecode, b->sizecode);
+	for (int i = 0; i < a->sizecode; ++i)
+		BOOST_CHECK_EQUAL(a->code[i].v, b->code[i].v);
+
+	BOOST_REQUIRE_EQUAL(a->sizelineinfo, b->sizelineinfo);
+	for (int i = 0; i < a->sizelineinfo; ++i)
+		BOOST_CHECK_EQUAL(a->lineinfo[i], b->lineinfo[i]);
+
+	BOOST_REQUIRE_EQUAL(a->sizek, b->sizek);
+	for (int i = 0; i < a->sizek; ++i)
+	{
+		const TValue* ka = &a->k[i];
+		const TValue* kb = &b->k[i];
+		BOOST_REQUIRE_EQUAL(ttype(ka), ttype(kb));
+		if (ttisnumber(ka))
+			BOOST_CHECK_EQUAL(nvalue(ka), nvalue(kb));
+		else if (ttisstring(ka))
+			BOOST_CHECK_EQUAL(str(rawtsvalue(ka)), str(rawtsvalue(kb)));
+		else if (ttisboolean(ka))
+			BOOST_CHECK_EQUAL(bvalue(ka), bvalue(kb));
+	}
+
+	BOOST_REQUIRE_EQUAL(a->sizelocvars, b->sizelocvars);
+	for (int i = 0; i < a->sizelocvars; ++i)
+	{
+		BOOST_CHECK_EQUAL(str(a->locvars[i].varname), str(b->locvars[i].varname));
+		BOOST_CHECK_EQUAL(a->locvars[i].startpc, b->locvars[i].startpc);
+		BOOST_CHECK_EQUAL(a->locvars[i].endpc, b->locvars[i].endpc);
+	}
+
+	BOOST_REQUIRE_EQUAL(a->sizeupvalues, b->sizeupvalues);
+	for (int i = 0; i < a->sizeupvalues; ++i)
+		BOOST_CHECK_EQUAL(str(a->upvalues[i]), str(b->upvalues[i]));
+
+	BOOST_CHECK_EQUAL(str(a->source), str(b->source));
+	BOOST_CHECK_EQUAL(a->linedefined, b->linedefined);
+	BOOST_CHECK_EQUAL(a->lastlinedefined, b->lastlinedefined);
+	BOOST_CHECK_EQUAL(a->nups, b->nups);
+	BOOST_CHECK_EQUAL(a->numparams, b->numparams);
+	BOOST_CHECK_EQUAL(a->is_vararg, b->is_vararg);
+	BOOST_CHECK_EQUAL(a->maxstacksize, b->maxstacksize);
+
+	BOOST_REQUIRE_EQUAL(a->sizep, b->sizep);
+	for (int i = 0; i < a->sizep; ++i)
+		checkSameProto(a->p[i], b->p[i]);
+}
+
+static lua_State* newState()
+{
+	lua_State* L = luaL_newstate();
+	L->l_G->ckey = LUAVM_KEY_DUMMY;
+	return L;
+}
+
+BOOST_AUTO_TEST_SUITE(LuaCompileCacheTest)
+
+BOOST_AUTO_TEST_CASE(CachedChunkMatchesCompiledChunk)
+{
+	CompileCache cache(1024 * 1024);
+	const std::string source = kSource;
+
+	lua_State* first = newState();
+	lua_State* second = newState();
+
+	int status = -1;
+	BOOST_CHECK(!cache.load(first, source, "=Script", status));
+	BOOST_REQUIRE_EQUAL(compile(first, source, "=Script"), 0);
+	cache.store(first, source);
+	BOOST_CHECK_EQUAL(cache.getEntries(), 1u);
+
+	// A different state, and a different chunk name, still hits
+	BOOST_REQUIRE(cache.load(second, source, "=Other.Script", status));
+	BOOST_REQUIRE_EQUAL(status, 0);
+	BOOST_CHECK_EQUAL(cache.getHits(), 1u);
+
+	BOOST_REQUIRE_EQUAL(compile(second, source, "=Other.Script"), 0);
+	checkSameProto(topProto(second), clvalue(second->top - 2)->l.p);
+
+	lua_close(first);
+	lua_close(second);
+}
+
+BOOST_AUTO_TEST_CASE(MissesOnDifferentSourceOrKey)
+{
+	CompileCache cache(1024 * 1024);
+	const std::string source = kSource;
+
+	lua_State* L = newState();
+	BOOST_REQUIRE_EQUAL(compile(L, source, "=Script"), 0);
+	cache.store(L, source);
+
+	int status = -1;
+	BOOST_CHECK(!cache.load(L, source + " ", "=Script", status));
+
+	L->l_G->ckey = 12345;
+	BOOST_CHECK(!cache.load(L, source, "=Script", status));
+	L->l_G->ckey = LUAVM_KEY_DUMMY;
+
+	BOOST_CHECK(cache.load(L, source, "=Script", status));
+	BOOST_CHECK_EQUAL(cache.getMisses(), 2u);
+
+	lua_close(L);
+}
+
+BOOST_AUTO_TEST_CASE(EvictsLeastRecentlyUsed)
+{
+	CompileCache cache(1024 * 1024);
+	lua_State* L = newState();
+
+	std::string sources[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		sources[i] = std::string(kSource) + "local padding = " + std::string(1, char('1' + i)) + "\n";
+		BOOST_REQUIRE_EQUAL(compile(L, sources[i], "=Script"), 0);
+		cache.store(L, sources[i]);
+		lua_pop(L, 1);
+	}
+	BOOST_REQUIRE_EQUAL(cache.getEntries(), 3u);
+
+	// Touch the first so the second is the oldest, then shrink to two entries
+	int status = -1;
+	BOOST_REQUIRE(cache.load(L, sources[0], "=Script", status));
+	lua_pop(L, 1);
+
+	cache.setCapacity(cache.getBytes() * 2 / 3 + 1);
+	BOOST_CHECK_EQUAL(cache.getEntries(), 2u);
+	BOOST_CHECK(cache.load(L, sources[0], "=Script", status));
+	BOOST_CHECK(!cache.load(L, sources[1], "=Script", status));
+
+	lua_close(L);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+#include <boost/test/unit_test.hpp>
+
+#include "script/LuaMemberLookupCache.h"
+#include "v8datamodel/BasicPartInstance.h"
+
+using namespace RBX;
+using namespace RBX::Lua;
+
+BOOST_AUTO_TEST_SUITE(LuaMemberLookupCacheTest)
+
+BOOST_AUTO_TEST_CASE(ResolvesMembersInIndexOrder)
+{
+	MemberLookupCache cache;
+	shared_ptr<BasicPartInstance> part = Creatable<Instance>::create<BasicPartInstance>();
+	const Reflection::ClassDescriptor& desc = part->getDescriptor();
+
+	const MemberLookupCache::Entry& position = cache.lookup(desc, "Position");
+	BOOST_CHECK_EQUAL(position.kind, MemberLookupCache::Kind_Property);
+	BOOST_CHECK(position.property == desc.findPropertyDescriptor("Position"));
+	BOOST_CHECK(position.member == position.property);
+
+	BOOST_CHECK_EQUAL(cache.lookup(desc, "Destroy").kind, MemberLookupCache::Kind_Function);
+	BOOST_CHECK_EQUAL(cache.lookup(desc, "Touched").kind, MemberLookupCache::Kind_Event);
+
+	const MemberLookupCache::Entry& child = cache.lookup(desc, "SomeChild");
+	BOOST_CHECK_EQUAL(child.kind, MemberLookupCache::Kind_None);
+	BOOST_CHECK(!child.member);
+	BOOST_CHECK(!child.property);
+	BOOST_CHECK(!child.callback);
+}
+
+BOOST_AUTO_TEST_CASE(HitsOnlyForTheSameString)
+{
+	MemberLookupCache cache;
+	shared_ptr<BasicPartInstance> part = Creatable<Instance>::create<BasicPartInstance>();
+	const Reflection::ClassDescriptor& desc = part->getDescriptor();
+
+	char name[] = "Transparency";
+	cache.lookup(desc, name);
+	BOOST_CHECK_EQUAL(cache.getMisses(), 1u);
+
+	cache.lookup(desc, name);
+	BOOST_CHECK_EQUAL(cache.getHits(), 1u);
+
+	// The same memory now holding a different name must not hit
+	strcpy(name, "Reflectance");
+	const MemberLookupCache::Entry& entry = cache.lookup(desc, name);
+	BOOST_CHECK_EQUAL(cache.getHits(), 1u);
+	BOOST_CHECK(entry.property == desc.findPropertyDescriptor("Reflectance"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
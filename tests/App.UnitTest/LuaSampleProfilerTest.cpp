@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include "script/LuaSampleProfiler.h"
+#include "util/ScopedAssign.h"
+#include "FastLog.h"
+
+#include "lua.h"
+#include "lauxlib.h"
+
+DYNAMIC_FASTINT(LuaSampleProfilerMaxDepth)
+
+using namespace RBX;
+using namespace RBX::Lua;
+
+// Builds a stack of C frames (depth given by the first argument) and samples from the innermost one.
+// C frames need no bytecode, so this runs the same on every build flavor.
+static int nested(lua_State* L)
+{
+	int depth = (int)lua_tointeger(L, 1);
+	SampleProfiler* profiler = static_cast<SampleProfiler*>(lua_touserdata(L, 2));
+
+	if (depth > 1)
+	{
+		lua_pushcfunction(L, nested);
+		lua_pushinteger(L, depth - 1);
+		lua_pushlightuserdata(L, profiler);
+		lua_call(L, 2, 0);
+	}
+	else
+	{
+		profiler->sample(L, Time::nowFast());
+	}
+
+	return 0;
+}
+
+static int hookRepeatedly(lua_State* L)
+{
+	SampleProfiler* profiler = static_cast<SampleProfiler*>(lua_touserdata(L, 1));
+
+	for (int i = 0; i < 100; ++i)
+		profiler->hook(L);
+
+	return 0;
+}
+
+static void sampleAtDepth(lua_State* L, SampleProfiler& profiler, int depth)
+{
+	lua_pushcfunction(L, nested);
+	lua_pushinteger(L, depth);
+	lua_pushlightuserdata(L, &profiler);
+	BOOST_REQUIRE_EQUAL(lua_pcall(L, 2, 0, 0), 0);
+}
+
+BOOST_AUTO_TEST_SUITE(LuaSampleProfilerTest)
+
+BOOST_AUTO_TEST_CASE(FoldsSamplesByStack)
+{
+	lua_State* L = luaL_newstate();
+	SampleProfiler profiler(1000);
+
+	sampleAtDepth(L, profiler, 1);
+	sampleAtDepth(L, profiler, 3);
+	sampleAtDepth(L, profiler, 3);
+
+	BOOST_CHECK_EQUAL(profiler.getSampleCount(), 3u);
+	BOOST_CHECK_EQUAL(profiler.getStackCount(), 2u);
+
+	const std::string frame = "<anonymous> ([C])";
+	BOOST_CHECK_EQUAL(profiler.getFoldedStacks(),
+		frame + " 1\n" +
+		frame + ";" + frame + ";" + frame + " 2\n");
+
+	lua_close(L);
+}
+
+BOOST_AUTO_TEST_CASE(TruncatesDeepStacksAtTheRoot)
+{
+	ScopedAssign<int> maxDepth(DFInt::LuaSampleProfilerMaxDepth, 2);
+
+	lua_State* L = luaL_newstate();
+	SampleProfiler profiler(1000);
+
+	sampleAtDepth(L, profiler, 5);
+
+	const std::string frame = "<anonymous> ([C])";
+	BOOST_CHECK_EQUAL(profiler.getFoldedStacks(), "...;" + frame + ";" + frame + " 1\n");
+
+	lua_close(L);
+}
+
+BOOST_AUTO_TEST_CASE(SamplesOncePerInterval)
+{
+	lua_State* L = luaL_newstate();
+
+	// Once a second, so back to back hooks sample once
+	SampleProfiler profiler(1);
+
+	lua_pushcfunction(L, hookRepeatedly);
+	lua_pushlightuserdata(L, &profiler);
+	BOOST_REQUIRE_EQUAL(lua_pcall(L, 1, 0, 0), 0);
+
+	BOOST_CHECK_EQUAL(profiler.getSampleCount(), 1u);
+
+	// No frames outside a call, nothing to record
+	profiler.sample(L, Time::nowFast());
+	BOOST_CHECK_EQUAL(profiler.getSampleCount(), 1u);
+
+	lua_close(L);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+#include <boost/test/unit_test.hpp>
+
+#include "rbx/test/DataModelFixture.h"
+#include "rbx/test/ScopedFastFlagSetting.h"
+#include "v8datamodel/BasicPartInstance.h"
+#include "v8datamodel/ParametricPartInstance.h"
+#include "v8datamodel/Workspace.h"
+#include "v8kernel/Kernel.h"
+#include "v8world/World.h"
+#include "util/ScopedAssign.h"
+#include "FastLog.h"
+
+DYNAMIC_FASTINT(PGSSolverBatchedIslandMinConstraints)
+DYNAMIC_FASTINT(PGSSolverSIMDLanesMinConstraints)
+
+using namespace RBX;
+
+// The parallel paths all claim to give the same results as the serial ones, bit for bit.
+// Each case runs the same scene both ways and compares every part at the end.
+// On a single core machine the kernel has no worker pool and both runs are serial.
+
+struct PartState
+{
+	CoordinateFrame cframe;
+	Vector3 linearVelocity;
+	Vector3 rotationalVelocity;
+};
+
+struct SceneResult
+{
+	std::vector<PartState> parts;
+	int connectors;
+};
+
+static void addPart(Workspace* workspace, shared_ptr<FormFactorPart> part, const Vector3& size, const CoordinateFrame& cframe, bool anchored, std::vector<shared_ptr<PartInstance> >& parts)
+{
+	part->setFormFactorXml(PartInstance::CUSTOM);
+	part->setPartSizeXml(size);
+	part->setCoordinateFrame(cframe);
+	part->setAnchored(anchored);
+	part->setParent(workspace);
+	parts.push_back(part);
+}
+
+// An 8x8 grid of blocks on an anchored plate, with a wedge on each block. The blocks touch their
+// neighbors so the stack is a single island, and the wedges give block-poly and poly-poly contacts.
+static SceneResult simulateStack(int numThreads)
+{
+	DataModelFixture dm;
+	DataModel::LegacyLock lock(&dm, RBX::DataModelJob::Write);
+
+	Workspace* workspace = dm->getWorkspace();
+	workspace->getWorld()->setUsingPGSSolver(true);
+
+	std::vector<shared_ptr<PartInstance> > parts;
+	addPart(workspace, Creatable<Instance>::create<BasicPartInstance>(), Vector3(40, 2, 40), CoordinateFrame(Vector3(0, -1, 0)), true, parts);
+
+	for (int i = 0; i < 8; ++i)
+		for (int j = 0; j < 8; ++j)
+		{
+			Vector3 position((i - 3.5f) * 2, 1, (j - 3.5f) * 2);
+			addPart(workspace, Creatable<Instance>::create<BasicPartInstance>(), Vector3(2, 2, 2), CoordinateFrame(position), false, parts);
+
+			// Alternate the slopes, and drop the wedges a little so the stack has something to solve
+			Matrix3 rotation = Matrix3::fromAxisAngle(Vector3::unitY(), ((i + j) % 2) ? G3D::halfPi() : 0.0f);
+			addPart(workspace, Creatable<Instance>::create<PART::Wedge>(), Vector3(2, 2, 2), CoordinateFrame(rotation, position + Vector3(0, 2.25f, 0)), false, parts);
+		}
+
+	for (int step = 0; step < 30; ++step)
+	{
+		workspace->assemble();
+		workspace->physicsStep(false, 1.0f / 30.0f, numThreads);
+	}
+
+	SceneResult result;
+	result.connectors = workspace->getWorld()->getKernel()->numConnectors();
+
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+		PartState state = { parts[i]->getCoordinateFrame(), parts[i]->getLinearVelocity(), parts[i]->getRotationalVelocity() };
+		result.parts.push_back(state);
+	}
+
+	return result;
+}
+
+static void checkSameResult(const SceneResult& expected, const SceneResult& actual)
+{
+	BOOST_CHECK_EQUAL(expected.connectors, actual.connectors);
+	BOOST_REQUIRE_EQUAL(expected.parts.size(), actual.parts.size());
+
+	for (size_t i = 0; i < expected.parts.size(); ++i)
+	{
+		const PartState& e = expected.parts[i];
+		const PartState& a = actual.parts[i];
+
+		BOOST_CHECK_MESSAGE(e.cframe.translation == a.cframe.translation && e.cframe.rotation == a.cframe.rotation, "part " << i << " ended at a different cframe");
+		BOOST_CHECK_MESSAGE(e.linearVelocity == a.linearVelocity && e.rotationalVelocity == a.rotationalVelocity, "part " << i << " ended with a different velocity");
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(ParallelPhysicsTest)
+
+BOOST_AUTO_TEST_CASE(BatchedSolverMatchesAcrossThreadCounts)
+{
+	ScopedFastFlagSetting islandizable("PGSSolverUsesIslandizableCode", true);
+	ScopedFastFlagSetting parallelIslands("PGSSolverParallelIslandsEnabled", true);
+	ScopedAssign<int> batchedMin(DFInt::PGSSolverBatchedIslandMinConstraints, 16);
+
+	SceneResult serial = simulateStack(1);
+	BOOST_REQUIRE_GE(serial.connectors, 16);
+
+	checkSameResult(serial, simulateStack(4));
+}
+
+BOOST_AUTO_TEST_CASE(BatchedSolverSettlesLikeSerialSolver)
+{
+	ScopedFastFlagSetting islandizable("PGSSolverUsesIslandizableCode", true);
+
+	SceneResult serial = simulateStack(1);
+
+	SceneResult batched;
+	{
+		ScopedFastFlagSetting parallelIslands("PGSSolverParallelIslandsEnabled", true);
+		ScopedAssign<int> batchedMin(DFInt::PGSSolverBatchedIslandMinConstraints, 16);
+
+		batched = simulateStack(4);
+	}
+
+	// Visiting the constraints in a different order changes the iterates, but not where the stack comes to rest
+	BOOST_REQUIRE_EQUAL(serial.parts.size(), batched.parts.size());
+	for (size_t i = 0; i < serial.parts.size(); ++i)
+		BOOST_CHECK_MESSAGE((serial.parts[i].cframe.translation - batched.parts[i].cframe.translation).magnitude() < 0.1f, "part " << i << " settled elsewhere");
+}
+
+BOOST_AUTO_TEST_CASE(CollisionLanesMatchScalarBatches)
+{
+	ScopedFastFlagSetting islandizable("PGSSolverUsesIslandizableCode", true);
+	ScopedFastFlagSetting parallelIslands("PGSSolverParallelIslandsEnabled", true);
+	ScopedAssign<int> batchedMin(DFInt::PGSSolverBatchedIslandMinConstraints, 16);
+	ScopedAssign<int> lanesMin(DFInt::PGSSolverSIMDLanesMinConstraints, 16);
+
+	// Same batches as the lanes, one collision at a time
+	SceneResult scalar = simulateStack(1);
+	BOOST_REQUIRE_GE(scalar.connectors, 16);
+
+	ScopedFastFlagSetting lanes("PGSSolverSIMDCollisionLanesEnabled", true);
+
+	checkSameResult(scalar, simulateStack(1));
+	checkSameResult(scalar, simulateStack(4));
+}
+
+BOOST_AUTO_TEST_CASE(ParallelNarrowphaseMatchesSerial)
+{
+	ScopedFastFlagSetting islandizable("PGSSolverUsesIslandizableCode", true);
+
+	// The narrowphase only runs on the pool past 64 poly contacts, the wedges alone have 64 with the blocks
+	SceneResult serial = simulateStack(4);
+
+	ScopedFastFlagSetting narrowphase("PhysicsParallelNarrowphaseEnabled", true);
+
+	checkSameResult(serial, simulateStack(4));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
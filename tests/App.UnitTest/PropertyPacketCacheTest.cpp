@@ -0,0 +1,53 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/NetworkPacketCache.h"
+#include "v8datamodel/BasicPartInstance.h"
+
+#include "BitStream.h"
+
+using namespace RBX;
+using namespace RBX::Network;
+
+BOOST_AUTO_TEST_SUITE(PropertyPacketCacheTest)
+
+BOOST_AUTO_TEST_CASE(OnlyDictionaryFreeTypesAreCached)
+{
+	BOOST_CHECK(PropertyPacketCache::canCache(PartInstance::prop_Transparency));
+	BOOST_CHECK(PropertyPacketCache::canCache(PartInstance::prop_Size));
+	BOOST_CHECK(!PropertyPacketCache::canCache(Instance::desc_Name));
+	BOOST_CHECK(!PropertyPacketCache::canCache(Instance::propParent));
+}
+
+BOOST_AUTO_TEST_CASE(FetchReturnsUpdatedBitsUntilInvalidated)
+{
+	shared_ptr<PropertyPacketCache> cache = Creatable<Instance>::create<PropertyPacketCache>();
+	shared_ptr<BasicPartInstance> part = Creatable<Instance>::create<BasicPartInstance>();
+
+	RakNet::BitStream out;
+	BOOST_CHECK(!cache->fetchIfUpToDate(part.get(), PartInstance::prop_Transparency, out));
+
+	// Cache a value written at an unaligned position, the way it sits inside a packet
+	RakNet::BitStream packet;
+	packet.Write1();
+	unsigned int startBit = packet.GetNumberOfBitsUsed();
+	packet.Write(0.25f);
+	cache->update(part.get(), PartInstance::prop_Transparency, packet, startBit, packet.GetNumberOfBitsUsed() - startBit);
+
+	BOOST_REQUIRE(cache->fetchIfUpToDate(part.get(), PartInstance::prop_Transparency, out));
+	BOOST_CHECK_EQUAL(out.GetNumberOfBitsUsed(), 32u);
+
+	float value = 0;
+	out.Read(value);
+	BOOST_CHECK_EQUAL(value, 0.25f);
+
+	BOOST_CHECK(!cache->fetchIfUpToDate(part.get(), PartInstance::prop_Reflectance, out));
+
+	cache->invalidate(part.get(), PartInstance::prop_Transparency);
+	BOOST_CHECK(!cache->fetchIfUpToDate(part.get(), PartInstance::prop_Transparency, out));
+
+	cache->update(part.get(), PartInstance::prop_Transparency, packet, startBit, packet.GetNumberOfBitsUsed() - startBit);
+	cache->remove(part.get());
+	BOOST_CHECK(!cache->fetchIfUpToDate(part.get(), PartInstance::prop_Transparency, out));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
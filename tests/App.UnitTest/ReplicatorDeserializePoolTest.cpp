@@ -0,0 +1,116 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/PacketIds.h"
+#include "network/Replicator.h"
+#include "network/Server.h"
+#include "network/ServerReplicator.h"
+#include "security/SecurityContext.h"
+#include "util/ScopedAssign.h"
+
+#include <boost/thread/thread.hpp>
+
+DYNAMIC_FASTINT(DeserializePacketsPoolThreads)
+DYNAMIC_FASTINT(DeserializePacketsPerTask)
+
+using namespace RBX;
+using namespace RBX::Network;
+
+struct ReplicatorDeserializeTestWrapper
+{
+	shared_ptr<Server> server;
+	shared_ptr<Replicator> replicator;
+
+	ReplicatorDeserializeTestWrapper()
+	{
+		Security::Impersonator impersonate(Security::CmdLine_);
+
+		server = Creatable<Instance>::create<Server>();
+		replicator = Creatable<Instance>::create<ServerReplicator>(RakNet::SystemAddress(), server.get(), &NetworkSettings::singleton());
+		replicator->enableDeserializePacketThread();
+	}
+
+	~ReplicatorDeserializeTestWrapper()
+	{
+		replicator->onServiceProvider(NULL, NULL);
+	}
+
+	bool isPooled() const
+	{
+		return replicator->deserializePacketsPooled;
+	}
+
+	void push(unsigned int sequence)
+	{
+		// Not a data or touch packet, so it goes to the process job as is, in the order it was deserialized
+		RakNet::Packet* packet = new RakNet::Packet();
+		packet->length = 1 + sizeof(sequence);
+		packet->bitSize = packet->length * 8;
+		packet->data = new unsigned char[packet->length];
+		packet->data[0] = ID_PHYSICS;
+		memcpy(packet->data + 1, &sequence, sizeof(sequence));
+
+		replicator->pushIncomingPacket(packet);
+	}
+
+	bool pop(unsigned int& sequence)
+	{
+		DeserializedPacket deserializedPacket;
+		if (!replicator->deserializedPackets.pop_if_present(deserializedPacket))
+			return false;
+
+		memcpy(&sequence, deserializedPacket.rawPacket->data + 1, sizeof(sequence));
+
+		delete[] deserializedPacket.rawPacket->data;
+		delete deserializedPacket.rawPacket;
+		return true;
+	}
+};
+
+BOOST_AUTO_TEST_SUITE(ReplicatorDeserializePoolTest)
+
+BOOST_AUTO_TEST_CASE(PooledDeserializeKeepsPacketOrderPerConnection)
+{
+	// A small batch makes every connection requeue many times across the pool threads
+	ScopedAssign<int> poolThreads(DFInt::DeserializePacketsPoolThreads, 4);
+	ScopedAssign<int> packetsPerTask(DFInt::DeserializePacketsPerTask, 3);
+
+	const int kConnections = 3;
+	const unsigned int kPackets = 500;
+
+	ReplicatorDeserializeTestWrapper connections[kConnections];
+	for (int c = 0; c < kConnections; ++c)
+		BOOST_REQUIRE(connections[c].isPooled());
+
+	// Interleave the connections, the pool sees all of them at once
+	for (unsigned int i = 0; i < kPackets; ++i)
+		for (int c = 0; c < kConnections; ++c)
+			connections[c].push(i);
+
+	unsigned int received[kConnections] = {};
+	const Time deadline = Time::now<Time::Fast>() + Time::Interval(10);
+
+	bool done = false;
+	while (!done && Time::now<Time::Fast>() < deadline)
+	{
+		done = true;
+		for (int c = 0; c < kConnections; ++c)
+		{
+			unsigned int sequence;
+			while (connections[c].pop(sequence))
+			{
+				BOOST_REQUIRE_EQUAL(sequence, received[c]);
+				++received[c];
+			}
+
+			done = done && received[c] == kPackets;
+		}
+
+		if (!done)
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+	}
+
+	for (int c = 0; c < kConnections; ++c)
+		BOOST_CHECK_EQUAL(received[c], kPackets);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/ReplicatorStats.h"
+#include "util/ScopedAssign.h"
+
+DYNAMIC_FASTINT(ReplicatorSendAttributionSampleInterval)
+DYNAMIC_FASTINT(ReplicatorSendAttributionMaxEntries)
+
+using namespace RBX;
+using namespace RBX::Network;
+
+BOOST_AUTO_TEST_SUITE(ReplicatorStatsTest)
+
+BOOST_AUTO_TEST_CASE(SendAttributionSamplesOneInInterval)
+{
+	ScopedAssign<int> interval(DFInt::ReplicatorSendAttributionSampleInterval, 0);
+
+	ReplicatorStats stats;
+
+	for (int i = 0; i < 10; ++i)
+		BOOST_CHECK_EQUAL(stats.beginSendAttribution(), 0);
+
+	DFInt::ReplicatorSendAttributionSampleInterval = 4;
+	int sampled = 0;
+	for (int i = 0; i < 16; ++i)
+	{
+		if (int scale = stats.beginSendAttribution())
+		{
+			BOOST_CHECK_EQUAL(scale, 4);
+			++sampled;
+		}
+	}
+	BOOST_CHECK_EQUAL(sampled, 4);
+}
+
+BOOST_AUTO_TEST_CASE(SendAttributionFoldsExtraKeysIntoOther)
+{
+	ScopedAssign<int> maxEntries(DFInt::ReplicatorSendAttributionMaxEntries, 2);
+
+	ReplicatorStats stats;
+	stats.sampleSendAttribution(stats.eventSendAttribution, "Workspace.A", 1, 10, 0);
+	stats.sampleSendAttribution(stats.eventSendAttribution, "Workspace.B", 1, 10, 0);
+	stats.sampleSendAttribution(stats.eventSendAttribution, "Workspace.C", 1, 10, 0);
+	stats.sampleSendAttribution(stats.eventSendAttribution, "Workspace.A", 1, 10, 0);
+
+	BOOST_CHECK_EQUAL(stats.eventSendAttribution.size(), 3u);
+	BOOST_CHECK(stats.eventSendAttribution.count("Workspace.A"));
+	BOOST_CHECK(stats.eventSendAttribution.count("Other"));
+	BOOST_CHECK(!stats.eventSendAttribution.count("Workspace.C"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/SendRateController.h"
+#include "FastLog.h"
+
+DYNAMIC_FASTINT(SendRateControllerMinPercent)
+
+using namespace RBX;
+using namespace RBX::Network;
+
+BOOST_AUTO_TEST_SUITE(SendRateControllerTest)
+
+BOOST_AUTO_TEST_CASE(BacksOffOncePerRoundTripAndRecovers)
+{
+	SendRateController controller;
+	Time now = Time::nowFast();
+
+	controller.update(1.0, 0.0f, 100, 100, now);
+	BOOST_CHECK(!controller.isCongested());
+	BOOST_CHECK_EQUAL(controller.getScale(), 1.0f);
+
+	// Buffer growing
+	controller.update(0.0, 0.0f, 100, 100, now);
+	BOOST_CHECK(controller.isCongested());
+	const float backedOff = controller.getScale();
+	BOOST_CHECK_LT(backedOff, 1.0f);
+
+	// Not again within the same round trip
+	now += Time::Interval(0.05);
+	controller.update(0.0, 0.0f, 100, 100, now);
+	BOOST_CHECK_EQUAL(controller.getScale(), backedOff);
+
+	// Loss and ping spikes count as congestion too
+	now += Time::Interval(0.2);
+	controller.update(1.0, 0.5f, 100, 100, now);
+	BOOST_CHECK_LT(controller.getScale(), backedOff);
+
+	now += Time::Interval(0.5);
+	const float beforePing = controller.getScale();
+	controller.update(1.0, 0.0f, 400, 100, now);
+	BOOST_CHECK_LT(controller.getScale(), beforePing);
+
+	// Recovers gradually once the connection is healthy
+	const float lowest = controller.getScale();
+	BOOST_CHECK_GE(lowest, DFInt::SendRateControllerMinPercent / 100.0f);
+
+	now += Time::Interval(0.5);
+	controller.update(1.0, 0.0f, 100, 100, now);
+	BOOST_CHECK(!controller.isCongested());
+	BOOST_CHECK_GT(controller.getScale(), lowest);
+	BOOST_CHECK_LT(controller.getScale(), 1.0f);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		now += Time::Interval(1.0);
+		controller.update(1.0, 0.0f, 100, 100, now);
+	}
+	BOOST_CHECK_EQUAL(controller.getScale(), 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(NeverDropsBelowMinimum)
+{
+	SendRateController controller;
+	Time now = Time::nowFast();
+
+	for (int i = 0; i < 50; ++i)
+	{
+		now += Time::Interval(1.0);
+		controller.update(0.0, 1.0f, 100, 100, now);
+	}
+	BOOST_CHECK_CLOSE(controller.getScale(), DFInt::SendRateControllerMinPercent / 100.0f, 0.01f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
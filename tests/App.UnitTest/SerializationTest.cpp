@@ -17,8 +17,19 @@
 #include <v8tree/Instance.h>
 #include <v8datamodel/PartInstance.h>
 
+#include <util/ScopedAssign.h>
+
+#include <climits>
+#include <limits>
+
+#include <lz4.h>
+#include <lz4hc.h>
+
 #include "rbx/test/DataModelFixture.h"
 
+DYNAMIC_FASTINT(SerializerBinaryDecodeThreads)
+DYNAMIC_FASTINT(SerializerBinaryParallelMinKB)
+
 using namespace RBX;
 
 extern const char* const sSerializationTestInstance = "SerializationTestInstance";
@@ -196,14 +207,12 @@ BOOST_AUTO_TEST_CASE(SerializationReplicationTest)
 	}
 }
 
-BOOST_AUTO_TEST_CASE(RoundtripBinary)
+static std::vector<shared_ptr<SerializationTestInstance> > createRandomTree(G3D::Random& rng, size_t count = 1000)
 {
-	G3D::Random rng(42);
-	
 	std::vector<shared_ptr<SerializationTestInstance> > instances;
 	instances.push_back(SerializationTestInstance::createInstance(&rng));
 	
-	for (size_t i = 0; i < 1000; ++i)
+	for (size_t i = 0; i < count; ++i)
 	{
 		shared_ptr<SerializationTestInstance> instance = SerializationTestInstance::createInstance(&rng);
 		
@@ -219,6 +228,15 @@ BOOST_AUTO_TEST_CASE(RoundtripBinary)
 			instances[i]->prop19 = instances[rng.integer(1, instances.size() - 1)].get();
 		}
 	}
+
+	return instances;
+}
+
+BOOST_AUTO_TEST_CASE(RoundtripBinary)
+{
+	G3D::Random rng(42);
+	
+	std::vector<shared_ptr<SerializationTestInstance> > instances = createRandomTree(rng);
 	
 	std::string binaryDataOriginal = getBinaryRepresentation(instances[0].get());
 	
@@ -232,4 +250,206 @@ BOOST_AUTO_TEST_CASE(RoundtripBinary)
 	BOOST_CHECK_EQUAL(binaryDataOriginal, binaryDataNew);
 }
 
+BOOST_AUTO_TEST_CASE(RoundtripBinaryParallelDecode)
+{
+	ScopedFastFlagSetting parallelDecode("SerializerBinaryParallelDecode", true);
+
+	// The test tree is well under the size that starts helpers by default
+	ScopedAssign<int> parallelMinKB(DFInt::SerializerBinaryParallelMinKB, 0);
+	ScopedAssign<int> decodeThreads(DFInt::SerializerBinaryDecodeThreads, 3);
+
+	G3D::Random rng(42);
+	
+	std::vector<shared_ptr<SerializationTestInstance> > instances = createRandomTree(rng);
+	
+	std::string binaryDataOriginal = getBinaryRepresentation(instances[0].get());
+	
+	shared_ptr<Instance> newRoot = SerializationTestInstance::createInstance(&rng);
+	
+	int helperThreadsStarted = SerializerBinary::getHelperThreadsStarted();
+
+	SerializerBinary::deserialize(binaryDataOriginal.data(), binaryDataOriginal.size(), newRoot.get());
+
+	BOOST_CHECK_GT(SerializerBinary::getHelperThreadsStarted(), helperThreadsStarted);
+	
+	std::string binaryDataNew = getBinaryRepresentation(newRoot.get());
+	
+	BOOST_CHECK_EQUAL(binaryDataOriginal, binaryDataNew);
+
+	// A truncated file is rejected before any instance is created
+	shared_ptr<Instance> truncatedRoot = SerializationTestInstance::createInstance(&rng);
+
+	BOOST_CHECK_THROW(SerializerBinary::deserialize(binaryDataOriginal.data(), binaryDataOriginal.size() / 2, truncatedRoot.get()), std::runtime_error);
+	BOOST_CHECK(!truncatedRoot->getChildren() || truncatedRoot->getChildren()->empty());
+}
+
+BOOST_AUTO_TEST_CASE(ParallelCompressMatchesSerial)
+{
+	G3D::Random rng(42);
+	
+	std::vector<shared_ptr<SerializationTestInstance> > instances = createRandomTree(rng);
+	
+	std::string binaryDataSerial = getBinaryRepresentation(instances[0].get());
+
+	{
+		ScopedFastFlagSetting parallelCompress("SerializerBinaryParallelCompress", true);
+
+		// The test tree is well under the size that starts helpers by default
+		ScopedAssign<int> parallelMinKB(DFInt::SerializerBinaryParallelMinKB, 0);
+		ScopedAssign<int> decodeThreads(DFInt::SerializerBinaryDecodeThreads, 3);
+
+		int helperThreadsStarted = SerializerBinary::getHelperThreadsStarted();
+
+		BOOST_CHECK_EQUAL(binaryDataSerial, getBinaryRepresentation(instances[0].get()));
+		BOOST_CHECK_GT(SerializerBinary::getHelperThreadsStarted(), helperThreadsStarted);
+	}
+}
+
+// Mirrors the file and chunk headers in SerializerBinary.cpp
+struct TestChunkHeader
+{
+	char name[4];
+	unsigned int compressedSize;
+	unsigned int size;
+	unsigned int reserved;
+};
+
+static const size_t kTestFileHeaderSize = 32;
+
+BOOST_AUTO_TEST_CASE(AdaptiveCompressionUsesHighCompressionForSmallChunks)
+{
+	G3D::Random rng(42);
+
+	// Enough instances that the name chunk is past the 64KB adaptive limit while the bool chunks stay
+	// under it. Names that share a prefix compress differently with LZ4 and LZ4HC.
+	std::vector<shared_ptr<SerializationTestInstance> > instances = createRandomTree(rng, 8000);
+	for (size_t i = 0; i < instances.size(); ++i)
+		instances[i]->setName(RBX::format("Part%d", (int)i));
+
+	std::stringstream adaptiveStream;
+	SerializerBinary::serialize(adaptiveStream, instances[0].get(), SerializerBinary::sfAdaptiveCompression);
+	std::string adaptive = adaptiveStream.str();
+
+	// Same content as a default save
+	shared_ptr<Instance> newRoot = SerializationTestInstance::createInstance(&rng);
+	SerializerBinary::deserialize(adaptive.data(), adaptive.size(), newRoot.get());
+	BOOST_CHECK_EQUAL(getBinaryRepresentation(instances[0].get()), getBinaryRepresentation(newRoot.get()));
+
+	int smallChunks = 0;
+	int largeChunks = 0;
+
+	for (size_t offset = kTestFileHeaderSize; offset < adaptive.size(); )
+	{
+		TestChunkHeader header;
+		BOOST_REQUIRE_LE(offset + sizeof(header), adaptive.size());
+		memcpy(&header, adaptive.data() + offset, sizeof(header));
+		offset += sizeof(header);
+
+		size_t payloadSize = header.compressedSize ? header.compressedSize : header.size;
+		BOOST_REQUIRE_LE(offset + payloadSize, adaptive.size());
+
+		if (header.compressedSize && header.size)
+		{
+			std::vector<char> data(header.size);
+			BOOST_REQUIRE_EQUAL(LZ4_decompress_safe(adaptive.data() + offset, &data[0], header.compressedSize, header.size), (int)header.size);
+
+			std::vector<char> high(LZ4_compressBound(header.size));
+			high.resize(LZ4_compressHC(&data[0], &high[0], header.size));
+
+			std::vector<char> fast(LZ4_compressBound(header.size));
+			fast.resize(LZ4_compress(&data[0], &fast[0], header.size));
+
+			std::vector<char> written(adaptive.data() + offset, adaptive.data() + offset + header.compressedSize);
+
+			// Only chunks where the two differ tell which one was used
+			if (high != fast)
+			{
+				if (header.size <= 64 * 1024)
+				{
+					BOOST_CHECK(written == high);
+					smallChunks++;
+				}
+				else
+				{
+					BOOST_CHECK(written == fast);
+					largeChunks++;
+				}
+			}
+		}
+
+		offset += payloadSize;
+	}
+
+	BOOST_CHECK_GT(smallChunks, 0);
+	BOOST_CHECK_GT(largeChunks, 0);
+}
+
+BOOST_AUTO_TEST_CASE(PlanesFormat)
+{
+	// Zigzag ints and sign-last floats, most significant byte plane first
+	std::vector<int> ints;
+	ints.push_back(-1);
+	ints.push_back(1);
+	ints.push_back(256);
+
+	BOOST_CHECK(SerializerBinary::encodeIntPlanes(ints) == std::string("\0\0\0" "\0\0\0" "\0\0\x02" "\x01\x02\0", 12));
+
+	std::vector<float> floats;
+	floats.push_back(1.0f);
+	floats.push_back(-2.0f);
+
+	BOOST_CHECK(SerializerBinary::encodeFloatPlanes(floats) == std::string("\x7f\x80" "\0\0" "\0\0" "\0\x01", 8));
+}
+
+BOOST_AUTO_TEST_CASE(SIMDPlanesMatchScalarPlanes)
+{
+	G3D::Random rng(42);
+
+	// Around the 16 value blocks, so both the blocks and the scalar tail are covered
+	static const size_t counts[] = { 0, 15, 16, 17, 33 };
+
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+	{
+		std::vector<int> ints;
+		std::vector<float> floats;
+
+		for (size_t i = 0; i < counts[c]; ++i)
+		{
+			ints.push_back(i % 2 ? rng.integer(-1000, 1000) : (int)rng.bits());
+			floats.push_back(rng.uniform(-1e5, 1e5));
+		}
+
+		// Values at the edges of the transforms, wherever the count puts them
+		if (counts[c] > 5)
+		{
+			ints[1] = INT_MIN;
+			ints[2] = INT_MAX;
+			ints[3] = -1;
+			floats[1] = -0.0f;
+			floats[2] = -std::numeric_limits<float>::infinity();
+			floats[3] = std::numeric_limits<float>::denorm_min();
+		}
+
+		std::string scalarInts, scalarFloats;
+		{
+			ScopedFastFlagSetting simdPlanes("SerializerBinarySIMDPlanes", false);
+
+			scalarInts = SerializerBinary::encodeIntPlanes(ints);
+			scalarFloats = SerializerBinary::encodeFloatPlanes(floats);
+		}
+
+		ScopedFastFlagSetting simdPlanes("SerializerBinarySIMDPlanes", true);
+
+		BOOST_CHECK_MESSAGE(SerializerBinary::encodeIntPlanes(ints) == scalarInts, "int planes differ for " << counts[c] << " values");
+		BOOST_CHECK_MESSAGE(SerializerBinary::encodeFloatPlanes(floats) == scalarFloats, "float planes differ for " << counts[c] << " values");
+
+		BOOST_CHECK(SerializerBinary::decodeIntPlanes(scalarInts) == ints);
+
+		// Compare the bits, -0 equals 0 as a float
+		std::vector<float> decodedFloats = SerializerBinary::decodeFloatPlanes(scalarFloats);
+		BOOST_REQUIRE_EQUAL(decodedFloats.size(), floats.size());
+		BOOST_CHECK(floats.empty() || memcmp(&decodedFloats[0], &floats[0], floats.size() * sizeof(float)) == 0);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+
+#include "voxel2/Grid.h"
+#include "voxel2/Mesher.h"
+#include "voxel2/MaterialTable.h"
+#include "util/ScopedAssign.h"
+
+FASTINT(SmoothTerrainMesherThreads)
+
+using namespace RBX;
+
+static Voxel2::Box createSphereBox(int size, unsigned char material)
+{
+	Voxel2::Box box(size, size, size);
+
+	float radius = size * 0.35f;
+	Vector3 center = Vector3(size, size, size) * 0.5f;
+
+	for (int y = 0; y < size; ++y)
+		for (int z = 0; z < size; ++z)
+			for (int x = 0; x < size; ++x)
+			{
+				float distance = (Vector3(x, y, z) - center).length();
+
+				if (distance < radius)
+					box.set(x, y, z, Voxel2::Cell(material, Voxel2::Cell::Occupancy_Max));
+				else if (distance < radius + 1)
+					box.set(x, y, z, Voxel2::Cell(material, (unsigned char)((radius + 1 - distance) * Voxel2::Cell::Occupancy_Max)));
+			}
+
+	return box;
+}
+
+static bool isSameMesh(const Voxel2::Mesher::BasicMesh& lhs, const Voxel2::Mesher::BasicMesh& rhs)
+{
+	if (lhs.vertices.size() != rhs.vertices.size() || lhs.indices != rhs.indices)
+		return false;
+
+	for (size_t i = 0; i < lhs.vertices.size(); ++i)
+	{
+		const Voxel2::Mesher::Vertex& l = lhs.vertices[i];
+		const Voxel2::Mesher::Vertex& r = rhs.vertices[i];
+
+		if (l.position != r.position || l.border != r.border || l.material != r.material || l.seed != r.seed)
+			return false;
+	}
+
+	return true;
+}
+
+BOOST_AUTO_TEST_SUITE( SmoothTerrainMesher )
+
+BOOST_AUTO_TEST_CASE( GeometryCacheReusesUnchangedBoxes )
+{
+	Voxel2::Mesher::prepareTables();
+
+	Voxel2::MaterialTable materials("", Voxel2::Cell::Material_Max + 1);
+	Voxel2::Mesher::Options options = { &materials, /* generateWater= */ true };
+
+	Voxel2::Mesher::GeometryCache cache(16 * 1024 * 1024);
+
+	Voxel2::Box box = createSphereBox(20, 2);
+	Vector3int32 offset(32, 0, -16);
+
+	shared_ptr<const Voxel2::Mesher::BasicMesh> first = cache.generateGeometry(box, offset, 0, options);
+	BOOST_REQUIRE(!first->indices.empty());
+	BOOST_CHECK(isSameMesh(*first, Voxel2::Mesher::generateGeometry(box, offset, 0, options)));
+
+	// Same cells in a different box object hit the cache
+	shared_ptr<const Voxel2::Mesher::BasicMesh> second = cache.generateGeometry(box.clone(), offset, 0, options);
+	BOOST_CHECK(first == second);
+	BOOST_CHECK_EQUAL(cache.getHitCount(), 1u);
+
+	// Position and lod are part of the key since vertex positions and seeds depend on them
+	BOOST_CHECK(cache.generateGeometry(box, offset + Vector3int32(1, 0, 0), 0, options) != first);
+	BOOST_CHECK(cache.generateGeometry(box, offset, 1, options) != first);
+
+	// Writing to the box after the fact must not change what the cache matches against
+	Voxel2::Box edited = box.clone();
+	edited.set(10, 10, 10, Voxel2::Cell());
+
+	shared_ptr<const Voxel2::Mesher::BasicMesh> third = cache.generateGeometry(edited, offset, 0, options);
+	BOOST_CHECK(third != first);
+	BOOST_CHECK(isSameMesh(*third, Voxel2::Mesher::generateGeometry(edited, offset, 0, options)));
+
+	box.set(10, 10, 10, Voxel2::Cell());
+	BOOST_CHECK(cache.generateGeometry(box, offset, 0, options) == third);
+}
+
+BOOST_AUTO_TEST_CASE( GeometryCacheStaysWithinMemoryLimit )
+{
+	Voxel2::Mesher::prepareTables();
+
+	Voxel2::MaterialTable materials("", Voxel2::Cell::Material_Max + 1);
+	Voxel2::Mesher::Options options = { &materials, /* generateWater= */ true };
+
+	Voxel2::Mesher::GeometryCache cache(256 * 1024);
+
+	Voxel2::Box box = createSphereBox(20, 2);
+
+	for (int i = 0; i < 32; ++i)
+		cache.generateGeometry(box, Vector3int32(i * 16, 0, 0), 0, options);
+
+	BOOST_CHECK(cache.getMemorySize() <= 256 * 1024);
+	BOOST_CHECK_EQUAL(cache.getHitCount(), 0u);
+
+	// The most recent one is still there
+	shared_ptr<const Voxel2::Mesher::BasicMesh> last = cache.generateGeometry(box, Vector3int32(31 * 16, 0, 0), 0, options);
+	BOOST_CHECK_EQUAL(cache.getHitCount(), 1u);
+
+	cache.clear();
+	BOOST_CHECK_EQUAL(cache.getMemorySize(), 0u);
+	BOOST_CHECK(cache.generateGeometry(box, Vector3int32(31 * 16, 0, 0), 0, options) != last);
+}
+
+BOOST_AUTO_TEST_CASE( BatchMatchesSerialMeshing )
+{
+	Voxel2::Mesher::prepareTables();
+
+	Voxel2::MaterialTable materials("", Voxel2::Cell::Material_Max + 1);
+	Voxel2::Mesher::Options options = { &materials, /* generateWater= */ true };
+
+	ScopedAssign<int> threads(FInt::SmoothTerrainMesherThreads, 3);
+
+	Voxel2::Mesher::GeometryCache cache(16 * 1024 * 1024);
+
+	std::vector<Voxel2::Box> boxes;
+
+	for (int i = 0; i < 24; ++i)
+		boxes.push_back(createSphereBox(12 + i % 10, 1 + i % 5));
+
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		Voxel2::Mesher::Batch batch(pass == 0 ? NULL : &cache, options);
+
+		for (size_t i = 0; i < boxes.size(); ++i)
+			BOOST_CHECK_EQUAL(batch.add(boxes[i], Vector3int32(i * 32, 0, 0), 0), i);
+
+		batch.run();
+
+		BOOST_REQUIRE_EQUAL(batch.size(), boxes.size());
+
+		for (size_t i = 0; i < boxes.size(); ++i)
+			BOOST_CHECK(isSameMesh(*batch.getResult(i), Voxel2::Mesher::generateGeometry(boxes[i], Vector3int32(i * 32, 0, 0), 0, options)));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include "boost/pool/poolfwd.hpp"
 #include "v8datamodel/Filters.h"
 #include "v8world/SpatialHashMultiRes.h"
+#include "util/WorkStealingPool.h"
 
 #include "boost/intrusive/list.hpp"
 #include <boost/unordered_map.hpp>
@@ -394,4 +395,63 @@ BOOST_AUTO_TEST_CASE( RandomBlast )
 
 }
 
+typedef std::set<std::pair<size_t, size_t> > ContactIndexSet;
+
+// Moves the primitives around a few times and returns the resulting contacts, as pairs of primitive indices
+static ContactIndexSet MoveRandomly(const std::vector<std::vector<Extents> >& rounds, WorkStealingPool* pool)
+{
+	ContactMan cm;
+	std::vector<Prim> prims;
+	prims.reserve(rounds[0].size());
+
+	SH sh(NULL, &cm, SH_TEST_MAX_CELLS_PER_PRIMITIVE);
+
+	std::vector<Prim*> moved;
+	for (size_t i = 0; i < rounds[0].size(); ++i)
+	{
+		prims.push_back(Prim(&cm, rounds[0][i]));
+		sh.onPrimitiveAdded(&prims[i]);
+		moved.push_back(&prims[i]);
+	}
+
+	for (size_t r = 1; r < rounds.size(); ++r)
+	{
+		for (size_t i = 0; i < prims.size(); ++i)
+			prims[i].fuzzyExtents = rounds[r][i];
+
+		if (pool)
+			sh.onPrimitivesExtentsChanged(moved, pool, pool->getWorkerCount() + 1);
+		else
+			for (size_t i = 0; i < prims.size(); ++i)
+				sh.onPrimitiveExtentsChanged(&prims[i]);
+	}
+
+	ContactIndexSet result;
+	for (ContactMap::iterator it = cm.contacts.begin(); it != cm.contacts.end(); ++it)
+		result.insert(std::make_pair(it->first - &prims[0], it->second - &prims[0]));
+
+	for (size_t i = 0; i < prims.size(); ++i)
+		sh.onPrimitiveRemoved(&prims[i]);
+
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( BatchedExtentsChangedMatchesSerial )
+{
+	srand(1234);
+
+	std::vector<std::vector<Extents> > rounds(4);
+	for (size_t r = 0; r < rounds.size(); ++r)
+		for (size_t i = 0; i < 500; ++i)
+			rounds[r].push_back(RandomExtent(20, -200, 200));
+
+	ContactIndexSet serial = MoveRandomly(rounds, NULL);
+
+	WorkStealingPool pool(3);
+	ContactIndexSet batched = MoveRandomly(rounds, &pool);
+
+	BOOST_CHECK(!serial.empty());
+	BOOST_CHECK(serial == batched);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
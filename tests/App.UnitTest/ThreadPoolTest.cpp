@@ -3,6 +3,7 @@
 #include <boost/thread.hpp>
 
 #include "util/ThreadPool.h"
+#include "util/WorkStealingPool.h"
 
 using namespace RBX;
 
@@ -44,4 +45,32 @@ BOOST_AUTO_TEST_CASE( ThreadPoolUnlimitedScheduleTest )
 	BOOST_CHECK_EQUAL(true, success);
 }
 
+BOOST_AUTO_TEST_CASE( WorkStealingPoolVisitsEveryIndexOnceTest )
+{
+	WorkStealingPool pool(3);
+	for (size_t count = 0; count < 1000; count += 37)
+	{
+		std::vector<int> visits(count, 0);
+		pool.parallelFor(count, 5, [&visits](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				visits[i]++;
+		});
+
+		BOOST_CHECK_EQUAL(count, (size_t)std::count(visits.begin(), visits.end(), 1));
+	}
+}
+
+BOOST_AUTO_TEST_CASE( WorkStealingPoolSingleParticipantTest )
+{
+	WorkStealingPool pool(2);
+	boost::thread::id caller = boost::this_thread::get_id();
+	bool onCaller = true;
+	pool.parallelFor(100, 1, [&](size_t, size_t)
+	{
+		onCaller = onCaller && boost::this_thread::get_id() == caller;
+	}, 1);
+	BOOST_CHECK(onCaller);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
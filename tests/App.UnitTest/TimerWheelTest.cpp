@@ -0,0 +1,87 @@
+#include <boost/test/unit_test.hpp>
+
+#include "util/TimerWheel.h"
+
+#include <map>
+
+using namespace RBX;
+
+BOOST_AUTO_TEST_SUITE(TimerWheelTest)
+
+BOOST_AUTO_TEST_CASE(ExpiresOnlyDueValuesInOrder)
+{
+	const Time start = Time::now<Time::Precise>();
+	TimerWheel<int> wheel(start, Time::Interval(0.01));
+
+	wheel.insert(start + Time::Interval(0.5), 2);
+	wheel.insert(start + Time::Interval(0.005), 1);
+	wheel.insert(start + Time::Interval(30.0), 3);	// past the first level
+	wheel.insert(start + Time::Interval(1e7), 4);	// past the whole wheel
+	BOOST_CHECK_EQUAL(wheel.size(), 4u);
+
+	TimerWheel<int>::Entries expired;
+	wheel.advance(start + Time::Interval(0.001), expired);
+	BOOST_CHECK(expired.empty());
+
+	wheel.advance(start + Time::Interval(0.5), expired);
+	BOOST_REQUIRE_EQUAL(expired.size(), 2u);
+	BOOST_CHECK_EQUAL(expired[0].value, 1);
+	BOOST_CHECK_EQUAL(expired[1].value, 2);
+
+	expired.clear();
+	wheel.advance(start + Time::Interval(29.99), expired);
+	BOOST_CHECK(expired.empty());
+	wheel.advance(start + Time::Interval(30.0), expired);
+	BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+	BOOST_CHECK_EQUAL(expired[0].value, 3);
+	BOOST_CHECK_EQUAL(wheel.size(), 1u);
+
+	// Values due in the past come out on the next advance
+	expired.clear();
+	wheel.insert(start, 5);
+	wheel.advance(start + Time::Interval(30.0), expired);
+	BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+	BOOST_CHECK_EQUAL(expired[0].value, 5);
+}
+
+BOOST_AUTO_TEST_CASE(MatchesSortedReference)
+{
+	const Time start = Time::now<Time::Precise>();
+	TimerWheel<int> wheel(start, Time::Interval(0.01));
+	std::multimap<double, int> reference;
+
+	srand(7);
+	double now = 0;
+	int id = 0;
+	for (int step = 0; step < 20000; ++step)
+	{
+		for (int i = rand() % 4; i > 0; --i)
+		{
+			const double delay = (rand() % 4 == 0) ? (rand() % 30000) / 10.0 : (rand() % 1000) / 1000.0;
+			const Time due = start + Time::Interval(now + delay);
+			wheel.insert(due, id);
+			reference.insert(std::make_pair((due - start).seconds(), id));
+			++id;
+		}
+
+		now += (rand() % 40) / 1000.0;
+		const Time nowTime = start + Time::Interval(now);
+
+		TimerWheel<int>::Entries expired;
+		wheel.advance(nowTime, expired);
+
+		size_t expected = 0;
+		while (!reference.empty() && reference.begin()->first <= (nowTime - start).seconds())
+		{
+			reference.erase(reference.begin());
+			++expected;
+		}
+
+		BOOST_REQUIRE_EQUAL(expired.size(), expected);
+		for (size_t i = 1; i < expired.size(); ++i)
+			BOOST_REQUIRE(!(expired[i].due < expired[i - 1].due));
+		BOOST_REQUIRE_EQUAL(wheel.size(), reference.size());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+#include <boost/test/unit_test.hpp>
+
+#include "network/TopNErrorsPhysicsSender.h"
+#include "network/Server.h"
+#include "network/ServerReplicator.h"
+#include "security/SecurityContext.h"
+#include "v8datamodel/BasicPartInstance.h"
+#include "v8datamodel/ModelInstance.h"
+#include "util/ScopedAssign.h"
+#include "BitStream.h"
+
+DYNAMIC_FASTINT(PhysicsSenderInterestNearDistance)
+DYNAMIC_FASTINT(PhysicsSenderInterestFarDistance)
+DYNAMIC_FASTINT(PhysicsSenderInterestCullDistance)
+DYNAMIC_FASTINT(PhysicsSenderInterestNearIntervalMs)
+DYNAMIC_FASTINT(PhysicsSenderInterestFarIntervalMs)
+
+using namespace RBX;
+using namespace RBX::Network;
+
+struct TopNErrorsPhysicsSenderTestWrapper
+{
+	shared_ptr<Server> server;
+	shared_ptr<Replicator> replicator;
+	shared_ptr<TopNErrorsPhysicsSender> sender;
+	shared_ptr<ModelInstance> character;
+	TopNErrorsPhysicsSender::Nugget* nugget;
+
+	TopNErrorsPhysicsSenderTestWrapper()
+		: nugget(NULL)
+	{
+		Security::Impersonator impersonate(Security::CmdLine_);
+
+		server = Creatable<Instance>::create<Server>();
+		replicator = Creatable<Instance>::create<ServerReplicator>(RakNet::SystemAddress(), server.get(), &NetworkSettings::singleton());
+		sender.reset(new TopNErrorsPhysicsSender(*replicator));
+		character = Creatable<Instance>::create<ModelInstance>();
+	}
+
+	// Whether a part this far from the character is skipped when it was last sent sinceLastSend ago
+	bool isOutOfInterest(float distance, double sinceLastSend)
+	{
+		shared_ptr<BasicPartInstance> part = Creatable<Instance>::create<BasicPartInstance>();
+		part->setCoordinateFrame(CoordinateFrame(Vector3(distance, 0, 0)));
+
+		TopNErrorsPhysicsSender::Nugget nugget(part);
+
+		sender->currentStepTimestamp = Time::now<Time::Fast>();
+		nugget.lastSendTime = sender->currentStepTimestamp - Time::Interval(sinceLastSend);
+
+		// Not a multiple of 20, so the assembly (which a part outside a world doesn't have) is not looked at
+		nugget.computeError(CoordinateFrame(), character.get(), 1, sender.get());
+
+		return nugget.outOfInterest;
+	}
+
+	void addNugget(shared_ptr<PartInstance> part)
+	{
+		sender->addNugget2(part);
+		nugget = &sender->nuggetMap.find(part)->second;
+	}
+
+	// Writes the nugget's translation the way sendPhysicsData does, in a packet of its own. Returns whether it went out as a delta.
+	bool sendTranslation(const Vector3& translation, uint32_t receipt)
+	{
+		RakNet::BitStream bitStream;
+
+		sender->sendingNugget = nugget;
+		sender->writeTranslationKeyframe(bitStream, translation, Compressor::RAKNET_COMPRESSED);
+		sender->sendingNugget = NULL;
+		nugget->nextGeneration++;
+
+		sender->sentPackets.push_back(TopNErrorsPhysicsSender::SentPacket());
+		sender->sentPackets.back().receipt = receipt;
+		sender->sentPackets.back().translations.swap(sender->packetTranslations);
+
+		return sender->deltaTranslation;
+	}
+
+	void receiveReceipt(uint32_t receipt, bool acked)
+	{
+		Replicator::PhysicsSendReceipt sendReceipt = { receipt, acked };
+		replicator->physicsSendReceipts.push(sendReceipt);
+		sender->processSendReceipts();
+	}
+};
+
+BOOST_AUTO_TEST_SUITE(TopNErrorsPhysicsSenderTest)
+
+BOOST_AUTO_TEST_CASE(InterestTiersByDistance)
+{
+	// Far and cull past the 1000 stud error clamp, as on a large map
+	ScopedAssign<int> nearDistance(DFInt::PhysicsSenderInterestNearDistance, 200);
+	ScopedAssign<int> farDistance(DFInt::PhysicsSenderInterestFarDistance, 1500);
+	ScopedAssign<int> cullDistance(DFInt::PhysicsSenderInterestCullDistance, 3000);
+	ScopedAssign<int> nearInterval(DFInt::PhysicsSenderInterestNearIntervalMs, 100);
+	ScopedAssign<int> farInterval(DFInt::PhysicsSenderInterestFarIntervalMs, 500);
+
+	TopNErrorsPhysicsSenderTestWrapper wrapper;
+
+	// Inside the near distance every step goes out
+	BOOST_CHECK(!wrapper.isOutOfInterest(100, 0.0));
+
+	// Near tier
+	BOOST_CHECK(wrapper.isOutOfInterest(1200, 0.05));
+	BOOST_CHECK(!wrapper.isOutOfInterest(1200, 0.2));
+
+	// Far tier
+	BOOST_CHECK(wrapper.isOutOfInterest(2000, 0.2));
+	BOOST_CHECK(!wrapper.isOutOfInterest(2000, 0.6));
+
+	// Culled however long ago it was sent
+	BOOST_CHECK(wrapper.isOutOfInterest(4000, 10.0));
+}
+
+BOOST_AUTO_TEST_CASE(DeltaTranslationOnlyReferencesFullKeyframes)
+{
+	TopNErrorsPhysicsSenderTestWrapper wrapper;
+
+	shared_ptr<BasicPartInstance> part = Creatable<Instance>::create<BasicPartInstance>();
+	wrapper.addNugget(part);
+
+	uint32_t receipt = 0;
+	Vector3 translation(100, 10, 100);
+
+	// Nothing acked yet
+	BOOST_CHECK(!wrapper.sendTranslation(translation, ++receipt));
+	wrapper.receiveReceipt(receipt, true);
+	BOOST_CHECK(wrapper.nugget->hasAckedTranslation);
+	BOOST_CHECK_EQUAL((int)wrapper.nugget->ackedGeneration, 0);
+
+	// The datagrams carrying these deltas are acked, but say the client dropped the first one (a part it had not
+	// streamed in yet, or an out of order delta). Later deltas must not be chained onto it.
+	for (int generation = 1; generation < Compressor::deltaTranslationHistorySize; ++generation)
+	{
+		translation.x += 0.5f;
+		BOOST_CHECK(wrapper.sendTranslation(translation, ++receipt));
+		wrapper.receiveReceipt(receipt, true);
+		BOOST_CHECK_EQUAL((int)wrapper.nugget->ackedGeneration, 0);
+	}
+
+	// The full translation has left the client's history, so a new one goes out and becomes the reference
+	translation.x += 0.5f;
+	BOOST_CHECK(!wrapper.sendTranslation(translation, ++receipt));
+	wrapper.receiveReceipt(receipt, true);
+	BOOST_CHECK_EQUAL((int)wrapper.nugget->ackedGeneration, Compressor::deltaTranslationHistorySize);
+
+	translation.x += 0.5f;
+	BOOST_CHECK(wrapper.sendTranslation(translation, ++receipt));
+
+	// A lost packet falls back to full translations until one is acked
+	wrapper.receiveReceipt(receipt, false);
+	BOOST_CHECK(!wrapper.nugget->hasAckedTranslation);
+
+	uint32_t olderReceipt = ++receipt;
+	BOOST_CHECK(!wrapper.sendTranslation(translation, olderReceipt));
+	uint32_t newerReceipt = ++receipt;
+	BOOST_CHECK(!wrapper.sendTranslation(translation, newerReceipt));
+
+	// Receipts can come back out of order, a late ack doesn't replace a newer reference
+	wrapper.receiveReceipt(newerReceipt, true);
+	wrapper.receiveReceipt(olderReceipt, true);
+	BOOST_CHECK_EQUAL((int)wrapper.nugget->ackedGeneration, Compressor::deltaTranslationHistorySize + 3);
+	BOOST_CHECK(wrapper.sendTranslation(translation, ++receipt));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
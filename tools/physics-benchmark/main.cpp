@@ -0,0 +1,290 @@
+// Steps the physics of a place or model with no rendering, networking or scripts and reports
+// where the time went. The state hash printed at the end only depends on the simulation, so
+// two runs with the same arguments should print the same hash; if they don't, something in
+// the step is not deterministic.
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "FastLog.h"
+#include "rbx/rbxTime.h"
+#include "rbx/TaskScheduler.h"
+#include "network/api.h"
+#include "util/Profiling.h"
+#include "util/standardout.h"
+#include "v8datamodel/DataModel.h"
+#include "v8datamodel/DebugSettings.h"
+#include "v8datamodel/factoryregistration.h"
+#include "v8datamodel/GameSettings.h"
+#include "v8datamodel/PhysicsSettings.h"
+#include "v8datamodel/Workspace.h"
+#include "v8kernel/Constants.h"
+#include "v8world/Primitive.h"
+#include "v8world/World.h"
+#include "v8xml/Serializer.h"
+
+namespace
+{
+	const char* usage =
+		"PhysicsBenchmark - steps the physics of a place without rendering or networking\n"
+		"\n"
+		"Usage:\n"
+		"  PhysicsBenchmark <file.rbxl|file.rbxm> [options]\n"
+		"\n"
+		"Options:\n"
+		"  --steps N           world steps to measure (default 2400)\n"
+		"  --warmup N          world steps to run before measuring (default 0)\n"
+		"  --threads N         threads handed to the world step (default 1)\n"
+		"  --flag Name=Value   set a fast flag before loading, may be repeated\n"
+		"  --help              this help message\n";
+
+	struct Options
+	{
+		std::string file;
+		int steps;
+		int warmup;
+		int threads;
+		std::vector<std::string> flags;
+
+		Options()
+			:steps(2400)
+			,warmup(0)
+			,threads(1)
+		{}
+	};
+
+	void onMessageOut(const RBX::StandardOutMessage& message)
+	{
+		std::cerr << message.message << std::endl;
+	}
+
+	bool parseArguments(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (arg == "--help")
+				return false;
+			else if (arg == "--steps" && hasValue)
+				options.steps = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--warmup" && hasValue)
+				options.warmup = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--threads" && hasValue)
+				options.threads = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--flag" && hasValue)
+				options.flags.push_back(argv[++i]);
+			else if (!boost::starts_with(arg, "--") && options.file.empty())
+				options.file = arg;
+			else
+			{
+				std::cerr << "Unknown argument " << arg << std::endl;
+				return false;
+			}
+		}
+
+		return !options.file.empty() && options.steps > 0 && options.warmup >= 0 && options.threads > 0;
+	}
+
+	bool applyFlags(const std::vector<std::string>& flags)
+	{
+		for (size_t i = 0; i < flags.size(); ++i)
+		{
+			std::string::size_type equals = flags[i].find('=');
+			if (equals == std::string::npos || !FLog::SetValue(flags[i].substr(0, equals), flags[i].substr(equals + 1)))
+			{
+				std::cerr << "Could not set flag " << flags[i] << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool loadFile(const std::string& fileName, RBX::DataModel* dataModel)
+	{
+		std::ifstream stream(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+		if (!stream)
+			return false;
+
+		RBX::Security::Impersonator impersonate(RBX::Security::COM);
+		Serializer serializer;
+
+		if (boost::iends_with(fileName, ".rbxm") || boost::iends_with(fileName, ".rbxmx"))
+		{
+			RBX::Instances instances;
+			serializer.loadInstances(stream, instances);
+			for (size_t i = 0; i < instances.size(); ++i)
+				instances[i]->setParent(dataModel->getWorkspace());
+		}
+		else
+		{
+			stream.close();
+			serializer.loadFile(fileName, dataModel);
+		}
+
+		dataModel->processAfterLoad();
+		return true;
+	}
+
+	// Runs whole UI frames until at least `steps` more world steps have been taken and returns
+	// the number of world steps actually taken
+	int stepWorld(RBX::Workspace* workspace, int steps, int threads)
+	{
+		RBX::World* world = workspace->getWorld();
+		const int firstStepId = world->getWorldStepId();
+
+		while (world->getWorldStepId() - firstStepId < steps)
+		{
+			workspace->assemble();
+			workspace->physicsStep(true, RBX::Constants::uiDt(), threads);
+		}
+
+		return world->getWorldStepId() - firstStepId;
+	}
+
+	// FNV-1a over the raw bits of every primitive's position and velocity, in world order
+	class StateHash
+	{
+		boost::uint64_t value;
+
+		void add(const void* data, size_t size)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				value ^= bytes[i];
+				value *= 1099511628211ULL;
+			}
+		}
+
+		void add(const G3D::Vector3& v)
+		{
+			add(&v.x, sizeof(float));
+			add(&v.y, sizeof(float));
+			add(&v.z, sizeof(float));
+		}
+
+	public:
+		StateHash()
+			:value(14695981039346656037ULL)
+		{}
+
+		void add(const RBX::PV& pv)
+		{
+			for (int row = 0; row < 3; ++row)
+				add(pv.position.rotation.row(row));
+			add(pv.position.translation);
+			add(pv.velocity.linear);
+			add(pv.velocity.rotational);
+		}
+
+		boost::uint64_t get() const { return value; }
+	};
+
+	boost::uint64_t hashWorld(const RBX::World* world)
+	{
+		StateHash hash;
+		const G3D::Array<RBX::Primitive*>& primitives = world->getPrimitives();
+		for (int i = 0; i < primitives.size(); ++i)
+			hash.add(primitives[i]->getPV());
+		return hash.get();
+	}
+
+	void report(const RBX::World* world, int steps, double wallSeconds)
+	{
+		std::vector<RBX::Profiling::CodeProfiler*> profilers;
+		world->loadProfilers(profilers);
+
+		const double stepMs = 1000.0 * world->getProfileWorldStep().getTotalWallTime() / steps;
+
+		std::cout << std::fixed << std::setprecision(4);
+		std::cout << "primitives        " << world->getNumPrimitives() << std::endl;
+		std::cout << "contacts          " << world->getNumContacts() << std::endl;
+		std::cout << "world steps       " << steps << std::endl;
+		std::cout << "wall time (s)     " << wallSeconds << std::endl;
+		std::cout << "world step (ms)   " << stepMs << std::endl;
+		std::cout << std::endl;
+		std::cout << std::left << std::setw(20) << "stage" << std::right << std::setw(14) << "ms/step" << std::setw(10) << "share" << std::endl;
+
+		for (size_t i = 0; i < profilers.size(); ++i)
+		{
+			double ms = 1000.0 * profilers[i]->getTotalWallTime() / steps;
+			double share = stepMs > 0 ? 100.0 * ms / stepMs : 0;
+			std::cout << std::left << std::setw(20) << profilers[i]->name << std::right << std::setw(14) << ms << std::setw(9) << share << "%" << std::endl;
+		}
+
+		std::cout << std::endl;
+		std::cout << "state hash        " << std::hex << std::setw(16) << std::setfill('0') << hashWorld(world) << std::dec << std::setfill(' ') << std::endl;
+	}
+
+	void resetProfilers(RBX::World* world)
+	{
+		std::vector<RBX::Profiling::CodeProfiler*> profilers;
+		world->loadProfilers(profilers);
+		for (size_t i = 0; i < profilers.size(); ++i)
+			profilers[i]->resetTotals();
+		world->getProfileWorldStep().resetTotals();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseArguments(argc, argv, options))
+	{
+		std::cerr << usage;
+		return 1;
+	}
+
+	RBX::StandardOut::singleton()->messageOut.connect(&onMessageOut);
+
+	if (!applyFlags(options.flags))
+		return 1;
+
+	RBX::Profiling::init(true);
+	static RBX::FactoryRegistrator registerFactoryObjects;
+
+	RBX::TaskScheduler::singleton().setThreadCount(RBX::TaskScheduler::Threads1);
+	RBX::GameSettings::singleton();
+	RBX::DebugSettings::singleton();
+	RBX::PhysicsSettings::singleton();
+
+	// Registers the network classes so places with Players etc. load; no sockets are opened
+	RBX::Network::initWithServerSecurity();
+
+	RBX::Security::Impersonator impersonate(RBX::Security::WebService);
+
+	shared_ptr<RBX::DataModel> dataModel = RBX::DataModel::createDataModel(false, new RBX::NullVerb(NULL, ""), false);
+	int exitCode = 0;
+	{
+		RBX::DataModel::LegacyLock lock(dataModel, RBX::DataModelJob::Write);
+		RBX::Workspace* workspace = dataModel->getWorkspace();
+
+		if (!loadFile(options.file, dataModel.get()))
+		{
+			std::cerr << "Failed to open " << options.file << std::endl;
+			exitCode = 1;
+		}
+		else
+		{
+			stepWorld(workspace, options.warmup, options.threads);
+			resetProfilers(workspace->getWorld());
+
+			RBX::Time start = RBX::Time::now<RBX::Time::Benchmark>();
+			int steps = stepWorld(workspace, options.steps, options.threads);
+			double wallSeconds = (RBX::Time::now<RBX::Time::Benchmark>() - start).seconds();
+
+			report(workspace->getWorld(), steps, wallSeconds);
+		}
+	}
+
+	RBX::DataModel::closeDataModel(dataModel);
+	return exitCode;
+}
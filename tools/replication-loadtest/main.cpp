@@ -0,0 +1,558 @@
+// Starts a server and a number of headless clients in one process, connected over loopback, drives a
+// replication workload on the server and reports what it cost the server and how long it took the
+// clients to see it. Parts and remote events are timestamped when the server makes them, so the
+// latencies printed include the server's send queue, RakNet and the client's receive job.
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "FastLog.h"
+#include "rbx/rbxTime.h"
+#include "rbx/TaskScheduler.h"
+#include "network/api.h"
+#include "network/Players.h"
+#include "Client.h"
+#include "Replicator.h"
+#include "Server.h"
+#include "util/RunStateOwner.h"
+#include "util/standardout.h"
+#include "v8datamodel/BasicPartInstance.h"
+#include "v8datamodel/DataModel.h"
+#include "v8datamodel/DebugSettings.h"
+#include "v8datamodel/factoryregistration.h"
+#include "v8datamodel/GameSettings.h"
+#include "v8datamodel/PhysicsSettings.h"
+#include "v8datamodel/Remote.h"
+#include "v8datamodel/Workspace.h"
+#include "v8xml/Serializer.h"
+
+namespace
+{
+	const char* usage =
+		"ReplicationLoadTest - a server and N clients over loopback, with a scripted replication workload\n"
+		"\n"
+		"Usage:\n"
+		"  ReplicationLoadTest [options]\n"
+		"\n"
+		"Options:\n"
+		"  --clients N         clients to connect (default 16)\n"
+		"  --seconds N         seconds of workload to measure (default 30)\n"
+		"  --parts N           parts created per second, the oldest are removed past 500 (default 50)\n"
+		"  --events N          RemoteEvent:FireAllClients calls per second (default 50)\n"
+		"  --movers N          unanchored parts kept moving by the server (default 50)\n"
+		"  --place FILE        load a place into the server before the clients join\n"
+		"  --port N            server port (default 53640)\n"
+		"  --flag Name=Value   set a fast flag before starting, may be repeated\n"
+		"  --help              this help message\n";
+
+	const char* partPrefix = "LoadTestPart";
+	const char* eventName = "LoadTestEvent";
+	const int maxLiveParts = 500;
+	const int ticksPerSecond = 30;
+
+	struct Options
+	{
+		int clients;
+		int seconds;
+		int parts;
+		int events;
+		int movers;
+		int port;
+		std::string place;
+		std::vector<std::string> flags;
+
+		Options()
+			:clients(16)
+			,seconds(30)
+			,parts(50)
+			,events(50)
+			,movers(50)
+			,port(53640)
+		{}
+	};
+
+	void onMessageOut(const RBX::StandardOutMessage& message)
+	{
+		if (message.type == RBX::MESSAGE_ERROR || message.type == RBX::MESSAGE_WARNING)
+			std::cerr << message.message << std::endl;
+	}
+
+	bool parseArguments(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (arg == "--help")
+				return false;
+			else if (arg == "--clients" && hasValue)
+				options.clients = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--seconds" && hasValue)
+				options.seconds = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--parts" && hasValue)
+				options.parts = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--events" && hasValue)
+				options.events = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--movers" && hasValue)
+				options.movers = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--place" && hasValue)
+				options.place = argv[++i];
+			else if (arg == "--port" && hasValue)
+				options.port = boost::lexical_cast<int>(argv[++i]);
+			else if (arg == "--flag" && hasValue)
+				options.flags.push_back(argv[++i]);
+			else
+			{
+				std::cerr << "Unknown argument " << arg << std::endl;
+				return false;
+			}
+		}
+
+		return options.clients > 0 && options.seconds > 0 && options.parts >= 0 && options.events >= 0 && options.movers >= 0;
+	}
+
+	bool applyFlags(const std::vector<std::string>& flags)
+	{
+		for (size_t i = 0; i < flags.size(); ++i)
+		{
+			std::string::size_type equals = flags[i].find('=');
+			if (equals == std::string::npos || !FLog::SetValue(flags[i].substr(0, equals), flags[i].substr(equals + 1)))
+			{
+				std::cerr << "Could not set flag " << flags[i] << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	double now()
+	{
+		return RBX::Time::now<RBX::Time::Benchmark>().timestampSeconds();
+	}
+
+	// Latency samples from every client, added from the clients' DataModel threads
+	class LatencyTracker
+	{
+		boost::mutex mutex;
+		std::vector<double> sendTimes;		// by part sequence number
+		std::vector<double> partLatencies;
+		std::vector<double> eventLatencies;
+		bool measuring;
+
+		static void print(const char* name, std::vector<double>& samples, size_t expected)
+		{
+			std::cout << std::left << std::setw(20) << name << std::right << std::setw(10) << samples.size() << std::setw(10) << expected;
+
+			if (!samples.empty())
+			{
+				std::sort(samples.begin(), samples.end());
+
+				double total = 0;
+				for (size_t i = 0; i < samples.size(); ++i)
+					total += samples[i];
+
+				std::cout
+					<< std::setw(10) << 1000.0 * total / samples.size()
+					<< std::setw(10) << 1000.0 * samples[samples.size() / 2]
+					<< std::setw(10) << 1000.0 * samples[std::min(samples.size() - 1, samples.size() * 95 / 100)]
+					<< std::setw(10) << 1000.0 * samples.back();
+			}
+			std::cout << std::endl;
+		}
+
+	public:
+		LatencyTracker()
+			:measuring(false)
+		{}
+
+		void setMeasuring(bool value)
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			measuring = value;
+		}
+
+		int onPartSent()
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			sendTimes.push_back(now());
+			return (int)sendTimes.size() - 1;
+		}
+
+		void onPartReceived(int sequence)
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			if (measuring && sequence >= 0 && sequence < (int)sendTimes.size())
+				partLatencies.push_back(now() - sendTimes[sequence]);
+		}
+
+		void onEventReceived(double sendTime)
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			if (measuring)
+				eventLatencies.push_back(now() - sendTime);
+		}
+
+		void report(size_t expectedParts, size_t expectedEvents)
+		{
+			boost::mutex::scoped_lock lock(mutex);
+
+			std::cout << std::left << std::setw(20) << "latency (ms)" << std::right
+				<< std::setw(10) << "received" << std::setw(10) << "expected"
+				<< std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "max" << std::endl;
+			print("parts", partLatencies, expectedParts);
+			print("remote events", eventLatencies, expectedEvents);
+		}
+	};
+
+	LatencyTracker latencyTracker;
+
+	void onClientEvent(shared_ptr<const RBX::Reflection::Tuple> arguments)
+	{
+		if (arguments && !arguments->values.empty() && arguments->at(0).isType<double>())
+			latencyTracker.onEventReceived(arguments->at(0).cast<double>());
+	}
+
+	void onClientWorkspaceChildAdded(shared_ptr<RBX::Instance> child)
+	{
+		if (boost::starts_with(child->getName(), partPrefix))
+		{
+			int sequence = boost::lexical_cast<int>(child->getName().substr(strlen(partPrefix)));
+			latencyTracker.onPartReceived(sequence);
+		}
+		else if (RBX::RemoteEvent* remoteEvent = RBX::Instance::fastDynamicCast<RBX::RemoteEvent>(child.get()))
+		{
+			remoteEvent->getOrCreateOnClientEvent()->connect(&onClientEvent);
+		}
+	}
+
+	shared_ptr<RBX::DataModel> createDataModel()
+	{
+		shared_ptr<RBX::DataModel> dataModel = RBX::DataModel::createDataModel(true, new RBX::NullVerb(NULL, ""), false);
+
+		RBX::DataModel::LegacyLock lock(dataModel, RBX::DataModelJob::Write);
+		RBX::ServiceProvider::create<RBX::Network::Players>(dataModel.get())->setCharacterAutoSpawnProperty(false);
+		RBX::ServiceProvider::create<RBX::RunService>(dataModel.get())->run();
+
+		return dataModel;
+	}
+
+	bool loadPlace(const std::string& fileName, RBX::DataModel* dataModel)
+	{
+		std::ifstream stream(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+		if (!stream)
+			return false;
+		stream.close();
+
+		RBX::Security::Impersonator impersonate(RBX::Security::COM);
+		Serializer serializer;
+		serializer.loadFile(fileName, dataModel);
+
+		dataModel->processAfterLoad();
+		return true;
+	}
+
+	// The workload, stepped from the main thread with the server DataModel locked
+	class Workload
+	{
+		const Options& options;
+		RBX::DataModel* dataModel;
+		shared_ptr<RBX::RemoteEvent> remoteEvent;
+		std::deque<shared_ptr<RBX::PartInstance> > liveParts;
+		std::vector<shared_ptr<RBX::PartInstance> > movers;
+		double partsDue;
+		double eventsDue;
+		int tick;
+
+	public:
+		size_t partsSent;
+		size_t eventsSent;
+
+		Workload(const Options& options, RBX::DataModel* dataModel)
+			:options(options)
+			,dataModel(dataModel)
+			,partsDue(0)
+			,eventsDue(0)
+			,tick(0)
+			,partsSent(0)
+			,eventsSent(0)
+		{
+			RBX::Workspace* workspace = dataModel->getWorkspace();
+
+			shared_ptr<RBX::PartInstance> baseplate = RBX::Creatable<RBX::Instance>::create<RBX::BasicPartInstance>();
+			baseplate->setName("LoadTestBaseplate");
+			baseplate->setAnchored(true);
+			baseplate->setPartSizeXml(RBX::Vector3(1024, 4, 1024));
+			baseplate->setCoordinateFrame(RBX::CoordinateFrame(RBX::Vector3(0, -2, 0)));
+			baseplate->setParent(workspace);
+
+			remoteEvent = RBX::Creatable<RBX::Instance>::create<RBX::RemoteEvent>();
+			remoteEvent->setName(eventName);
+			remoteEvent->setParent(workspace);
+
+			for (int i = 0; i < options.movers; ++i)
+			{
+				shared_ptr<RBX::PartInstance> mover = RBX::Creatable<RBX::Instance>::create<RBX::BasicPartInstance>();
+				mover->setName("LoadTestMover");
+				mover->setCoordinateFrame(RBX::CoordinateFrame(RBX::Vector3((float)(i % 20) * 16 - 160, 4, (float)(i / 20) * 16 - 160)));
+				mover->setParent(workspace);
+				movers.push_back(mover);
+			}
+		}
+
+		void step()
+		{
+			++tick;
+
+			// Parts: created at random spots, the oldest ones removed
+			partsDue += (double)options.parts / ticksPerSecond;
+			for (; partsDue >= 1; partsDue -= 1)
+			{
+				int sequence = latencyTracker.onPartSent();
+
+				shared_ptr<RBX::PartInstance> part = RBX::Creatable<RBX::Instance>::create<RBX::BasicPartInstance>();
+				part->setName(partPrefix + boost::lexical_cast<std::string>(sequence));
+				part->setAnchored(true);
+				part->setCoordinateFrame(RBX::CoordinateFrame(RBX::Vector3((float)(sequence % 64) * 8 - 256, 20, (float)(sequence / 64 % 64) * 8 - 256)));
+				part->setParent(dataModel->getWorkspace());
+				liveParts.push_back(part);
+				++partsSent;
+
+				if ((int)liveParts.size() > maxLiveParts)
+				{
+					liveParts.front()->setParent(NULL);
+					liveParts.pop_front();
+				}
+			}
+
+			// Remote events: carry the time they were fired
+			eventsDue += (double)options.events / ticksPerSecond;
+			for (; eventsDue >= 1; eventsDue -= 1)
+			{
+				shared_ptr<RBX::Reflection::Tuple> arguments(new RBX::Reflection::Tuple(1));
+				arguments->at(0) = now();
+				remoteEvent->fireAllClients(arguments);
+				++eventsSent;
+			}
+
+			// Movers: pushed around in circles, standing in for characters
+			const float angle = (float)tick / ticksPerSecond;
+			for (size_t i = 0; i < movers.size(); ++i)
+			{
+				const float phase = angle + (float)i;
+				movers[i]->setLinearVelocity(RBX::Vector3(cosf(phase), 0, sinf(phase)) * 16.0f);
+			}
+		}
+	};
+
+	// Totals over the server's replicators
+	struct ServerSample
+	{
+		double bytesSent;
+		double dataItemsPerSecond;
+		double sendCpu;
+		int replicators;
+
+		ServerSample()
+			:bytesSent(0)
+			,dataItemsPerSecond(0)
+			,sendCpu(0)
+			,replicators(0)
+		{}
+	};
+
+	ServerSample sampleServer(RBX::Network::Server* server)
+	{
+		ServerSample sample;
+		for (size_t i = 0; i < server->numChildren(); ++i)
+		{
+			if (const RBX::Network::Replicator* replicator = RBX::Instance::fastDynamicCast<RBX::Network::Replicator>(server->getChild(i)))
+			{
+				sample.bytesSent += replicator->getMetricValue("Total Bytes Sent");
+				sample.dataItemsPerSecond += replicator->getMetricValue("Data Items Sent");
+				sample.sendCpu += replicator->getMetricValue("Network Send CPU");
+				++sample.replicators;
+			}
+		}
+		return sample;
+	}
+
+	void waitForClients(const shared_ptr<RBX::DataModel>& serverDataModel, RBX::Network::Server* server, int clients)
+	{
+		const double deadline = now() + 30;
+		while (now() < deadline)
+		{
+			{
+				RBX::DataModel::LegacyLock lock(serverDataModel, RBX::DataModelJob::Write);
+				if (server->getClientCount() >= clients)
+					return;
+			}
+			boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseArguments(argc, argv, options))
+	{
+		std::cerr << usage;
+		return 1;
+	}
+
+	RBX::StandardOut::singleton()->messageOut.connect(&onMessageOut);
+
+	if (!applyFlags(options.flags))
+		return 1;
+
+	static RBX::FactoryRegistrator registerFactoryObjects;
+
+	RBX::TaskScheduler::singleton().setThreadCount(RBX::TaskScheduler::PerCore1);
+	RBX::GameSettings::singleton();
+	RBX::DebugSettings::singleton();
+	RBX::PhysicsSettings::singleton();
+
+	// Both ends live in this process, so they share the player security key and neither checks tickets
+	RBX::Network::initWithPlayerSecurity();
+
+	RBX::Security::Impersonator impersonate(RBX::Security::WebService);
+
+	// Server
+	shared_ptr<RBX::DataModel> serverDataModel = createDataModel();
+	RBX::Network::Server* server = NULL;
+	{
+		RBX::DataModel::LegacyLock lock(serverDataModel, RBX::DataModelJob::Write);
+
+		if (!options.place.empty() && !loadPlace(options.place, serverDataModel.get()))
+		{
+			std::cerr << "Failed to open " << options.place << std::endl;
+			RBX::DataModel::closeDataModel(serverDataModel);
+			return 1;
+		}
+
+		server = RBX::ServiceProvider::create<RBX::Network::Server>(serverDataModel.get());
+		server->start(options.port, 20);
+	}
+
+	// Clients
+	std::vector<shared_ptr<RBX::DataModel> > clientDataModels;
+	for (int i = 0; i < options.clients; ++i)
+	{
+		shared_ptr<RBX::DataModel> clientDataModel = createDataModel();
+		{
+			RBX::DataModel::LegacyLock lock(clientDataModel, RBX::DataModelJob::Write);
+
+			clientDataModel->getWorkspace()->getOrCreateChildAddedSignal()->connect(&onClientWorkspaceChildAdded);
+
+			RBX::Network::Client* client = RBX::ServiceProvider::create<RBX::Network::Client>(clientDataModel.get());
+			client->playerConnect(i + 1, "127.0.0.1", options.port, 0, -1);
+		}
+		clientDataModels.push_back(clientDataModel);
+	}
+
+	waitForClients(serverDataModel, server, options.clients);
+
+	ServerSample first;
+	boost::scoped_ptr<Workload> workload;
+	{
+		RBX::DataModel::LegacyLock lock(serverDataModel, RBX::DataModelJob::Write);
+		std::cout << "clients connected " << server->getClientCount() << " of " << options.clients << std::endl;
+
+		workload.reset(new Workload(options, serverDataModel.get()));
+		first = sampleServer(server);
+	}
+
+	// Give the workload's own setup time to reach everyone before measuring
+	boost::this_thread::sleep(boost::posix_time::seconds(2));
+	latencyTracker.setMeasuring(true);
+
+	const double start = now();
+	double nextTick = start;
+	double sendCpuTotal = 0;
+	double dataItemsTotal = 0;
+	int samples = 0;
+	double nextSample = start + 1;
+
+	ServerSample last;
+	while (now() - start < options.seconds)
+	{
+		{
+			RBX::DataModel::LegacyLock lock(serverDataModel, RBX::DataModelJob::Write);
+			workload->step();
+
+			if (now() >= nextSample)
+			{
+				last = sampleServer(server);
+				sendCpuTotal += last.sendCpu;
+				dataItemsTotal += last.dataItemsPerSecond;
+				++samples;
+				nextSample += 1;
+			}
+		}
+
+		nextTick += 1.0 / ticksPerSecond;
+		double wait = nextTick - now();
+		if (wait > 0)
+			boost::this_thread::sleep(boost::posix_time::microseconds((boost::int64_t)(wait * 1e6)));
+	}
+
+	const double elapsed = now() - start;
+	size_t partsSent;
+	size_t eventsSent;
+	{
+		RBX::DataModel::LegacyLock lock(serverDataModel, RBX::DataModelJob::Write);
+		last = sampleServer(server);
+		partsSent = workload->partsSent;
+		eventsSent = workload->eventsSent;
+	}
+
+	// Let what is in flight arrive before reporting
+	boost::this_thread::sleep(boost::posix_time::seconds(2));
+	latencyTracker.setMeasuring(false);
+
+	const int replicators = std::max(1, last.replicators);
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "clients           " << last.replicators << std::endl;
+	std::cout << "seconds           " << elapsed << std::endl;
+	std::cout << "parts created     " << partsSent << std::endl;
+	std::cout << "events fired      " << eventsSent << std::endl;
+	std::cout << "movers            " << options.movers << std::endl;
+	std::cout << std::endl;
+	std::cout << "server KB/s       " << (last.bytesSent - first.bytesSent) / 1024.0 / elapsed << std::endl;
+	std::cout << "  per client      " << (last.bytesSent - first.bytesSent) / 1024.0 / elapsed / replicators << std::endl;
+	std::cout << "data items/s      " << (samples ? dataItemsTotal / samples : 0) << std::endl;
+	std::cout << "send job CPU %    " << (samples ? sendCpuTotal / samples : 0) << " total, " << (samples ? sendCpuTotal / samples / replicators : 0) << " per client" << std::endl;
+	std::cout << std::endl;
+
+	latencyTracker.report(partsSent * last.replicators, eventsSent * last.replicators);
+
+	for (size_t i = 0; i < clientDataModels.size(); ++i)
+	{
+		{
+			RBX::DataModel::LegacyLock lock(clientDataModels[i], RBX::DataModelJob::Write);
+			if (RBX::Network::Client* client = RBX::ServiceProvider::find<RBX::Network::Client>(clientDataModels[i].get()))
+				client->disconnect();
+		}
+		RBX::DataModel::closeDataModel(clientDataModels[i]);
+	}
+
+	{
+		RBX::DataModel::LegacyLock lock(serverDataModel, RBX::DataModelJob::Write);
+		workload.reset();
+		server->stop();
+	}
+	RBX::DataModel::closeDataModel(serverDataModel);
+
+	return 0;
+}